@@ -2,6 +2,7 @@
 #define CNNPLANNER_ANALYSIS_ANALYSIS_REPORT_H_
 
 #include <memory>
+#include <vector>
 
 #include "general/data_type.h"
 #include "loop/variable_set.h"
@@ -16,6 +17,7 @@
 #include "arch/architecture.h"
 
 using std::unique_ptr;
+using std::vector;
 
 using loop::VariableSet;
 using loop::Structure;
@@ -56,6 +58,19 @@ class AnalysisReport {
     void Analyze( const VariableSet& varset, 
                   long int latency, 
                   const Architecture& arch);
+    //! @brief                Store traffic between memory levels.
+    //! @details              Call it between PreAnalyze and Analyze.
+    //!                       DRAM traffic to the outermost level replaces
+    //!                       the off-chip access sizes, and traffic out of
+    //!                       each level is charged with its access energy.
+    //! @param varset         Set of CNN parameters with memory level tiles
+    //! @param level_strts    Loop structures which walk each level tile
+    //! @param off_strt       Off-chip loop structure of PE-local tiles
+    //! @param arch           Architecture configurations
+    void AnalyzeMemoryLevels( const VariableSet& varset,
+                              const vector<Structure>& level_strts,
+                              const Structure& off_strt,
+                              const Architecture& arch);
 
     int GetEncodedPsumVariables(void) const;
 
@@ -98,6 +113,9 @@ class AnalysisReport {
     //! @brief    Return PE utilization.
     //! @return   PE utilization
     double GetPeUtilization(void) const;
+    //! @brief    Return PE utilization of each PE array.
+    //! @return   PE utilization of each PE array. Empty if there is one PE array.
+    const vector<double>& GetArrayPeUtilization(void) const;
 
     //! @brief    Return spatial reuse for input data.
     //! @details  Spatial reuse means how many times one data is consumed by processing elements at the same time.
@@ -242,6 +260,15 @@ class AnalysisReport {
     //!           The unit is nJ
     //! @return   Power consumption
     double GetPower(void) const;
+    //! @brief    Return access size read out of each memory level.
+    //! @details  Index l is the traffic from level l to the level below it
+    //!           or to PE-local memory. The unit is Byte.
+    //! @return   Access sizes of memory levels
+    const vector<long int>& GetLevelAccessSizes(void) const;
+    //! @brief    Return memory level access energy.
+    //! @details  It is included in total energy. The unit is nJ
+    //! @return   Memory level access energy
+    double GetLevelAccessEnergy(void) const;
 
     //! @brief  Print ComputeAnalyzer results.
     ostream& PrintComputeAnalysisReport(ostream& out) const;
@@ -255,6 +282,8 @@ class AnalysisReport {
     ostream& PrintEnergyAnalysisReport(ostream& out) const;
     //! @brief  Print RooflineAnalyzer results.
     ostream& PrintRooflineAnalysisReport(ostream& out) const;
+    //! @brief  Print memory level traffic.
+    ostream& PrintMemoryLevelAnalysisReport(ostream& out) const;
     //! @brief  Print whole analysis report.
     ostream& PrintAnalysisReport(ostream& out) const;
 
@@ -278,6 +307,7 @@ class AnalysisReport {
     long int estimated_exe_cycles_= NON_VALID;
     int active_macs_              = NON_VALID;
     double pe_util_               = NON_VALID;
+    vector<double> array_pe_util_;
 
     int s_input_reuse_  = NON_VALID;  // spatial input reuse
     int s_weight_reuse_ = NON_VALID;  // spatial weight reuse
@@ -314,6 +344,9 @@ class AnalysisReport {
     double total_energy_        = NON_VALID;
     double power_               = NON_VALID;
 
+    vector<long int> level_acs_sizes_;  // traffic out of each memory level
+    double level_acs_energy_    = 0;
+
     long int DecideInputBufferSize(const VariableSet& varset) const;
     long int DecideWeightBufferSize(const VariableSet& varset) const;
 
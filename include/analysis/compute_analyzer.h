@@ -45,6 +45,14 @@ class ComputeAnalyzer
     //! @param varset           Set of CNN parameters.
     //! @return                 The number of intra loop iterations
     long int AnalyzeOnLoopIterations(const VariableSet& varset) const;
+    //! @brief                  Return the number of on-chip loop iterations of a PE array.
+    //! @param array_vars       Share of the on-chip tile of the PE array.
+    //! @param array_parl_vars  Unrolling of the PE array.
+    //! @return                 The number of intra loop iterations. 0 if the
+    //!                         PE array is idle.
+    long int AnalyzeArrayOnLoopIterations(const Variables& array_vars,
+                                          const Variables& array_parl_vars)
+      const;
     //! @brief                  Return the estimated execution cycles.
     //! @details                Estimated execution cycles is based on the total number of iterations.
     //! @param off_loop_itr     Off-chip loop iterations.
@@ -13,6 +13,21 @@ using parameter::CompilerParameter;
 using parameter::ProfilerParameter;
 
 namespace arch {
+//! @brief  The maximum number of on-chip memory levels above PE-local memory.
+const int kMaxMemLevelCnt = 4;
+////////////////////////////////////////////////////////////////////////////////
+//! @brief    On-chip memory level between off-chip memory and PE-local memory.
+//! @details  Input, weight and output have their own part like PE-local
+//!           memory. Bandwidth is how fast the level feeds the level below.
+////////////////////////////////////////////////////////////////////////////////
+struct MemoryLevel
+{
+  long int input_mem_size;    // Bytes
+  long int weight_mem_size;   // Bytes
+  long int output_mem_size;   // Bytes
+  double bandwidth;           // GB/sec
+  double energy_32;           // nJ per 32-bit access
+};
 ////////////////////////////////////////////////////////////////////////////////
 //! @brief    Object implemented from hardware config file
 //! @details  Get the hardware config from parameter and make object including
@@ -20,7 +35,7 @@ namespace arch {
 //! @author   Minsu Kim
 //! @date     2019-10-04
 ////////////////////////////////////////////////////////////////////////////////
-enum DataDimension { None=0, KW, KH, IC, OW, OH, OC, IW, IH };
+enum DataDimension { None=0, KW, KH, IC, OW, OH, OC, IW, IH, N };
 class Architecture
 {
   public:
@@ -67,6 +82,13 @@ class Architecture
     //! @brief              Set calculation dimension on 2D PE.
     //! @param mac_cycles   Calculation dimension expressed by DataDimension.
     void SetPeStructure(vector<vector<DataDimension>> pe_structure);
+    //! @brief              Set on-chip memory levels above PE-local memory.
+    //! @param mem_levels   Memory levels, outermost first.
+    void SetMemLevels(const vector<MemoryLevel>& mem_levels);
+    //! @brief              Set on-chip memory levels from parameter rows.
+    //! @param mem_levels   [input size, weight size, output size, bandwidth,
+    //!                     energy] of each level, outermost first.
+    void SetMemLevels(const vector<vector<double>>& mem_levels);
     //! @brief              Get MAC cycles.
     //! @return             MAC cycles.
     int GetMacCycles(void) const;
@@ -97,9 +119,18 @@ class Architecture
     //! @brief              Get PE physical dimension.
     //! @return             PE physical dimension.
     vector<vector<int>> GetPeDim(void) const;
+    //! @brief              Get prime factors of PE physical dimension.
+    //! @details            Factorized once by SetPeDim for the searches.
+    //! @return             Prime factors of the row and column length of
+    //!                     each PE array, in ascending order.
+    const vector<vector<vector<int>>>& GetPeFactors(void) const;
     //! @brief              Get calculation dimension of PE.
     //! @return             Calculation dimension of PE.
     vector<vector<DataDimension>> GetPeStructure(void) const; 
+    //! @brief              Get on-chip memory levels above PE-local memory.
+    //! @details            Empty if PE-local memory is the only level.
+    //! @return             Memory levels, outermost first.
+    const vector<MemoryLevel>& GetMemLevels(void) const;
   private:
     int mac_cycles_ = NON_VALID;
     double bandwidth_ = NON_VALID;
@@ -111,7 +142,9 @@ class Architecture
     long int weight_mem_size_ = NON_VALID;
     long int output_mem_size_ = NON_VALID;
     vector<vector<int>> pe_dim_;
+    vector<vector<vector<int>>> pe_factors_;
     vector<vector<DataDimension>> pe_structure_;
+    vector<MemoryLevel> mem_levels_;
 };
 } // namespcae arch
 #endif
\ No newline at end of file
@@ -21,9 +21,12 @@ namespace gaia {
 class Convolution : public Operator
 {
   public:
+    //! @param groups   Channel groups in the operands. Input channels of each
+    //!                 group only reach output channels of the same group.
     Convolution(Data4d in_operand, Data4d wt_operand, Data4d ot_operand, 
                 int stride,
-                int left_pad, int right_pad, int up_pad, int down_pad) 
+                int left_pad, int right_pad, int up_pad, int down_pad,
+                int groups = 1) 
       : in_operand_(in_operand), 
         wt_operand_(wt_operand), 
         ot_operand_(ot_operand),
@@ -31,7 +34,8 @@ class Convolution : public Operator
         left_pad_(left_pad),
         right_pad_(right_pad),
         up_pad_(up_pad),
-        down_pad_(down_pad) {}
+        down_pad_(down_pad),
+        groups_(groups) {}
 
     Data4d GetInputOperand(void)  const { return in_operand_; }
     Data4d GetWeightOperand(void) const { return wt_operand_; }
@@ -43,9 +47,11 @@ class Convolution : public Operator
     int GetUpPadding(void)    const { return up_pad_;   }
     int GetDownPadding(void)  const { return down_pad_; }
 
+    int GetGroups(void) const { return groups_; }
+
     bool Validate(void) const
     { 
-      return stride_ > 0;
+      return stride_ > 0 && groups_ > 0;
     }
 
   private:
@@ -59,6 +65,8 @@ class Convolution : public Operator
     int right_pad_=0;
     int up_pad_=0;
     int down_pad_=0;
+
+    int groups_=1;
 };
 ostream& operator<<(ostream& out, const codegen::gaia::Convolution& conv);
 } // namespace gaia
@@ -17,6 +17,7 @@ using std::pair;
 using std::string;
 
 using loop::CnnLoop;
+using loop::VariableSet;
 using arch::Architecture;
 using codegen::gaia::Variable;
 using codegen::gaia::Operator;
@@ -49,10 +50,15 @@ class GaiaIr
     int num_ic_tile_=0;
     int num_oh_tile_=0;
     int num_ow_tile_=0;
+    int num_n_tile_=0;
 
     void AddSymbols(const CnnLoop& loop, const Architecture& arch,
                     const int layer_num);
     void AddTexts(const CnnLoop& loop);
+    void AddBatchTexts(const CnnLoop& loop, const int n);
+    // First group and the number of groups of an output channel tile.
+    int GetGroupBegin(const VariableSet& varset, const int oc_tile) const;
+    int GetGroupSpan(const VariableSet& varset, const int oc_tile) const;
 };
 ostream& operator<<(ostream& out, const codegen::gaia::GaiaIr& gaia_ir);
 } // namespace gaia
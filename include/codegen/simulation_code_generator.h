@@ -28,10 +28,16 @@ enum InstructionSlot {
   UNDER_OUTER_MOST,
   OVER_OUTER_MOST
 };
+enum DataLayout { NCHW_LAYOUT=0, BLOCKED_LAYOUT };
+
+#define S_NCHW_LAYOUT     "nchw"
+#define S_BLOCKED_LAYOUT  "blocked"
 
 ////////////////////////////////////////////////////////////////////////////////
 //! @brief      Simulation source code generator.
 //! @details    Generate C++ code to run one layer of CNN.
+//!             Every tensor is one contiguous aligned buffer indexed by
+//!             computed strides, in NCHW or channel blocked layout.
 //! @author     Minsu Kim
 //! @date       2019-07-03
 ////////////////////////////////////////////////////////////////////////////////
@@ -54,29 +60,91 @@ class SimulationCodeGenerator : public codegen::CodeGenerator
     }
 
     void GenCode( const CnnLoop& loop, const Architecture& arch);
+    //! @brief                          Set tensor layout of generated code.
+    //! @details                        Blocked layout keeps Pic input
+    //!                                 channels and Poc output channels
+    //!                                 innermost, like NCHWc.
+    //! @param layout                   Layout name (nchw, blocked).
+    void SetDataLayout(const char* layout);
+    //! @brief                          Set timing-only code generation.
+    //! @details                        Timing-only code has no test data
+    //!                                 and no MAC computation. Execution
+    //!                                 cycles of a tile are computed in
+    //!                                 closed form.
+    //! @param timing_only              Timing-only switch.
+    void SetTimingOnly(const bool timing_only) { timing_only_ = timing_only; }
+    //! @brief                          Set parallel functional computation.
+    //! @details                        MAC computation runs in its own loop
+    //!                                 nest, parallelized over output
+    //!                                 channel tiles with OpenMP. The timing
+    //!                                 chain stays sequential with closed
+    //!                                 form tile execution. Needs -fopenmp.
+    //! @param parallel_compute         Parallel computation switch.
+    void SetParallelCompute(const bool parallel_compute)
+      { parallel_compute_ = parallel_compute; }
+    //! @brief                          Set runtime argument code generation.
+    //! @details                        Tile constants and output paths are
+    //!                                 read from the command line, so one
+    //!                                 binary serves every layer with the
+    //!                                 same loop structure and load slots.
+    //! @param args_file_path           Path of the arguments of the binary.
+    //!                                 Empty to keep constants in the code.
+    void SetArgsFile(const char* args_file_path)
+      { strncpy(args_file_path_, args_file_path, STR_LEN); }
+
+    // Slots of off-chip accesses, shared with TimingSimulator.
+    static vector<loop::Type> GetLoopSequence(const Structure& strt);
+    static int GetInputLoadGroups(const VariableSet& varset,
+                                  const Structure& off_strt);
+    static InstructionSlot GetInputLoadSlot(const Structure& strt);
+    static InstructionSlot GetWeightLoadSlot(const Structure& strt);
+    static InstructionSlot GetOutputStoreSlot(const Structure& strt);
+    static bool IsOutputStoreSlotUnderOcAndOm(vector<loop::Type> loop_seq);
+    static bool IsOutputStoreSlotUnderOc(vector<loop::Type> loop_seq);
+    static bool IsOutputStoreSlotUnderOm(vector<loop::Type> loop_seq);
+    static bool IsOutputStoreSlotOverOcAndOm(vector<loop::Type> loop_seq);
+    // Split of a tile across PE arrays, shared with TimingSimulator.
+    static bool IsArraySplitOc(const VariableSet& varset);
 
   private:
     char code_path_[STR_LEN];
     char latency_file_path_[STR_LEN];
     char ts_file_path_[STR_LEN];
+    char args_file_path_[STR_LEN] = "";
+    DataLayout layout_ = DataLayout::NCHW_LAYOUT;
+    bool timing_only_ = false;
+    bool parallel_compute_ = false;
+    // PE arrays which share each tile. Arrays take consecutive output
+    // channels, or output rows if split_oc_ is false.
+    size_t pe_array_cnt_ = 1;
+    bool split_oc_ = true;
+    // Runtime argument values and their initializations in generated code.
+    vector<string> arg_values_;
+    vector<string> arg_inits_;
 
     void GenPreProcess( ofstream& code, const Architecture& arch);
     //void GenFunctionPrototype(ofstream& sim_file);
     void GenFunctionDefine(ofstream& code, const Structure& off_strt);
     void GenGlobalVariables(ofstream& code, const VariableSet& varset, 
-                            int mac_cycles);
+                            int load_groups, int mac_cycles);
     void GenVariableDeclare(ofstream& code, const VariableSet& varset);
+    void GenArrayVariables(ofstream& code, const VariableSet& varset);
+    bool IsRuntimeArgs(void) const { return args_file_path_[0] != '\0'; }
+    bool IsArraySplit(void) const { return pe_array_cnt_ > 1; }
+    void GenArgument(ofstream& code, const char* name, long int value);
+    void GenDerived(ofstream& code, const char* type, const char* name,
+                    const char* expr);
+    void GenArgumentsInit(ofstream& code);
+    void WriteArgsFile(void);
+    void GenDataLayout(ofstream& code);
     void GenSampleDataDeclare(ofstream& code);
     void GenTsStreamOpen(ofstream& code);
     void GenSampleDataInitialization(ofstream& code);
     void GenCalculateBaseline(ofstream& code);
+    void GenParallelCompute(ofstream& code, const Structure& off_strt,
+                            const Structure& on_strt);
     void GenLocalVariables(ofstream& code, const Structure& off_strt);
 
-    vector<loop::Type> GetLoopSequence(const Structure& strt);
-    InstructionSlot GetInputLoadSlot(const Structure& strt);
-    InstructionSlot GetWeightLoadSlot(const Structure& strt);
-    InstructionSlot GetOutputStoreSlot(const Structure& strt);
-
     void GenInterLoop(ofstream& code, const Structure& off_strt);
     void GenInstructionSlot(ofstream& code, string indent, 
                             const Structure& off_strt, InstructionSlot slot);
@@ -87,13 +155,9 @@ class SimulationCodeGenerator : public codegen::CodeGenerator
         const Structure& off_strt);
     void GenStoreFlagSet(ofstream& code, string indent);
 
-    bool IsOutputStoreSlotUnderOcAndOm(vector<loop::Type> loop_seq);
-    bool IsOutputStoreSlotUnderOc(vector<loop::Type> loop_seq);
-    bool IsOutputStoreSlotUnderOm(vector<loop::Type> loop_seq);
-    bool IsOutputStoreSlotOverOcAndOm(vector<loop::Type> loop_seq);
-
     void GenInterOcLoop(ofstream& code, string indent);
     void GenInterIcLoop(ofstream& code, string indent);
+    void GenInterNLoop(ofstream& code, string indent);
     void GenInterOhLoop(ofstream& code, string indent);
     void GenInterOwLoop(ofstream& code, string indent);
     void GenInterKhLoop(ofstream& code, string indent);
@@ -102,6 +166,7 @@ class SimulationCodeGenerator : public codegen::CodeGenerator
     void GenIntraLoop(ofstream& code, const Structure& on_strt);
     void GenIntraOcLoop(ofstream& code, string indent);
     void GenIntraIcLoop(ofstream& code, string indent);
+    void GenIntraNLoop(ofstream& code, string indent);
     void GenIntraOhLoop(ofstream& code, string indent);
     void GenIntraOwLoop(ofstream& code, string indent);
     void GenIntraKhLoop(ofstream& code, string indent);
@@ -109,6 +174,7 @@ class SimulationCodeGenerator : public codegen::CodeGenerator
     void GenIntraLoopClose(ofstream& code);
 
     void GenUnrollLoop(ofstream& code);
+    void GenTileExecution(ofstream& code);
 
     void GenInterLoopClose(ofstream& code, const Structure& off_strt);
     void GenOutputStoreSlot(ofstream& code, string indent, 
@@ -124,6 +190,7 @@ class SimulationCodeGenerator : public codegen::CodeGenerator
     void GenWeightLoadFunctionDefine(ofstream& code, const Structure& off_strt);
     void GenOutputStoreFunctionDefine(ofstream& code,const Structure& off_strt);
     void GenExecuteFunctionDefine(ofstream& code);
+    void GenTileCyclesFunctionDefine(ofstream& code);
     void GenDelete(ofstream& code);
 };
 } // namespace simulation
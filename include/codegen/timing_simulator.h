@@ -0,0 +1,84 @@
+#ifndef CNNPLANNER_SIMULATION_TIMING_SIMULATOR_H_
+#define CNNPLANNER_SIMULATION_TIMING_SIMULATOR_H_
+
+#include <ostream>
+#include <vector>
+
+#include "codegen/simulation_code_generator.h"
+#include "loop/tiling_candidate.h"
+
+using std::ostream;
+using std::vector;
+
+using loop::kDimensionCnt;
+
+namespace codegen {
+namespace simulation {
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Event-driven simulation of a layer schedule in-process.
+//! @details    Walks the off-chip loop nest of the schedule and issues the
+//!             same input load, weight load, execution and output store
+//!             events as the code of SimulationCodeGenerator, with the same
+//!             timestamp semantics. The latency and the timestamp trace
+//!             equal those of the generated simulator without compiling it.
+////////////////////////////////////////////////////////////////////////////////
+class TimingSimulator
+{
+  public:
+    //! @brief              Constructor
+    //! @param loop         Scheduled loop of the layer.
+    //! @param arch         Hardware configurations.
+    TimingSimulator(const CnnLoop& loop, const Architecture& arch);
+    //! @brief              Simulate every tile of the layer.
+    //! @param ts_stream    Timestamp JSON stream. nullptr to skip the trace.
+    //! @return             Latency (ns).
+    long int Run(ostream* ts_stream);
+
+  private:
+    //! @brief  One loop of the off-chip loop nest, outermost first.
+    struct Level
+    {
+      DataDimension dim;
+      int slot;     // Instruction slot at the top of the body. -1 if none.
+    };
+
+    const Structure& off_strt_;
+    vector<Level> levels_;
+    InstructionSlot input_slot_, weight_slot_, store_slot_;
+    bool is_store_oc_, is_store_om_;
+
+    // Indexed by DataDimension. Input tiles include the padding.
+    int dim_[kDimensionCnt];
+    int tile_[kDimensionCnt];
+    int parl_[kDimensionCnt];
+    // Share along the split dimension and unrolling of each PE array. Empty
+    // if there is one PE array.
+    DataDimension split_dim_;
+    vector<int> array_share_;
+    vector<vector<int>> array_parl_;
+    int idx_[kDimensionCnt];
+    int last_idx_[kDimensionCnt];
+    int stride_;
+    int load_groups_;
+    int mac_cycles_;
+    double bandwidth_, frequency_;
+
+    long int memory_ts_, prev_compute_ts_, compute_ts_;
+    bool store_flag_, is_not_first_iter_;
+    ostream* ts_stream_;
+
+    void RunLevel(size_t l);
+    void RunInstructionSlot(int slot);
+    void RunOutputStoreSlot(void);
+    void InputLoad(void);
+    void WeightLoad(void);
+    void OutputStore(long int prev_compute_ts);
+    void Execute(void);
+    long int GetArraysExeCycles(void) const;
+    int GetTileLen(DataDimension d, const int* idx) const;
+    void WriteMemoryEvent(const char* data_type, long int start, long int end,
+                          long int amount);
+};
+} // namespace simulation
+} // namespace codegen
+#endif
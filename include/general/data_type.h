@@ -62,4 +62,30 @@ class Matrix : public std::vector<std::vector<int>>
     }
 };
 
+class RealMatrix : public std::vector<std::vector<double>>
+{
+  public:
+    RealMatrix(char* vec_str, size_t len)
+    {
+      char* ptr = vec_str;
+      //--- Invalid format check
+      assert(*ptr == '[' && *(ptr+1) == '[');
+      assert(*(ptr+len-1) == ']' && *(ptr+len-2) == ']');
+      //---
+      std::vector<double> vec;
+      std::string num = "";
+      while (++ptr < vec_str+len-1) {
+        if (*ptr == '[') {
+          vec.clear();
+        } else if (*ptr == ',' || *ptr == ']') {
+          if (num != "") vec.push_back(std::stod(num));
+          num = "";
+          if (*ptr == ']') this->push_back(vec);
+        } else if (*ptr != ' ') {
+          num += *ptr;
+        }
+      }
+    }
+};
+
 #endif
@@ -18,4 +18,24 @@ inline int CalcInputLength(int output_len)
 {
   return (output_len < 1) ? 
             kFilter_len : (output_len-1)*kStride + kFilter_len - 2*kPadding;
-}
\ No newline at end of file
+}
+//! @brief            Integer ceil(a/b) for positive operands.
+inline int CeilDiv(int a, int b)
+{
+  return (a + b - 1) / b;
+}
+//! @brief            Number of groups whose input channels a tile of output
+//!                   channels reads.
+//! @details          A tile which does not evenly split groups may straddle
+//!                   one more group.
+//! @param oc_len     Output channels of the tile.
+//! @param group_oc   Output channels of a group.
+//! @param groups     Number of groups. 1 for a dense convolution.
+inline int CalcGroupSpan(int oc_len, int group_oc, int groups)
+{
+  if (groups == 1) return 1;
+  if (oc_len % group_oc == 0 || group_oc % oc_len == 0)
+    return CeilDiv(oc_len, group_oc);
+  int span = CeilDiv(oc_len - 1, group_oc) + 1;
+  return (span < groups) ? span : groups;
+}
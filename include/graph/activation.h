@@ -19,7 +19,7 @@ namespace activ {
 class Activation : public Layer
 {
   public:
-    Activation(active::Type type) : type_(type) {}
+    Activation(activ::Type type) : type_(type) {}
     activ::Type GetType(void) const { return type_; }
     virtual Data* GetOutput(vector<Data*> inputs) const final 
     { return act(inputs); }
@@ -22,6 +22,11 @@ class Convolution : public Layer
     virtual Data* GetOutput(vector<Data*> inputs) const final
     { return conv(inputs); }
 
+    int GetKsize(void)   const { return ksize_;   }
+    int GetChannel(void) const { return channel_; }
+    int GetStride(void)  const { return stride_;  }
+    int GetPadding(void) const { return padding_; }
+
   private:
     const int ksize_;
     const int channel_;
@@ -3,7 +3,6 @@
 #include "graph/data.h"
 
 using graph::data::Data;
-using graph::data::DataType;
 
 namespace graph {
 namespace data {
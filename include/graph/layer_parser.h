@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+#include "graph/layer.h"
+#include "graph/network.h"
+
+using std::string;
+
+using graph::layer::Layer;
+using graph::Network;
+
+namespace graph {
+//! @brief        Make a layer from its description.
+//! @details      relu, leaky and bn are element-wise layers.
+//!               pool:<k>:<s>[:<p>] is a max pool layer and
+//!               conv:<k>:<oc>:<s>:<p> is a convolutional layer.
+//! @param spec   Layer description.
+//! @return       New layer.
+Layer* ParseLayer(const string& spec);
+//! @brief        Make a sequential network from a network file.
+//! @details      The first line is input:<n>:<c>:<h>:<w> and each next line
+//!               describes a layer like ParseLayer. Empty lines and lines
+//!               starting with # are skipped.
+//!               The header takes the input from an edge without a source
+//!               and the trailer gives the output to an edge without a
+//!               destination.
+//! @param path   Network file path.
+//! @return       New network.
+Network* ParseNetwork(const char* path);
+} // namespace graph
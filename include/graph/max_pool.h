@@ -26,6 +26,10 @@ class MaxPool : public Layer
     Data* GetOutput(vector<Data*> inputs) const final
     { return maxpool(inputs); }
 
+    int GetKsize(void)   const { return ksize_;   }
+    int GetStride(void)  const { return stride_;  }
+    int GetPadding(void) const { return padding_; }
+
   private:
     const size_t ksize_;
     const size_t stride_;
@@ -26,7 +26,7 @@ class Network
     Vertex* GetTrailer(void) const{ return trailer_; }
 
   private:
-    Graph* network_;
+    Graph* network_ = nullptr;
     Vertex* header_ = nullptr;
     Vertex* trailer_ = nullptr;
 };
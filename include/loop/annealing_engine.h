@@ -0,0 +1,32 @@
+#ifndef CNNPLANNER_LOOP_ANNEALING_ENGINE_H_
+#define CNNPLANNER_LOOP_ANNEALING_ENGINE_H_
+
+#include "loop/search_engine.h"
+
+namespace loop {
+//! @brief  The number of independent annealing chains of a search.
+const int kAnnealingChainCnt = 16;
+//! @brief  Temperatures in log-EDP units at the start and the end of a chain.
+const double kAnnealingStartTemp = 0.5;
+const double kAnnealingEndTemp = 0.001;
+//! @brief  Evaluations spent to make a random start tiling fit.
+const int kAnnealingRepairTry = 32;
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Parallel simulated annealing over the tiling digits.
+//! @details    Each chain starts from a random fitting tiling and moves one
+//!             digit a step, or to a random tile size, per evaluation.
+//!             Tilings which overflow on-chip memory are rejected. Moves
+//!             are accepted by the Metropolis rule on log EDP under a
+//!             geometric cooling schedule.
+////////////////////////////////////////////////////////////////////////////////
+class AnnealingEngine : public loop::SearchEngine
+{
+  public:
+    SearchResult Search(TilingSpace* space, unsigned int num_threads) override;
+
+  private:
+    void SearchChain( TilingSpace* space, unsigned int thr, int chain,
+                      SearchResult* best) const;
+};
+} // namespace loop
+#endif
@@ -0,0 +1,47 @@
+#ifndef CNNPLANNER_LOOP_ANYTIME_ENGINE_H_
+#define CNNPLANNER_LOOP_ANYTIME_ENGINE_H_
+
+#include <chrono>
+
+#include "loop/exhaustive_engine.h"
+
+namespace loop {
+//! @brief  Regions of the anytime search. Enough to order the search finely,
+//!         few enough to bound them all quickly.
+const EncodedItr kMinRegionPerThread = 64;
+const EncodedItr kMaxRegionCnt = 1 << 16;
+//! @brief  Upper bound of a chunk of the anytime search, so workers see the
+//!         deadline soon after it passes.
+const EncodedItr kMaxAnytimeChunkSize = 1 << 12;
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Time budgeted search of the most promising regions first.
+//! @details    A region fixes the upper digits, so it is a contiguous range
+//!             of traversal ranks. Regions which cannot fit on-chip memory
+//!             are skipped, and the rest are visited in the order of their
+//!             EDP lower bounds until the budget runs out. The unvisited
+//!             regions bound the optimality gap of the result.
+////////////////////////////////////////////////////////////////////////////////
+class AnytimeEngine : public loop::ExhaustiveEngine
+{
+  public:
+    //! @param budget_ms    Search time budget (msec).
+    explicit AnytimeEngine(double budget_ms) : budget_ms_(budget_ms) {}
+    SearchResult Search(TilingSpace* space, unsigned int num_threads) override;
+    double GetCoverage(void) const override { return coverage_; }
+    double GetOptimalityGap(void) const override { return gap_; }
+
+  protected:
+    void DistributeChunks(void) override;
+    bool IsStopped(void) const override;
+    void FinishSearch(const SearchResult& result) override;
+
+  private:
+    double budget_ms_;
+    std::chrono::steady_clock::time_point deadline_;
+    vector<SearchRegion> regions_;  // Feasible regions by first rank.
+    EncodedItr infeasible_cnt_ = 0; // Tilings of the infeasible regions.
+    double coverage_ = 1.0;
+    double gap_ = 0.0;
+};
+} // namespace loop
+#endif
@@ -0,0 +1,34 @@
+#ifndef CNNPLANNER_LOOP_BRANCH_AND_BOUND_ENGINE_H_
+#define CNNPLANNER_LOOP_BRANCH_AND_BOUND_ENGINE_H_
+
+#include <atomic>
+
+#include "loop/exhaustive_engine.h"
+
+using std::atomic;
+
+namespace loop {
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Depth-first branch and bound over the tiling digits.
+//! @details    Digits are branched from the most significant, larger tile
+//!             sizes first since they find a good bound early. A subtree is
+//!             pruned if its lower digits cannot fit on-chip memory, or its
+//!             EDP lower bound exceeds the best EDP shared by the workers.
+//!             Subtrees rooted at the two most significant digits are the
+//!             chunks of the workers.
+////////////////////////////////////////////////////////////////////////////////
+class BranchAndBoundEngine : public loop::ExhaustiveEngine
+{
+  protected:
+    void DistributeChunks(void) override;
+    EncodedItr VisitChunk(unsigned int thr, const SearchChunk& chunk,
+                          SearchResult* best) override;
+
+  private:
+    atomic<double> bound_edp_;  // Best EDP of every worker.
+
+    //! @brief              Search the subtree whose digits above i are set.
+    void SearchBranch(unsigned int thr, int i, int* digit, SearchResult* best);
+};
+} // namespace loop
+#endif
@@ -2,11 +2,13 @@
 #define CNNPLANNER_LOOP_CNN_LOOP_H_
 
 #include <memory>
+#include <vector>
 
 #include "loop/variable_set.h"
 #include "loop/structure.h"
 
 using std::unique_ptr;
+using std::vector;
 
 using loop::VariableSet;
 using loop::Structure;
@@ -40,6 +42,12 @@ class CnnLoop
     //! @brief          Set on-chip loop structure.
     //! @param on_strt  On-chip loop structure.
     void SetOnStructure(Structure* on_strt);
+    //! @brief              Set loop structures of on-chip memory levels.
+    //! @details            Each structure orders the loops which walk the
+    //!                     next inner tile over the tile of its level.
+    //!                     The first one walks over the whole layer.
+    //! @param level_strts  Structure of each memory level, outermost first.
+    void SetLevelStructures(const vector<Structure>& level_strts);
 
     //! @brief          Get variable set.
     //! @details        Return non-constant reference to update varset easily.
@@ -53,6 +61,9 @@ class CnnLoop
     //! @details        Return non-constant reference to update on_strt easily.
     //! @return         On-chip structure.
     const Structure& GetOnStructure(void) const;
+    //! @brief          Get loop structures of on-chip memory levels.
+    //! @return         Structure of each memory level, outermost first.
+    const vector<Structure>& GetLevelStructures(void) const;
     //! @brief          Rearrange loop structure.
     //! @details        Move fully tiled loop dimension to innermost.
     void MoveFullyTiledToInnerMost(void);
@@ -64,6 +75,7 @@ class CnnLoop
     unique_ptr<VariableSet>  varset_;
     unique_ptr<Structure>    off_strt_;
     unique_ptr<Structure>    on_strt_;
+    vector<Structure>        level_strts_;
 };
 } // namespace loop
 
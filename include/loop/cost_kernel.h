@@ -0,0 +1,80 @@
+#ifndef CNNPLANNER_LOOP_COST_KERNEL_H_
+#define CNNPLANNER_LOOP_COST_KERNEL_H_
+
+#include "loop/tiling_candidate.h"
+
+namespace loop {
+//! @brief  The number of candidates evaluated by one kernel call.
+const int kCostBlockLen = 64;
+//! @brief  The number of fully tiled masks over the four off-chip loops.
+const int kFullyTiledMaskCnt = 1 << 4;
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Structure-of-arrays block of tiling candidates.
+//! @details    The kernel converts lengths and quotients to doubles, which
+//!             are exact up to 2^53, so it computes the same sizes and reload
+//!             counts as the integer cost functions. Group terms are filled
+//!             with the tiles, so the kernel lanes are straight arithmetic.
+//!             Parallelization loop variables are only computed at lanes
+//!             where a PE mapped tile changed, and later lanes refer to them
+//!             by parl_lane.
+////////////////////////////////////////////////////////////////////////////////
+struct CostBlock
+{
+  int size;
+  EncodedItr itr[kCostBlockLen];                      // Encoded iterations.
+  bool parl_stale[kCostBlockLen];                 // Unrolling changed here.
+  int tile[kDimensionCnt][kCostBlockLen];         // Indexed by DataDimension.
+  int quot[kDimensionCnt][kCostBlockLen];         // ceil(dim/tile)
+  double group_span[kCostBlockLen];               // CalcGroupSpan of OC tile
+  double group_quot[kCostBlockLen];               // ceil(quot[OC]/groups)
+  double pe_util[kCostBlockLen];
+  int parl_lane[kCostBlockLen];                   // -1 for the cursor's one.
+  int parl[kCostBlockLen][kDimensionCnt];
+
+  int overflow[kCostBlockLen];                    // Output of Overflow.
+  double edp[kCostBlockLen];                      // Output of Evaluate.
+};
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Batched EDP and on-chip memory overflow evaluation.
+//! @details    Same models as Scheduler::IsMemorySizeOverflow, GetEdp and
+//!             GetBestOrderEdp, written lane by lane without branches.
+//!             The kernels are cloned for AVX-512, AVX2 and the default
+//!             instruction set, and the loader picks one for the host.
+////////////////////////////////////////////////////////////////////////////////
+class CostKernel
+{
+  public:
+    //! @brief              Set the layer and hardware constants.
+    //! @param ctx          Search context of the layer.
+    //! @param stationary   Stationary of the heuristic reload model, or -1
+    //!                     for the minimum over every off-chip loop order.
+    //! @param reach_flags  Bit f is set if some loop order gives stationary
+    //!                     flags f, indexed by fully tiled mask. Only used
+    //!                     with every loop order.
+    void Init(const SearchContext& ctx, int stationary,
+              const int* reach_flags);
+    //! @brief              Mark candidates whose tiles overflow on-chip memory.
+    //! @param block        Reads tile and group_span, writes overflow.
+    //! @return             The number of candidates which fit.
+    int Overflow(CostBlock* block) const;
+    //! @brief              Estimate EDP of candidates.
+    //! @param block        Reads quot, group_quot and pe_util, writes edp.
+    void Evaluate(CostBlock* block) const;
+
+  private:
+    double input_size_;       // Elements of the whole layer.
+    double weight_size_;
+    double output_size_;
+    double input_mem_size_;   // Bytes of single and double buffers.
+    double weight_mem_size_;
+    double output_mem_size_;
+    double input_half_size_;
+    double weight_half_size_;
+    double output_half_size_;
+    double peak_perf_;        // frequency * PE count (ops/ns)
+    double ops_bandwidth_;    // Operations * bandwidth
+    int stationary_;
+    int reach_flags_[kFullyTiledMaskCnt];
+};
+} // namespace loop
+#endif
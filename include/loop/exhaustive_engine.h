@@ -0,0 +1,72 @@
+#ifndef CNNPLANNER_LOOP_EXHAUSTIVE_ENGINE_H_
+#define CNNPLANNER_LOOP_EXHAUSTIVE_ENGINE_H_
+
+#include <mutex>
+#include <memory>
+#include <atomic>
+
+#include "loop/search_engine.h"
+#include "loop/search_queue.h"
+#include "general/tqdm.h"
+
+using std::mutex;
+using std::unique_ptr;
+using std::atomic;
+
+namespace loop {
+//! @brief  Chunks per worker of the exhaustive search. Small chunks keep
+//!         every worker busy until the end of the search, large chunks keep
+//!         the queue locking overhead low.
+const EncodedItr kChunksPerThread = 64;
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Exhaustive search of a range of traversal ranks.
+//! @details    Each worker owns a contiguous part of the range in its
+//!             queue of chunks and steals the farthest chunks of the others
+//!             once its own queue is empty. Ties on EDP go to the larger
+//!             encoded iteration, so the result does not depend on
+//!             stealing.
+////////////////////////////////////////////////////////////////////////////////
+class ExhaustiveEngine : public loop::SearchEngine
+{
+  public:
+    SearchResult Search(TilingSpace* space, unsigned int num_threads) override;
+    //! @brief              Search only ranks [begin, end], e.g. a shard.
+    //! @details            The whole space is searched by default.
+    void SetRange(EncodedItr begin, EncodedItr end);
+
+  protected:
+    TilingSpace* space_ = nullptr;
+    unsigned int num_threads_ = 1;
+    vector<unique_ptr<SearchQueue>> queues_;  // Indexed by worker.
+    atomic<bool> has_feasible_;               // Some worker found a fitting
+                                              // tiling.
+    //! @brief              Fill the queues before the workers start.
+    virtual void DistributeChunks(void);
+    //! @brief              Search a chunk.
+    //! @return             The number of tilings the chunk covers.
+    virtual EncodedItr VisitChunk(unsigned int thr, const SearchChunk& chunk,
+                                  SearchResult* best);
+    //! @brief              Return true to stop taking chunks.
+    virtual bool IsStopped(void) const { return false; }
+    //! @brief              Called after the workers join.
+    virtual void FinishSearch(const SearchResult& result) {}
+    //! @brief              Deal [begin, end] to the queues, a contiguous part
+    //!                     per worker.
+    void DistributeRange(EncodedItr begin, EncodedItr end);
+
+  private:
+    EncodedItr begin_ = 0;
+    EncodedItr end_ = 0;
+    mutex mtx_lock_;
+    tqdm progress_bar_;
+    EncodedItr progress_;
+    EncodedItr progress_total_;
+    EncodedItr progress_scale_; // Tilings per tqdm step.
+
+    void SearchWorker(unsigned int thr, SearchResult* best);
+    bool GetChunk(unsigned int thr, SearchChunk* chunk);
+    void StartProgress(EncodedItr total);
+    void IncreaseProgress(EncodedItr interval);
+};
+} // namespace loop
+#endif
@@ -0,0 +1,106 @@
+#ifndef CNNPLANNER_LOOP_FUSION_SCHEDULER_H_
+#define CNNPLANNER_LOOP_FUSION_SCHEDULER_H_
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "loop/cnn_loop.h"
+#include "arch/architecture.h"
+#include "graph/layer.h"
+
+using std::string;
+using std::vector;
+using std::unique_ptr;
+
+using loop::CnnLoop;
+using arch::Architecture;
+using graph::layer::Layer;
+
+namespace loop {
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      One layer of a fused layer chain.
+//! @details    A layer reads the window [o*stride - pad, o*stride - pad +
+//!             ksize) of its input for output o. Element-wise layers have a
+//!             1x1 window and run in place on the output of the layer before.
+////////////////////////////////////////////////////////////////////////////////
+struct FusedLayer
+{
+  int in_w, in_h, in_c;
+  int out_w, out_h, out_c;
+  int ksize, stride, pad;
+  long int weight_size; // Elements. 0 if the layer has no weights.
+  long int ops_per_out; // Operations for one output element.
+  bool is_elementwise;
+};
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Fused tiling of a layer chain and its cost.
+//! @details    Tiles are taken on the output of the last layer and grown
+//!             back through the chain by the halo of each window. Every
+//!             layer keeps all its channels of a tile on-chip.
+////////////////////////////////////////////////////////////////////////////////
+struct FusionPlan
+{
+  bool is_feasible = false;
+  int tile_w = 0, tile_h = 0;     // Output tile of the last layer.
+  vector<int> layer_tile_w;       // Largest computed output tile of a layer.
+  vector<int> layer_tile_h;
+  bool is_weight_resident = false;// All weights of the chain stay on-chip.
+  long int on_chip_bytes = 0;     // Buffer footprint including double buffering.
+  long int dram_bytes = 0;        // Off-chip accesses of the fused plan.
+  long int layerwise_dram_bytes = 0; // Off-chip accesses layer by layer.
+  long int num_ops = 0;           // Operations of the chain without halos.
+  long int recompute_ops = 0;     // Operations repeated on overlapping halos.
+  double latency = 0.0;           // Estimated latency (ns).
+  double layerwise_latency = 0.0; // Estimated latency layer by layer (ns).
+};
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Scheduling a chain of layers as a single fused loop.
+//! @details    The chain starts at the convolution of the compiled layer.
+//!             Intermediate tiles never leave the chip, so only the input of
+//!             the first layer, the weights and the output of the last layer
+//!             are off-chip accesses. Neighbouring tiles overlap on the halo
+//!             of the windows, which is loaded and computed again.
+//!             The layer-by-layer plan is costed by the scheduled accesses
+//!             of each layer, like NetworkScheduler: the head keeps its
+//!             loop, other convolutions are scheduled alone and max pool
+//!             layers stream their input once.
+////////////////////////////////////////////////////////////////////////////////
+class FusionScheduler
+{
+  public:
+    //! @brief              Build the chain.
+    //! @param head         Scheduled loop of the convolution which heads the
+    //!                     chain.
+    //! @param chain        Layers after the head, in order. Convolution and
+    //!                     MaxPool have windows, other layers are
+    //!                     element-wise.
+    //! @param search_mode  Tiling search mode of the other convolutions.
+    FusionScheduler(const CnnLoop& head, const vector<const Layer*>& chain,
+                    const char* search_mode);
+    //! @brief          Search the output tile of the fused chain.
+    //! @details        The tile with the lowest roofline latency is taken,
+    //!                 then the one with the fewest off-chip accesses.
+    //! @param arch     Hardware configurations.
+    //! @return         Best fused plan. Not feasible if no tile fits on-chip.
+    FusionPlan SearchFusedTiling(const Architecture& arch) const;
+    //! @brief          Return layers of the chain, head first.
+    //! @return         Fused layers.
+    const vector<FusedLayer>& GetFusedLayers(void) const;
+
+  private:
+    vector<FusedLayer> layers_;
+    unique_ptr<CnnLoop> head_;
+    string search_mode_;
+    int batch_;
+
+    void GetHaloExtents(bool is_width, int tile, vector<long int>* sum_ext,
+                        vector<int>* max_ext) const;
+    void GetTileSpace(int len, vector<int>* tiles) const;
+    long int GetLayerwiseDramBytes(size_t l, const Architecture& arch) const;
+    long int ScheduleConvolution( const FusedLayer& layer,
+                                  const Architecture& arch) const;
+    long int GetLayerOps(const FusedLayer& layer) const;
+};
+} // namespace loop
+#endif
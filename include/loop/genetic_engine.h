@@ -0,0 +1,48 @@
+#ifndef CNNPLANNER_LOOP_GENETIC_ENGINE_H_
+#define CNNPLANNER_LOOP_GENETIC_ENGINE_H_
+
+#include <vector>
+
+#include "loop/search_engine.h"
+
+using std::vector;
+
+namespace loop {
+//! @brief  The number of independent islands of a search.
+const int kGeneticIslandCnt = 8;
+//! @brief  Individuals of an island.
+const int kGeneticPopulation = 32;
+//! @brief  Best individuals copied to the next generation unchanged.
+const int kGeneticEliteCnt = 2;
+//! @brief  Evaluations spent to make a child tiling fit.
+const int kGeneticRepairTry = 8;
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Parallel genetic algorithm over the tiling digits.
+//! @details    Islands evolve independently. Parents are picked by binary
+//!             tournaments and mixed by uniform crossover of the digits.
+//!             Each digit mutates with probability 1/kTileDimensionCnt, and
+//!             children which overflow on-chip memory are repaired by
+//!             shrinking random digits.
+////////////////////////////////////////////////////////////////////////////////
+class GeneticEngine : public loop::SearchEngine
+{
+  public:
+    SearchResult Search(TilingSpace* space, unsigned int num_threads) override;
+
+  private:
+    struct Individual
+    {
+      int digit[kTileDimensionCnt];
+      SearchResult result;  // edp is DBL_MAX if it does not fit.
+    };
+
+    void SearchIsland(TilingSpace* space, unsigned int thr, int island,
+                      SearchResult* best) const;
+    void Evaluate(TilingSpace* space, unsigned int thr, uint64_t* rng_state,
+                  Individual* ind, EncodedItr* eval_cnt) const;
+    const Individual& SelectParent( const vector<Individual>& population,
+                                    uint64_t* rng_state) const;
+    static bool IsBetter(const Individual& a, const Individual& b);
+};
+} // namespace loop
+#endif
@@ -0,0 +1,114 @@
+#ifndef CNNPLANNER_LOOP_NETWORK_SCHEDULER_H_
+#define CNNPLANNER_LOOP_NETWORK_SCHEDULER_H_
+
+#include <string>
+#include <vector>
+
+#include "loop/tiling_candidate.h"
+#include "arch/architecture.h"
+#include "graph/network.h"
+#include "graph/data4d.h"
+
+using std::string;
+using std::vector;
+
+using arch::Architecture;
+using graph::Network;
+using graph::data::Data4d;
+
+namespace loop {
+enum NetworkObjective { LATENCY=0, ENERGY };
+
+#define S_LATENCY "latency"
+#define S_ENERGY  "energy"
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Schedule of one layer in a network plan.
+////////////////////////////////////////////////////////////////////////////////
+struct LayerPlan
+{
+  string name;
+  int point;                // Pareto point of the convolution. -1 otherwise.
+  bool is_input_resident;   // The input is read from on-chip memory.
+  bool is_output_resident;  // The output stays in on-chip memory.
+  long int dram_bytes;
+  double latency;           // ns
+  double energy;            // nJ
+};
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Schedules of every layer of a network and their total cost.
+//! @details    The layer-by-layer plan stores and reloads every activation
+//!             and takes the best schedule of each layer alone, like
+//!             compiling layers one by one.
+////////////////////////////////////////////////////////////////////////////////
+struct NetworkPlan
+{
+  vector<LayerPlan> layers;
+  long int dram_bytes = 0;
+  double latency = 0.0;
+  double energy = 0.0;
+  long int layerwise_dram_bytes = 0;
+  double layerwise_latency = 0.0;
+  double layerwise_energy = 0.0;
+};
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Scheduling a sequential network as a whole.
+//! @details    Each convolution is searched alone and keeps its Pareto
+//!             frontier as schedule options. Element-wise layers run on
+//!             the output of the layer before and max pool layers stream
+//!             their input once.
+//!             An activation may stay resident in the output memory
+//!             between its producer and its consumer, which removes its
+//!             store and reload. The producer's output tiles or the
+//!             consumer's input tiles are then parts of the resident
+//!             activation. While a layer runs, the output memory holds its
+//!             resident input and either its resident output or its
+//!             output buffer. Residencies and schedules are decided
+//!             jointly by dynamic programming over the layer sequence.
+////////////////////////////////////////////////////////////////////////////////
+class NetworkScheduler
+{
+  public:
+    //! @brief              Search schedule options of every layer.
+    //! @param network      Sequential network.
+    //! @param arch         Hardware configurations.
+    //! @param search_mode  Tiling search mode of each convolution.
+    NetworkScheduler( const Network& network, const Architecture& arch,
+                      const char* search_mode);
+    //! @brief              Set what the network plan minimizes.
+    //! @param objective    Objective name (latency, energy).
+    void SetObjective(const char* objective);
+    //! @brief              Decide schedules and residencies of the network.
+    //! @return             Best network plan.
+    NetworkPlan SearchNetworkPlan(void) const;
+
+  private:
+    //! @brief  Off-chip accesses and buffers of a layer schedule.
+    struct LayerOption
+    {
+      long int data_bytes[3];     // Indexed by Stationary.
+      long int output_buf_bytes;
+      double pe_util;
+    };
+    //! @brief  Layer which is scheduled on its own.
+    struct Stage
+    {
+      string name;
+      long int num_ops;
+      long int output_bytes;      // Size of the output activation.
+      vector<LayerOption> options;
+    };
+
+    const Architecture& arch_;
+    NetworkObjective objective_ = NetworkObjective::LATENCY;
+    vector<Stage> stages_;
+    double peak_perf_;            // ops/ns
+
+    void SearchConvolution( const Data4d& input, int ksize, int stride,
+                            int padding, int channel, const char* search_mode,
+                            Stage* stage);
+    bool MakeLayerPlan( size_t i, size_t option, bool is_input_resident,
+                        bool is_output_resident, LayerPlan* plan) const;
+    double GetObjective(const LayerPlan& plan) const;
+};
+} // namespace loop
+#endif
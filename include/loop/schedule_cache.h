@@ -0,0 +1,110 @@
+#ifndef CNNPLANNER_LOOP_SCHEDULE_CACHE_H_
+#define CNNPLANNER_LOOP_SCHEDULE_CACHE_H_
+
+#include <stdint.h>
+
+#include "loop/cnn_loop.h"
+#include "arch/architecture.h"
+
+using loop::CnnLoop;
+using arch::Architecture;
+
+namespace loop {
+//! @brief  Bump when the scheduler may choose another loop for the same key.
+const int kScheduleCacheVersion = 6;
+//! @brief  Upper bound of the words of a schedule key. Enough for the most
+//!         PE arrays and memory levels the scheduler takes.
+const int kScheduleKeyLen = 128;
+//! @brief  The number of slots of a schedule cache file.
+const uint64_t kScheduleCacheSlotCnt = 1 << 13;
+//! @brief  The number of slots probed before giving up a lookup or insertion.
+const int kScheduleCacheProbeLen = 32;
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Layer shape, architecture and planner version of a schedule.
+//! @details    Doubles are stored by their bits and unused words are zero,
+//!             so two keys are equal iff their words are equal.
+////////////////////////////////////////////////////////////////////////////////
+struct ScheduleKey
+{
+  int64_t word[kScheduleKeyLen];
+};
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Persistent schedule cache shared by compiler processes.
+//! @details    Open addressing hash table of fixed size slots in a file,
+//!             mapped with mmap. Lookups hold a shared flock and insertions
+//!             hold an exclusive one, so any number of compiler processes
+//!             can use the same file. A slot is marked ready after it is
+//!             written, so a process killed while writing leaves it empty.
+//!             A file of another version or layout is left untouched and
+//!             the cache is disabled.
+////////////////////////////////////////////////////////////////////////////////
+class ScheduleCache
+{
+  public:
+    //! @brief              Open or create the cache file.
+    //! @param path         Cache file path.
+    ScheduleCache(const char* path);
+    //! @brief              Unmap and close the cache file.
+    ~ScheduleCache(void);
+    //! @brief              Make the key of a layer.
+    //! @details            Layers whose architecture does not fit in
+    //!                     kScheduleKeyLen words have no key, so they are
+    //!                     searched without the cache.
+    //! @param loop         Overall loop information of CNN.
+    //! @param arch         Hardware configurations.
+    //! @param search_mode  Search mode name, which may change the result.
+    //! @param tile_enum    Tile enumeration name, which may change the
+    //!                     result.
+    //! @param loop_order   Loop order search name, which changes the result.
+    //! @param intra_order  Intra loop order search name, which changes the
+    //!                     on-chip structure.
+    //! @param key          Schedule key.
+    //! @return             False if the key is too long.
+    static bool MakeKey(const CnnLoop& loop, const Architecture& arch,
+                        const char* search_mode, const char* tile_enum,
+                        const char* loop_order, const char* intra_order,
+                        ScheduleKey* key);
+    //! @brief              Look up a scheduled loop.
+    //! @param key          Schedule key.
+    //! @param loop         Variables and structures are replaced by the
+    //!                     cached ones if it is found.
+    //! @return             False if the key is not cached.
+    bool Find(const ScheduleKey& key, CnnLoop* loop) const;
+    //! @brief              Cache a scheduled loop.
+    //! @param key          Schedule key.
+    //! @param loop         Loop finished by the compiler.
+    void Insert(const ScheduleKey& key, const CnnLoop& loop);
+
+  private:
+    enum SlotState {EMPTY=0, READY};
+    struct Header
+    {
+      char magic[8];
+      uint32_t version;
+      uint32_t slot_size;
+      uint64_t slot_cnt;
+    };
+    struct Slot
+    {
+      uint64_t state;
+      uint64_t hash;
+      ScheduleKey key;
+      Variables on_loop_vars;
+      Variables parl_loop_vars;
+      Structure off_strt;
+      Structure on_strt;
+      uint64_t level_cnt;
+      Variables level_loop_vars[arch::kMaxMemLevelCnt];
+      Structure level_strts[arch::kMaxMemLevelCnt];
+    };
+
+    uint64_t GetHash(const ScheduleKey& key) const;
+    bool IsValidHeader(const Header& header) const;
+    Slot* GetSlots(void) const;
+
+    int fd_ = -1;
+    void* map_ = nullptr;
+    size_t map_size_ = 0;
+};
+} // namespace loop
+#endif
@@ -2,20 +2,23 @@
 #define CNNPLANNER_LOOP_SCHEDULER_H_
 
 #include <thread>
-#include <mutex>
 #include <vector>
 #include <utility>
 #include <memory>
+#include <string>
 
 #include "loop/cnn_loop.h"
+#include "loop/search_queue.h"
+#include "loop/tiling_candidate.h"
+#include "loop/cost_kernel.h"
+#include "loop/search_engine.h"
 #include "arch/architecture.h"
-#include "general/tqdm.h"
 
 using std::thread;
-using std::mutex;
 using std::vector;
 using std::pair;
 using std::unique_ptr;
+using std::string;
 
 using loop::CnnLoop;
 using arch::Architecture;
@@ -28,6 +31,34 @@ namespace loop {
 //! @date       2019-07-03
 ////////////////////////////////////////////////////////////////////////////////
 enum Stationary { INPUT=0, WEIGHT, OUTPUT };
+enum SearchMode { EXHAUSTIVE=0, BRANCH_AND_BOUND, ANNEALING, GENETIC };
+
+enum TileEnumeration { FULL_TILES=0, CLASS_TILES };
+enum LoopOrderSearch { HEURISTIC_ORDER=0, ALL_ORDERS };
+enum IntraOrderSearch { FIXED_INTRA_ORDER=0, ALL_INTRA_ORDERS };
+enum TileTraversal { DECODE_TRAVERSAL=0, GRAY_TRAVERSAL };
+
+#define S_EXHAUSTIVE        "exhaustive"
+#define S_BRANCH_AND_BOUND  "bnb"
+#define S_ANNEALING         "anneal"
+#define S_GENETIC           "genetic"
+
+#define S_FULL_TILES        "full"
+#define S_CLASS_TILES       "class"
+
+#define S_HEURISTIC_ORDER   "heuristic"
+#define S_ALL_ORDERS        "all"
+
+#define S_FIXED_INTRA_ORDER "fixed"
+#define S_ALL_INTRA_ORDERS  "all"
+
+#define S_DECODE_TRAVERSAL  "decode"
+#define S_GRAY_TRAVERSAL    "gray"
+
+//! @brief  The number of loop orders of the off-chip or intra loop (4!).
+const int kLoopOrderCnt = 24;
+//! @brief  The number of off-chip loops.
+const int kLoopCnt = 4;
 
 class Scheduler
 {
@@ -40,40 +71,229 @@ class Scheduler
     //! @brief                  Search best tiling case and loop structure.
     //! @details                Core engine of this project.
     //!                         Implement double return method by pointer.
+    //!                         With memory levels above PE-local memory,
+    //!                         each level is tiled from the outermost one
+    //!                         like a layer of the size of the tile above,
+    //!                         fed by the bandwidth of the level above.
     //! @param loop             Overall loop informantion of CNN.
     //! @param arch             Hardware configurations.
     //! @return                 New instance of CnnLoop.
     CnnLoop* SearchBestLoopCase(const CnnLoop& loop, const Architecture& arch);
+    //! @brief                  Search a part of the tiling space.
+    //! @details                Encoded iterations [begin, end] are searched
+    //!                         exhaustively, so several processes or machines
+    //!                         can share one layer and merge the results
+    //!                         with MergeShards.
+    //! @param loop             Overall loop informantion of CNN.
+    //! @param arch             Hardware configurations.
+    //! @param begin            First encoded iteration, starting from 1.
+    //! @param end              Last encoded iteration, at most
+    //!                         CountTilingSpace().
+    //! @return                 Best candidate of the shard.
+    ShardResult SearchShard(const CnnLoop& loop, const Architecture& arch,
+                            EncodedItr begin, EncodedItr end);
+    //! @brief                  Return the number of encoded iterations.
+    //! @param loop             Overall loop informantion of CNN.
+    //! @param arch             Hardware configurations.
+    //! @return                 Size of the tiling space searched by
+    //!                         SearchBestLoopCase.
+    EncodedItr CountTilingSpace(const CnnLoop& loop, const Architecture& arch);
+    //! @brief                  Make the best loop from searched shards.
+    //! @details                Shards must cover the tiling space exactly
+    //!                         once. The result is the same as
+    //!                         SearchBestLoopCase whatever the shard order.
+    //! @param loop             Overall loop informantion of CNN.
+    //! @param arch             Hardware configurations.
+    //! @param shards           Results of SearchShard.
+    //! @return                 New instance of CnnLoop.
+    CnnLoop* MergeShards( const CnnLoop& loop, const Architecture& arch,
+                          const vector<ShardResult>& shards);
     //! @brief                  Set parallelization loop variables
     //! @param on_vars          Intra loop variables
     //! @param arch             Hardware configurations
     //! @return                 Unroll loop variables based on architecture
     loop::Variables MakeParlLoopVariables(const loop::Variables& on_vars, 
                                           const Architecture& arch);
-    //! @brief                  Set intra loop structure by fixed sequence.
-    //! @detils                 Need to add architecture based algorithm to decide intra loop structure.
+    //! @brief                  Decide intra loop structure of a tiling.
+    //! @details                The intra loop order does not change DRAM
+    //!                         accesses or latency, so it is searched after
+    //!                         the off-chip search for the chosen tiling.
+    //!                         See SetIntraOrderSearch.
+    //! @param varset           Set of scheduled CNN parameters.
+    //! @param arch             Hardware configurations.
     //! @return                 New on-chip loop structure.
-    //TODO (MinsuKim): Make algorithm to decide on-chip loop structure.
-    Structure* FixOnLoopStructure(void);
+    Structure* DecideOnLoopStructure( const VariableSet& varset,
+                                      const Architecture& arch) const;
+    //! @brief                  Split the on-chip tile over the PE arrays.
+    //! @details                Output channels, or output rows if the tile
+    //!                         has fewer channels than arrays, are shared so
+    //!                         that the arrays finish a tile at the same
+    //!                         time. The first array computes the whole tile
+    //!                         if that is faster by the single array model.
+    //!                         Each array keeps its unrolling of the whole
+    //!                         tile. Nothing is split for one PE array.
+    //! @param varset           Set of scheduled CNN parameters.
+    //! @param arch             Hardware configurations.
+    //! @return                 New variable set with the share and the
+    //!                         unrolling of each PE array.
+    VariableSet* PartitionPeArrays( const VariableSet& varset,
+                                    const Architecture& arch) const;
+    //! @brief                  Return off-chip accesses of a scheduled loop.
+    //! @details                The tiles and the off-chip loop order of the
+    //!                         loop are costed by the reload model of the
+    //!                         search. With memory levels, the outermost
+    //!                         level tile is the one loaded from off-chip.
+    //! @param loop             Scheduled loop.
+    //! @param arch             Hardware configurations.
+    //! @param data_bytes       Accesses of each Stationary data if not null.
+    //! @return                 Off-chip accesses (Bytes).
+    long int GetLoopDramAccesses( const CnnLoop& loop,
+                                  const Architecture& arch,
+                                  long int* data_bytes=nullptr) const;
+    //! @brief                  Return busy time of each search thread.
+    //! @details                Busy time only counts candidate evaluation,
+    //!                         so it shows how well the search is balanced.
+    //! @return                 Busy time (msec) indexed by thread.
+    const vector<double>& GetThreadBusyTime(void) const;
+    //! @brief                  Set how the tiling space is searched.
+    //! @details                "exhaustive" evaluates every encoded tiling
+    //!                         by ExhaustiveEngine. "bnb" branches dimension
+    //!                         by dimension and cuts subtrees whose EDP lower
+    //!                         bound cannot beat the best one by
+    //!                         BranchAndBoundEngine. Both give the same
+    //!                         result.
+    //!                         "anneal" and "genetic" run AnnealingEngine and
+    //!                         GeneticEngine for huge spaces. They may miss
+    //!                         the best tiling, so spaces no larger than the
+    //!                         evaluation budget are searched exhaustively.
+    //! @param search_mode      Search mode name.
+    void SetSearchMode(const char* search_mode);
+    //! @brief                  Set the random seed of the search engines.
+    //! @param seed             The same seed gives the same result.
+    void SetSearchSeed(uint64_t seed);
+    //! @brief                  Set the evaluation budget of the search
+    //!                         engines.
+    //! @param eval_cnt         Tilings evaluated by a search.
+    void SetSearchEvaluations(EncodedItr eval_cnt);
+    //! @brief                  Return whether the last search is exact.
+    //! @return                 False if a budget or a search engine may
+    //!                         have missed the best tiling.
+    bool IsSearchExact(void) const;
+    //! @brief                  Return pruning ratio of the last search.
+    //! @return                 Pruned tilings over all tilings.
+    double GetPruningRatio(void) const;
+    //! @brief                  Set which tile sizes are enumerated.
+    //! @details                "full" visits every tile size. "class" only
+    //!                         visits the smallest tile of each distinct
+    //!                         ceil(X/Tx) class, since larger tiles in a class
+    //!                         only cost more buffer. Dimensions unrolled on
+    //!                         PE keep every tile, since PE utilization
+    //!                         differs inside a class.
+    //! @param tile_enum        Tile enumeration name.
+    void SetTileEnumeration(const char* tile_enum);
+    //! @brief                  Set how the off-chip loop order is decided.
+    //! @details                "heuristic" puts the loop with the largest
+    //!                         iteration count innermost (LoopInterchange).
+    //!                         "all" costs every tiling with each of the 24
+    //!                         off-chip loop orders using the stationary
+    //!                         rules of Structure::TagStationary and the
+    //!                         reload model of OffChipAccessAnalyzer.
+    //! @param loop_order       Loop order search name.
+    void SetLoopOrderSearch(const char* loop_order);
+    //! @brief                  Set how the intra loop order is decided.
+    //! @details                "fixed" always uses output stationary.
+    //!                         "all" costs each of the 24 intra loop orders
+    //!                         with on-chip access energy and keeps the
+    //!                         cheapest one. An operand stays in the PE
+    //!                         registers during the innermost loops which do
+    //!                         not index it, as in DataReuseAnalyzer.
+    //! @param intra_order      Intra loop order search name.
+    void SetIntraOrderSearch(const char* intra_order);
+    //! @brief                  Set how the exhaustive search visits tilings.
+    //! @details                "decode" decodes every encoded iteration from
+    //!                         scratch. "gray" walks each chunk in mixed-radix
+    //!                         Gray code order, so only one tile changes per
+    //!                         step and reload counts, PE utilization and
+    //!                         unrolling are updated incrementally. Each run
+    //!                         of the moving tile is costed as a CostBlock by
+    //!                         the vectorized CostKernel. Both give the same
+    //!                         result.
+    //! @param tile_traversal   Tile traversal name.
+    void SetTileTraversal(const char* tile_traversal);
+    //! @brief                  Bound the tiling search by wall-clock time.
+    //! @details                The exhaustive search splits the space into
+    //!                         regions of fixed outer tiles, drops regions
+    //!                         which overflow on-chip memory for sure and
+    //!                         visits the rest in ascending order of their
+    //!                         EDP lower bound by AnytimeEngine, like the
+    //!                         bounding step of branch and bound. Threads
+    //!                         stop taking chunks after the deadline once a
+    //!                         feasible tiling is found, and the best one so
+    //!                         far is returned.
+    //! @param budget_ms        Search budget (msec). 0 for no limit.
+    void SetSearchBudget(double budget_ms);
+    //! @brief                  Return coverage of the last search.
+    //! @return                 Evaluated or proven infeasible tilings over
+    //!                         all tilings.
+    double GetSearchCoverage(void) const;
+    //! @brief                  Return optimality gap of the last search.
+    //! @return                 (EDP - lower bound) / EDP where the lower
+    //!                         bound covers the unvisited regions. 0 if the
+    //!                         space is covered.
+    double GetOptimalityGap(void) const;
+    //! @brief                  Keep the Pareto frontier of the search.
+    //! @details                Each search thread keeps non-dominated
+    //!                         tilings over latency, DRAM bytes and on-chip
+    //!                         bytes, and the sets are merged at join. The
+    //!                         EDP winner is still returned by
+    //!                         SearchBestLoopCase. Branch and bound prunes by
+    //!                         EDP, so the exhaustive search is used instead.
+    //! @param use_pareto       True to keep the frontier.
+    void SetParetoFrontier(bool use_pareto);
+    //! @brief                  Return the Pareto frontier of the last search.
+    //! @return                 Points sorted by ascending latency.
+    const vector<ParetoPoint>& GetParetoFrontier(void) const;
+    //! @brief                  Make the scheduled loop of a frontier point.
+    //! @param i                Index of GetParetoFrontier().
+    //! @return                 New instance of CnnLoop.
+    CnnLoop* MakeParetoLoop(size_t i) const;
 
   private:
+    class EngineSpace;
+
     unsigned int num_threads_;
-    thread* search_threads_;
-    mutex mtx_lock_;
-    tqdm progress_bar_;
-    int progress_;
-
-    size_t kw_itr_cnt_;
-    size_t kh_itr_cnt_;
-    size_t ow_itr_cnt_;
-    size_t oh_itr_cnt_;
-    size_t ic_itr_cnt_;
-    size_t oc_itr_cnt_;
-    size_t total_itr_;
-
-    void StartProgress(void);
-    void IncreaseProgress(int interval=1);
-    void FinishProgress(void);
+    SearchMode search_mode_;
+    TileEnumeration tile_enum_;
+    LoopOrderSearch loop_order_;
+    IntraOrderSearch intra_order_;
+    TileTraversal tile_traversal_;
+    loop::Type loop_orders_[kLoopOrderCnt][kLoopCnt]; // Innermost first.
+    bool use_pareto_;
+    bool is_shard_;   // True while SearchShard searches a part of the space.
+    string search_level_; // Level SearchMemoryLevels tiles, or empty.
+    double search_budget_ms_;
+    unique_ptr<SearchEngine> search_engine_;
+    uint64_t search_seed_;
+    EncodedItr search_eval_cnt_;
+    bool is_search_exact_;
+    vector<vector<ParetoPoint>> thread_pareto_;
+    vector<ParetoPoint> pareto_frontier_;
+    unique_ptr<CnnLoop> pareto_base_loop_;  // Loop which the search started.
+
+    vector<EncodedItr> thread_itr_cnt_;
+    CostKernel cost_kernel_;
+
+    EncodedItr kw_itr_cnt_;
+    EncodedItr kh_itr_cnt_;
+    EncodedItr ow_itr_cnt_;
+    EncodedItr oh_itr_cnt_;
+    EncodedItr ic_itr_cnt_;
+    EncodedItr oc_itr_cnt_;
+    EncodedItr n_itr_cnt_;
+    EncodedItr total_itr_;
+    vector<int> tile_space_[kDimensionCnt]; // Tile sizes to visit.
+    vector<int> quot_space_[kDimensionCnt]; // ceil(dim/tile) of tile_space_.
+    EncodedItr itr_radix_[kTileDimensionCnt];   // Indexed by encoding order.
 
     //TODO (MinsuKim): If all variables are fully tiled, then, there is no need to search space pruning anymore.
     bool EndPruning(const VariableSet& varset) const;
@@ -81,29 +301,133 @@ class Scheduler
                                   const Architecture& arch);
     CnnLoop* LoopElimination(const CnnLoop& loop, const Architecture& arch);
     pair<CnnLoop*, Stationary> LoopInterchange(const CnnLoop& loop);
-    void SearchBestLoopCaseThread(CnnLoop* loop, Stationary s, 
-                                  const Architecture& arch,
-                                  double* edp, int start_itr, int end_itr);
+    CnnLoop* SearchMemoryLevels(const CnnLoop& loop, const Architecture& arch);
+    CnnLoop* PrepareSearch( const CnnLoop& loop, const Architecture& arch,
+                            SearchContext* ctx, TilingCandidate* seed,
+                            Stationary* stationary);
+    CnnLoop* FinishSearch(const CnnLoop& new_loop,
+                          const SearchResult& final_result);
+    SearchResult SearchTilingSpace(const SearchContext& ctx,
+                                   const TilingCandidate& seed, Stationary s,
+                                   EncodedItr begin, EncodedItr end);
+    void MergeSearchResult(const SearchResult& from, SearchResult* to) const;
+    bool IsBranchAndBound(void) const;
+    bool IsAnytime(void) const;
+    bool IsMetaheuristic(void) const;
+    CnnLoop* MakeFinalLoop(const CnnLoop& loop,
+                           const SearchResult& result) const;
+    void InsertParetoPoint(const ParetoPoint& point,
+                           vector<ParetoPoint>* frontier) const;
+    bool IsDominated(const ParetoPoint& a, const ParetoPoint& b) const;
+    void MakeParetoPoint( const SearchContext& ctx, Stationary s,
+                          const SearchResult& result,
+                          ParetoPoint* point) const;
+    void ResetThreadResults(void);
+    void SearchDecodedChunk(const SearchContext& ctx,
+                            const TilingCandidate& seed, Stationary s,
+                            unsigned int thr, const SearchChunk& chunk,
+                            SearchResult* best);
+    void SearchGrayCodeChunk( const SearchContext& ctx,
+                              const TilingCandidate& seed, Stationary s,
+                              unsigned int thr, const SearchChunk& chunk,
+                              SearchResult* best);
+    void FillCostBlock( const SearchContext& ctx, const TilingCandidate& seed,
+                        int run, int lane_cnt, TilingCursor* cursor,
+                        CostBlock* block) const;
+    void SearchCostBlock( const SearchContext& ctx, Stationary s,
+                          unsigned int thr, TilingCursor* cursor,
+                          CostBlock* block, SearchResult* best);
+    void InitCostKernel(const SearchContext& ctx, Stationary s);
+    void UpdateSearchResult(const SearchContext& ctx, Stationary s,
+                            unsigned int thr, const SearchResult& result,
+                            SearchResult* best);
+    void SetCandidateTile(const SearchContext& ctx,
+                          const TilingCandidate& seed,
+                          DataDimension d, int tile,
+                          TilingCandidate* cand) const;
+    EncodedItr GetItrCnt(DataDimension d) const;
+    EncodedItr GetItrRadix(DataDimension d) const;
+    void ReportLoadBalance(void) const;
+
+    SearchContext MakeSearchContext(const VariableSet& varset,
+                                    const Architecture& arch) const;
+    TilingCandidate MakeTilingCandidate(const VariableSet& varset) const;
+    VariableSet* MakeVariableSet(const VariableSet& varset,
+                                 const TilingCandidate& cand) const;
+    void DecodeTilingCandidate( const TilingCandidate& seed,
+                                const SearchContext& ctx,
+                                EncodedItr it, TilingCandidate* cand) const;
+    void SeekTilingCursor(const SearchContext& ctx,
+                          const TilingCandidate& seed, EncodedItr rank,
+                          TilingCursor* cursor) const;
+    void StepTilingCursor(const SearchContext& ctx,
+                          const TilingCandidate& seed,
+                          TilingCursor* cursor) const;
+    bool IsUnrollDimension(const SearchContext& ctx, DataDimension d) const;
+    void BuildTileSpace(const SearchContext& ctx, const TilingCandidate& seed);
+    void BuildTileClasses(const SearchContext& ctx, DataDimension d,
+                          int min_tile, vector<int>* tiles) const;
 
     // EDP: Energy-Delay Product
-    double GetEdp(const CnnLoop& loop, 
-                  const Architecture& arch, Stationary s) const;
+    double GetEdp(const SearchContext& ctx, 
+                  const TilingCandidate& cand, Stationary s) const;
+    double GetEdpLowerBound(const SearchContext& ctx,
+                            const TilingCandidate& max_cand,
+                            Stationary s) const;
+    double CalcEdp(const SearchContext& ctx,
+                   long int dram_accesses, double pe_util) const;
+    double CalcPerformance( const SearchContext& ctx,
+                            long int dram_accesses, double pe_util) const;
+    long int GetNumOps(const SearchContext& ctx) const;
+    long int GetOnChipBytes(const SearchContext& ctx,
+                            const TilingCandidate& cand) const;
+    double GetSearchEdp(const SearchContext& ctx, const TilingCandidate& cand,
+                        Stationary s, int* order) const;
+    double GetBestOrderEdp( const SearchContext& ctx, const int* quot,
+                            double pe_util, int* order) const;
+    double GetBestOrderEdpLowerBound( const SearchContext& ctx,
+                                      const TilingCandidate& min_cand,
+                                      const TilingCandidate& max_cand) const;
+    void GetTileQuotients(const SearchContext& ctx,
+                          const TilingCandidate& cand, int* quot) const;
+    void GetFullyTiled(const int* quot, bool* fully_tiled) const;
+    int GetStationaryFlags( const loop::Type* order, const bool* may_full,
+                            const bool* must_full) const;
+    long int GetOrderDramAccesses(const SearchContext& ctx,
+                                  const int* quot, int flags,
+                                  long int* data_bytes=nullptr) const;
+    Structure* MakeLoopOrder(int order) const;
+    double GetOnChipAccessEnergy( const VariableSet& varset,
+                                  const Architecture& arch,
+                                  const loop::Type* order) const;
 
-    long int GetDramAccesses(const VariableSet& varset, Stationary s) const;
-    int GetInputDataReload(const VariableSet& varset, Stationary s) const;
-    int GetWeightDataReload(const VariableSet& varset, Stationary s) const;
-    int GetOutputDataReload(const VariableSet& varset, Stationary s) const;
-    int GetPsumReload(const VariableSet& varset, Stationary s) const;
-    int GetPsumStore(const VariableSet& varset, Stationary s) const;
+    long int GetDramAccesses( const SearchContext& ctx,
+                              const TilingCandidate& cand, Stationary s,
+                              long int* data_bytes=nullptr) const;
 
-    double GetPeUtil(const VariableSet& varset, const Architecture& arch) const;
+    double GetPeUtil(const SearchContext& ctx,
+                     const TilingCandidate& cand) const;
     double GetParamUtil(int tile_param, const int unroll_param) const;
+    double GetArraysPeUtil( const SearchContext& ctx,
+                            const TilingCandidate& cand,
+                            ArrayPartition* part) const;
+    void MakeParlLoopVariables( const SearchContext& ctx, int array,
+                                TilingCandidate* cand) const;
+    int GetRemainFactors( const SearchContext& ctx, int array, int r_c,
+                          int pe_len, int* factors) const;
     
     bool IsMemorySizeOverflow(const VariableSet& varset,
                               const Architecture& arch) const;
+    bool IsMemorySizeOverflow(const SearchContext& ctx,
+                              const TilingCandidate& cand) const;
+    bool IsMemorySizeOverflowBound( const SearchContext& ctx,
+                                    const TilingCandidate& min_cand) const;
+
+    long int GetInputSize(const SearchContext& ctx, const int* vars) const;
+    long int GetWeightSize(const int* vars) const;
+    long int GetOutputSize(const int* vars) const;
 
     int GreatestCommonDivisor(int a, int b) const;
-    vector<int> PrimeFactorization(int a);
 };
 } // namespace loop
 #endif
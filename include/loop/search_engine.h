@@ -0,0 +1,130 @@
+#ifndef CNNPLANNER_LOOP_SEARCH_ENGINE_H_
+#define CNNPLANNER_LOOP_SEARCH_ENGINE_H_
+
+#include <stdint.h>
+#include <functional>
+#include <vector>
+
+#include "loop/tiling_candidate.h"
+
+using std::function;
+using std::vector;
+
+namespace loop {
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Tiling space seen by a search engine.
+//! @details    A tiling is a digit per tiled dimension in the encoding order
+//!             of the scheduler, from the least significant. Digit i picks
+//!             one of GetRadix(i) tile sizes in ascending order, so smaller
+//!             digits never need more on-chip memory.
+////////////////////////////////////////////////////////////////////////////////
+class TilingSpace
+{
+  public:
+    virtual ~TilingSpace() {}
+    //! @brief          Return the number of tile sizes of a digit.
+    //! @param digit    Digit index from the least significant.
+    virtual int GetRadix(int digit) const = 0;
+    //! @brief          Evaluate a tiling.
+    //! @details        Thread safe for distinct thr.
+    //! @param thr      Worker index below the engine's thread count.
+    //! @param digit    kTileDimensionCnt digits.
+    //! @param result   Candidate, EDP, encoded iteration and loop order.
+    //! @return         False if the tiling overflows on-chip memory.
+    virtual bool Evaluate(unsigned int thr, const int* digit,
+                          SearchResult* result) = 0;
+    //! @brief          Bound every tiling whose lower digits are free.
+    //! @details        Free digits take any tile size. Thread safe.
+    //! @param digit    kTileDimensionCnt digits. Free digits are not read.
+    //! @param free_cnt The number of free digits from the least significant.
+    //! @param bound    EDP lower bound of the tilings.
+    //! @return         False if none of the tilings fits on-chip memory.
+    virtual bool Bound(const int* digit, int free_cnt, double* bound) const = 0;
+    //! @brief          Return the digits of the tiling at a traversal rank.
+    //! @details        Ranks start from 1 and follow EvaluateRange. Tilings
+    //!                 sharing their upper digits have contiguous ranks.
+    //! @param rank     Traversal rank.
+    //! @param digit    kTileDimensionCnt digits.
+    virtual void GetRankDigits(EncodedItr rank, int* digit) const = 0;
+    //! @brief          Evaluate the tilings of ranks [first, last].
+    //! @details        Thread safe for distinct thr.
+    //! @param thr      Worker index below the engine's thread count.
+    //! @param best     Best fitting tiling so far. Updated in place.
+    virtual void EvaluateRange( unsigned int thr, EncodedItr first,
+                                EncodedItr last, SearchResult* best) = 0;
+};
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Pluggable search strategy of the tiling space.
+//! @details    Engines merge worker results with the scheduler's tie rule.
+//!             Random engines split their work into a fixed number of
+//!             independent jobs, each with its own random stream drawn from
+//!             the seed, so the result only depends on the seed and the
+//!             evaluation budget, not on the number of threads.
+////////////////////////////////////////////////////////////////////////////////
+class SearchEngine
+{
+  public:
+    virtual ~SearchEngine() {}
+    //! @brief              Search the best tiling.
+    //! @param space        Tiling space of the layer.
+    //! @param num_threads  The number of worker threads.
+    //! @return             Best tiling found. edp is DBL_MAX if none fits.
+    virtual SearchResult Search(TilingSpace* space,
+                                unsigned int num_threads) = 0;
+    //! @brief              Set the random seed.
+    void SetSeed(uint64_t seed) { seed_ = seed; }
+    //! @brief              Set the number of evaluations of a search.
+    void SetEvaluations(EncodedItr eval_cnt) { eval_cnt_ = eval_cnt; }
+    //! @brief              Return busy time of each worker (msec).
+    const vector<double>& GetBusyTime(void) const { return busy_time_; }
+    //! @brief              Return chunks stolen by each worker.
+    const vector<size_t>& GetStealCnt(void) const { return steal_cnt_; }
+    //! @brief              Return tilings pruned by each worker.
+    const vector<EncodedItr>& GetPruneCnt(void) const { return prune_cnt_; }
+    //! @brief              Return coverage of the last search.
+    //! @return             Evaluated or proven infeasible tilings over all
+    //!                     tilings.
+    virtual double GetCoverage(void) const { return 1.0; }
+    //! @brief              Return optimality gap of the last search.
+    //! @return             (EDP - lower bound) / EDP. 0 if the space is
+    //!                     covered.
+    virtual double GetOptimalityGap(void) const { return 0.0; }
+
+  protected:
+    uint64_t seed_ = 1;
+    EncodedItr eval_cnt_ = 1 << 18;
+    vector<double> busy_time_;      // msec
+    vector<size_t> steal_cnt_;
+    vector<EncodedItr> prune_cnt_;
+
+    //! @brief              Clear the statistics of the workers.
+    void ResetStats(unsigned int num_threads);
+    //! @brief              Run jobs [0, job_cnt) on worker threads.
+    void RunJobs( unsigned int num_threads, int job_cnt,
+                  const function<void(unsigned int, int)>& job);
+    //! @brief              Return the number of tilings.
+    static EncodedItr CountTilings(const TilingSpace& space);
+    //! @brief              Return the number of tilings per step of a digit.
+    static EncodedItr GetDigitWeight(const TilingSpace& space, int digit);
+    //! @brief              Seed of the random stream of a job.
+    uint64_t GetJobSeed(int job) const;
+    //! @brief              Keep the better result. Ties go to the larger
+    //!                     encoded iteration like the exhaustive search.
+    static void MergeResult(const SearchResult& from, SearchResult* to);
+    //! @brief              Make every digit random.
+    static void RandomizeDigits(const TilingSpace& space, uint64_t* rng_state,
+                                int* digit);
+    //! @brief              Shrink random digits until the tiling fits.
+    //! @return             False if it does not fit in max_try evaluations.
+    static bool RepairDigits( TilingSpace* space, unsigned int thr,
+                              uint64_t* rng_state, int max_try, int* digit,
+                              SearchResult* result, EncodedItr* eval_cnt);
+    //! @brief              Next 64 random bits (splitmix64).
+    static uint64_t NextRandom(uint64_t* rng_state);
+    //! @brief              Uniform random integer in [0, n).
+    static int NextRandomInt(uint64_t* rng_state, int n);
+    //! @brief              Uniform random double in [0, 1).
+    static double NextRandomDouble(uint64_t* rng_state);
+};
+} // namespace loop
+#endif
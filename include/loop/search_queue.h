@@ -0,0 +1,48 @@
+#ifndef CNNPLANNER_LOOP_SEARCH_QUEUE_H_
+#define CNNPLANNER_LOOP_SEARCH_QUEUE_H_
+
+#include <deque>
+#include <mutex>
+#include <utility>
+
+#include "loop/tiling_candidate.h"
+
+using std::deque;
+using std::mutex;
+using std::pair;
+
+namespace loop {
+//! @brief  Block of encoded tiling iterations, [first, second] inclusive.
+typedef pair<EncodedItr, EncodedItr> SearchChunk;
+//! @brief  Chunk whose outer tiles are fixed, with the EDP lower bound of
+//!         every tiling in it.
+typedef pair<SearchChunk, double> SearchRegion;
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Per-thread job queue of the tiling search.
+//! @details    The owner thread pops chunks from the front, and idle threads
+//!             steal chunks from the back. So the owner walks its own range
+//!             contiguously while thieves take the farthest work.
+////////////////////////////////////////////////////////////////////////////////
+class SearchQueue
+{
+  public:
+    //! @brief          Push a chunk at the back of the queue.
+    //! @param chunk    Encoded iteration block.
+    void Push(const SearchChunk& chunk);
+    //! @brief          Pop a chunk from the front. Called by the owner.
+    //! @param chunk    Popped chunk. Unchanged if the queue is empty.
+    //! @return         False if the queue is empty.
+    bool Pop(SearchChunk* chunk);
+    //! @brief          Steal a chunk from the back. Called by other threads.
+    //! @param chunk    Stolen chunk. Unchanged if the queue is empty.
+    //! @return         False if the queue is empty.
+    bool Steal(SearchChunk* chunk);
+    //! @brief          Remove every remaining chunk.
+    void Clear(void);
+
+  private:
+    deque<SearchChunk> chunks_;
+    mutex mtx_lock_;
+};
+} // namespace loop
+#endif
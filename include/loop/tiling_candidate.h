@@ -0,0 +1,144 @@
+#ifndef CNNPLANNER_LOOP_TILING_CANDIDATE_H_
+#define CNNPLANNER_LOOP_TILING_CANDIDATE_H_
+
+#include <stdint.h>
+#include <iostream>
+
+#include "arch/architecture.h"
+
+using std::istream;
+using std::ostream;
+
+using arch::DataDimension;
+
+namespace loop {
+//! @brief  Encoded tiling iteration. 64 bits regardless of the platform.
+typedef uint64_t EncodedItr;
+//! @brief  The number of DataDimension entries including None.
+const int kDimensionCnt = DataDimension::N + 1;
+//! @brief  Upper bound of the PE dimensions mapped on one side of PE array.
+const int kMaxPeStructureLen = kDimensionCnt;
+//! @brief  Upper bound of the prime factors of an int.
+const int kMaxPrimeFactorCnt = 32;
+//! @brief  The number of tiled dimensions in the encoded iteration.
+const int kTileDimensionCnt = 7;
+//! @brief  Upper bound of the PE arrays of an accelerator.
+const int kMaxPeArrayCnt = 8;
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Plain-old-data tiling candidate.
+//! @details    Search threads decode, evaluate and keep candidates on the
+//!             stack. CnnLoop is materialized only for the final winner.
+//!             Both arrays are indexed by DataDimension.
+////////////////////////////////////////////////////////////////////////////////
+struct TilingCandidate
+{
+  int tile[kDimensionCnt];  // On-chip loop variables.
+  int parl[kDimensionCnt];  // Parallelization loop variables.
+};
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Plain-old-data layer shape and hardware constants.
+//! @details    Copied once per search so the cost functions never touch
+//!             vectors returned by value from Architecture.
+////////////////////////////////////////////////////////////////////////////////
+struct SearchContext
+{
+  int dim[kDimensionCnt];   // Off-chip loop variables indexed by DataDimension.
+  int stride;
+  int pad_width;
+  int pad_height;
+  int group_oc;             // Output channels of a group.
+  int groups;               // Groups spanned by the output channels.
+
+  long int input_mem_size;  // Bytes
+  long int weight_mem_size; // Bytes
+  long int output_mem_size; // Bytes
+  double frequency;
+  double bandwidth;
+
+  int pe_array_cnt;                               // The number of PE arrays.
+  long int num_pe;                                // PEs of every array.
+  int pe_len[kMaxPeArrayCnt][2];                  // PE row/column length.
+  int pe_strt_len[2];                             // Mapped dimension count.
+  DataDimension pe_strt[2][kMaxPeStructureLen];   // PE calculation mapping.
+  int pe_factor_cnt[kMaxPeArrayCnt][2];           // Prime factors of pe_len
+  int pe_factors[kMaxPeArrayCnt][2][kMaxPrimeFactorCnt]; // in ascending order.
+  int pe_mapped_len[kDimensionCnt]; // Product of the first array's PE sides
+                                    // mapping a dimension.
+};
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Split of an on-chip tile over the PE arrays.
+//! @details    Every array runs the same PE calculation mapping on its own
+//!             share of one dimension of the tile, so a tile finishes when
+//!             the slowest array does.
+////////////////////////////////////////////////////////////////////////////////
+struct ArrayPartition
+{
+  DataDimension dim;            // Split dimension. OC or OH.
+  int share[kMaxPeArrayCnt];    // Length of dim computed by each array.
+  long int cycles;              // Cycles of the slowest array per tile.
+};
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Best candidate found by a part of the search.
+//! @details    Ties on EDP are broken by the larger encoded iteration, so
+//!             merging results in any order gives the same winner.
+////////////////////////////////////////////////////////////////////////////////
+struct SearchResult
+{
+  TilingCandidate cand;
+  double edp;       // DBL_MAX if no feasible candidate is found.
+  EncodedItr itr;       // Encoded iteration of cand. 0 if nothing is found.
+  int order;        // Off-chip loop order of cand. -1 for the heuristic.
+};
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Best candidate of encoded iterations [begin, end].
+//! @details    Written and read by the stream operators below, so a shard
+//!             searched by another process can be merged. EDP is written
+//!             with 17 digits to read back the same double.
+////////////////////////////////////////////////////////////////////////////////
+struct ShardResult
+{
+  EncodedItr begin;
+  EncodedItr end;
+  EncodedItr total; // Size of the whole tiling space of the layer.
+  SearchResult result;
+};
+//! @brief          Write a shard result as one line of text.
+ostream& operator<<(ostream& os, const ShardResult& shard);
+//! @brief          Read a shard result written by operator<<.
+//! @details        Sets failbit if the line is not a shard result.
+istream& operator>>(istream& is, ShardResult& shard);
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Position of a mixed-radix Gray code walk over the tiling space.
+//! @details    Digits are indexed by the encoding order from the least
+//!             significant. Each step moves one digit by one, so the cursor
+//!             keeps the reload quotients and the PE utilization of cand and
+//!             only recomputes what the moved tile changes.
+////////////////////////////////////////////////////////////////////////////////
+struct TilingCursor
+{
+  TilingCandidate cand;
+  EncodedItr itr;                     // Encoded iteration of cand.
+  int digit[kTileDimensionCnt];   // Tile index of each encoded dimension.
+  int dir[kTileDimensionCnt];     // Next move of each digit. +1 or -1.
+  int quot[kDimensionCnt];        // ceil(dim/tile) indexed by DataDimension.
+  double pe_util;
+  bool is_parl_valid;             // False if cand.parl and pe_util are stale.
+};
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Non-dominated point of the tiling search.
+//! @details    Every objective is minimized. DRAM energy is proportional to
+//!             dram_bytes, so bytes are kept instead of a specific energy.
+////////////////////////////////////////////////////////////////////////////////
+struct ParetoPoint
+{
+  SearchResult result;
+  double latency;         // Estimated latency (ns).
+  long int dram_bytes;    // Off-chip accesses (Bytes).
+  long int on_chip_bytes; // Buffer footprint including double buffering.
+  long int data_bytes[3]; // Off-chip accesses of each Stationary data.
+                          // Output accesses include partial sums.
+  long int output_buf_bytes;  // Output buffer footprint.
+  double pe_util;
+};
+} // namespace loop
+#endif
@@ -69,6 +69,15 @@ class VariableSet
     //! @brief                Set output channel value.
     //! @param output_channel Output channel value
     void SetOc(const int output_channel);
+    //! @brief                Set batch size.
+    //! @param batch          Batch size
+    void SetN(const int batch);
+    //! @brief                Set groups of convolution.
+    //! @details              Input channel is the input channels of a group,
+    //!                       which is the reduction length of an output.
+    //!                       Output channel must be set first.
+    //! @param groups         Number of channel groups.
+    void SetGroups(const int groups);
 
     //! @brief                    Set tile input width value.
     //! @param tile_input_width   Tile input width value.
@@ -96,6 +105,9 @@ class VariableSet
     //! @brief                      Set tile output channel value.
     //! @param tile_output_channel  Tile output channel value.
     void SetToc(const int tile_output_channel);
+    //! @brief                      Set tile batch size.
+    //! @param tile_batch           Tile batch size.
+    void SetTn(const int tile_batch);
 
     //! @brief                          Set unroll input width value.
     //! @param parallel_input_width     Unroll input width value.
@@ -123,6 +135,9 @@ class VariableSet
     //! @brief                          Set unroll output channel value.
     //! @param parallel_output_channel  Unroll output channel value.
     void SetPoc(const int parallel_output_channel);
+    //! @brief                          Set unroll batch size.
+    //! @param parallel_batch           Unroll batch size.
+    void SetPn(const int parallel_batch);
 
     //! @brief                  Set off-chip loop variables data which provides interface between off-chip and on-chip.
     //! @param off_loop_vars    Off-chip loop parameters.
@@ -133,6 +148,19 @@ class VariableSet
     //! @brief                  Set parallelizaion loop variables data.
     //! @param parl_loop_vars   Parallelizaion loop parameters.
     void SetParlLoopVariables(loop::Variables parl_loop_vars);
+    //! @brief                  Set tiles of on-chip memory levels above PE-local memory.
+    //! @details                Off-chip loop variables contain the first tile,
+    //!                         each tile contains the next one, and the last
+    //!                         tile contains on-chip loop variables.
+    //! @param level_loop_vars  Tile of each memory level, outermost first.
+    void SetLevelLoopVariables(const vector<loop::Variables>& level_loop_vars);
+    //! @brief                  Set the share of the on-chip tile of each PE array.
+    //! @details                An idle array has a share of length 0 along
+    //!                         the split dimension.
+    //! @param array_loop_vars  Share of each PE array.
+    //! @param array_parl_vars  Unrolling of each PE array.
+    void SetArrayLoopVariables(const vector<loop::Variables>& array_loop_vars,
+                               const vector<loop::Variables>& array_parl_vars);
 
     //! @brief  Return stride value.
     //! @return Stride value.
@@ -171,6 +199,15 @@ class VariableSet
     //! @brief  Return output channel value.
     //! @return Output channel value.
     int GetOc(void) const;
+    //! @brief  Return batch size.
+    //! @return Batch size.
+    int GetN(void) const;
+    //! @brief  Return groups of convolution.
+    //! @return Number of channel groups.
+    int GetGroups(void) const;
+    //! @brief  Return output channels of a group.
+    //! @return Output channels of a group.
+    int GetGroupOc(void) const;
 
     //! @brief  Return tile input width value.
     //! @return Tile input width value.
@@ -198,6 +235,9 @@ class VariableSet
     //! @brief  Return tile output channel value.
     //! @return Tile output channel value.
     int GetToc(void) const;
+    //! @brief  Return tile batch size.
+    //! @return Tile batch size.
+    int GetTn(void) const;
 
     //! @brief  Return unroll input width value.
     //! @return Untoll input width value.
@@ -225,6 +265,9 @@ class VariableSet
     //! @brief  Return unroll output channel value.
     //! @return Untoll output channel value.
     int GetPoc(void) const;
+    //! @brief  Return unroll batch size.
+    //! @return Unroll batch size.
+    int GetPn(void) const;
 
     //! @brief  Return off-chip loop variables which provides interface between off-chip and on-chip.
     //! @return Off-chip loop variables
@@ -235,6 +278,16 @@ class VariableSet
     //! @brief  Return parallelization loop variables.
     //! @return Parallelization loop variables
     const loop::Variables& GetParlLoopVariables(void) const;
+    //! @brief  Return tiles of on-chip memory levels above PE-local memory.
+    //! @return Tile of each memory level, outermost first. Empty if PE-local
+    //!         memory is the only level.
+    const vector<loop::Variables>& GetLevelLoopVariables(void) const;
+    //! @brief  Return the share of the on-chip tile of each PE array.
+    //! @return Share of each PE array. Empty if there is one PE array.
+    const vector<loop::Variables>& GetArrayLoopVariables(void) const;
+    //! @brief  Return unrolling of each PE array.
+    //! @return Unrolling of each PE array. Empty if there is one PE array.
+    const vector<loop::Variables>& GetArrayParlLoopVariables(void) const;
 
     /*
     //! @brief            Dump tiling factor.
@@ -242,6 +295,13 @@ class VariableSet
     void DumpTilingFactor(const char* dump_file);
     */
 
+    //! @brief      Return input size which a tile of the layer reads.
+    //! @details    A tile of output channels reads the input channels of
+    //!             every group it spans.
+    //! @param vars Loop variables of the tile.
+    //! @return     Input size of the tile.
+    long int GetInputSize(const loop::Variables& vars) const;
+
     //! @brief  Check loop structure validation.
     void CheckValid(void) const;
 
@@ -249,6 +309,11 @@ class VariableSet
     loop::Variables off_loop_vars_;
     loop::Variables on_loop_vars_;
     loop::Variables parl_loop_vars_;
+    vector<loop::Variables> level_loop_vars_;
+    vector<loop::Variables> array_loop_vars_;
+    vector<loop::Variables> array_parl_vars_;
+    int groups_ = 1;
+    int group_oc_ = NON_VALID;  // Output channels of a group.
 
     void CheckVariablesRange( const loop::Variables& upper, 
                               const loop::Variables& lower) const;
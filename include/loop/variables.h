@@ -20,6 +20,7 @@ namespace loop{
 //!             OW: Output Width<br>
 //!             OH: Output Height<br>
 //!             OC: Output Channel<br>
+//!             N: Batch<br>
 //!             T: Tiled<br>
 //!             P: Parallel
 //! @author     Minsu Kim
@@ -62,6 +63,10 @@ class Variables
     //! @param output_channel Output channel value
     void SetOc(const int output_channel);
 
+    //! @brief          Set batch size.
+    //! @param batch    Batch size
+    void SetN(const int batch);
+
     //! @brief          Set stride value.
     //! @param stride   Stride value
     void SetStride(const int stride);
@@ -100,6 +105,10 @@ class Variables
     //! @return Output channel value.
     int GetOc(void) const;
 
+    //! @brief  Return batch size.
+    //! @return Batch size.
+    int GetN(void) const;
+
     //! @brief  Return stride value.
     //! @return Stride value.
     int GetStride(void) const;
@@ -140,6 +149,8 @@ class Variables
     int output_height_ = NON_VALID;
     int output_channel_ = NON_VALID;
 
+    int batch_ = 1; // Single image unless the layer is batched.
+
     int stride_ = NON_VALID;
 };
 //! @brief        Overload ostream operator <<.
@@ -48,6 +48,82 @@ class CompilerParameter : public parameter::Parameter
     //!                     tiling and loop structure are read from dump file.
     void SetPreScheduled(const bool pre_sched)
       { pre_sched_ = pre_sched; }
+    //! @brief              Set tiling search mode.
+    //! @param search_mode  Search mode name (e.g. exhaustive, bnb).
+    void SetSearchMode(const char* search_mode)
+      { strncpy(search_mode_, search_mode, STR_LEN); }
+    //! @brief              Set tile size enumeration.
+    //! @param tile_enum    Tile enumeration name (e.g. full, class).
+    void SetTileEnumeration(const char* tile_enum)
+      { strncpy(tile_enum_, tile_enum, STR_LEN); }
+    //! @brief              Set off-chip loop order search.
+    //! @param loop_order   Loop order search name (e.g. heuristic, all).
+    void SetLoopOrder(const char* loop_order)
+      { strncpy(loop_order_, loop_order, STR_LEN); }
+    //! @brief              Set intra loop order search.
+    //! @param intra_order  Intra loop order search name (e.g. fixed, all).
+    void SetIntraLoopOrder(const char* intra_order)
+      { strncpy(intra_loop_order_, intra_order, STR_LEN); }
+    //! @brief              Set tiling space traversal.
+    //! @param traversal    Tile traversal name (e.g. gray, decode).
+    void SetTileTraversal(const char* traversal)
+      { strncpy(tile_traversal_, traversal, STR_LEN); }
+    //! @brief              Set path of Pareto frontier dump file.
+    //! @param file_path    Pareto frontier CSV path. Empty to disable.
+    void SetParetoDumpFile(const char* file_path)
+      { strncpy(pareto_dump_file_, file_path, STR_LEN); }
+    //! @brief              Set the part of the tiling space to search.
+    //! @param shard        "<i>/<n>" for the i-th of n shards from 0.
+    void SetSearchShard(const char* shard)
+      { strncpy(search_shard_, shard, STR_LEN); }
+    //! @brief              Set path of shard result dump file.
+    //! @param file_path    Shard result path.
+    void SetShardDumpFile(const char* file_path)
+      { strncpy(shard_dump_file_, file_path, STR_LEN); }
+    //! @brief              Set path of shard results to merge.
+    //! @param file_path    Concatenated shard result dumps.
+    void SetShardMergeFile(const char* file_path)
+      { strncpy(shard_merge_file_, file_path, STR_LEN); }
+    //! @brief              Set path of persistent schedule cache.
+    //! @param file_path    Schedule cache path. Empty to disable.
+    void SetScheduleCacheFile(const char* file_path)
+      { strncpy(schedule_cache_file_, file_path, STR_LEN); }
+    //! @brief              Set wall-clock budget of the tiling search.
+    //! @param budget_ms    Search budget (msec). 0 for no limit.
+    void SetSearchBudget(const double budget_ms)
+      { search_budget_ms_ = budget_ms; }
+    //! @brief              Set random seed of the search engines.
+    //! @param seed         Random seed.
+    void SetSearchSeed(const long int seed) { search_seed_ = seed; }
+    //! @brief              Set evaluation budget of the search engines.
+    //! @param eval_cnt     Tilings evaluated by a search.
+    void SetSearchEvaluations(const long int eval_cnt)
+      { search_eval_cnt_ = eval_cnt; }
+    //! @brief              Set layers fused after the compiled layer.
+    //! @param fused_layers Comma separated layers. Empty to disable.
+    void SetFusedLayers(const char* fused_layers)
+      { strncpy(fused_layers_, fused_layers, STR_LEN); }
+    //! @brief              Set tensor layout of generated simulation code.
+    //! @param sim_layout   Layout name (e.g. nchw, blocked).
+    void SetSimLayout(const char* sim_layout)
+      { strncpy(sim_layout_, sim_layout, STR_LEN); }
+    //! @brief              Whether simulation code only models timing.
+    //! @param timing_only  If timing_only flag is true, generated code skips
+    //!                     test data and MAC computation.
+    void SetTimingOnly(const bool timing_only) { timing_only_ = timing_only; }
+    //! @brief              Whether the compiler simulates the schedule.
+    //! @param native_sim   If native_sim flag is true, latency and timestamp
+    //!                     files are written without the simulation binary.
+    void SetNativeSim(const bool native_sim) { native_sim_ = native_sim; }
+    //! @brief              Whether simulation code computes in parallel.
+    //! @param sim_openmp   If sim_openmp flag is true, MAC computation of
+    //!                     generated code is parallelized with OpenMP.
+    void SetSimOpenmp(const bool sim_openmp) { sim_openmp_ = sim_openmp; }
+    //! @brief              Set path of simulation binary arguments.
+    //! @param file_path    Arguments path. Empty to keep tile constants in
+    //!                     the generated code.
+    void SetSimArgsFile(const char* file_path)
+      { strncpy(sim_args_file_, file_path, STR_LEN); }
 
     /**************************************************************************/
     //                               GETTER                                   //
@@ -64,6 +140,64 @@ class CompilerParameter : public parameter::Parameter
     //! @brief              Return pre_sched_ flag.
     //! @return             pre_sched_ flag.
     const bool GetPreScheduled(void) const { return pre_sched_; }
+    //! @brief              Return tiling search mode.
+    //! @return             Search mode name.
+    const char* GetSearchMode(void) const { return search_mode_; }
+    //! @brief              Return tile size enumeration.
+    //! @return             Tile enumeration name.
+    const char* GetTileEnumeration(void) const { return tile_enum_; }
+    //! @brief              Return off-chip loop order search.
+    //! @return             Loop order search name.
+    const char* GetLoopOrder(void) const { return loop_order_; }
+    //! @brief              Return intra loop order search.
+    //! @return             Intra loop order search name.
+    const char* GetIntraLoopOrder(void) const { return intra_loop_order_; }
+    //! @brief              Return tiling space traversal.
+    //! @return             Tile traversal name.
+    const char* GetTileTraversal(void) const { return tile_traversal_; }
+    //! @brief              Return Pareto frontier dump file path.
+    //! @return             Pareto frontier CSV path.
+    const char* GetParetoDumpFile(void) const { return pareto_dump_file_; }
+    //! @brief              Return the part of the tiling space to search.
+    //! @return             "<i>/<n>", or empty for the whole space.
+    const char* GetSearchShard(void) const { return search_shard_; }
+    //! @brief              Return shard result dump file path.
+    //! @return             Shard result path.
+    const char* GetShardDumpFile(void) const { return shard_dump_file_; }
+    //! @brief              Return path of shard results to merge.
+    //! @return             Concatenated shard result dumps.
+    const char* GetShardMergeFile(void) const { return shard_merge_file_; }
+    //! @brief              Return persistent schedule cache path.
+    //! @return             Schedule cache path.
+    const char* GetScheduleCacheFile(void) const
+      { return schedule_cache_file_; }
+    //! @brief              Return wall-clock budget of the tiling search.
+    //! @return             Search budget (msec).
+    double GetSearchBudget(void) const { return search_budget_ms_; }
+    //! @brief              Return random seed of the search engines.
+    //! @return             Random seed.
+    long int GetSearchSeed(void) const { return search_seed_; }
+    //! @brief              Return evaluation budget of the search engines.
+    //! @return             Tilings evaluated by a search.
+    long int GetSearchEvaluations(void) const { return search_eval_cnt_; }
+    //! @brief              Return layers fused after the compiled layer.
+    //! @return             Comma separated layers.
+    const char* GetFusedLayers(void) const { return fused_layers_; }
+    //! @brief              Return tensor layout of generated simulation code.
+    //! @return             Layout name.
+    const char* GetSimLayout(void) const { return sim_layout_; }
+    //! @brief              Return timing_only_ flag.
+    //! @return             timing_only_ flag.
+    bool GetTimingOnly(void) const { return timing_only_; }
+    //! @brief              Return native_sim_ flag.
+    //! @return             native_sim_ flag.
+    bool GetNativeSim(void) const { return native_sim_; }
+    //! @brief              Return sim_openmp_ flag.
+    //! @return             sim_openmp_ flag.
+    bool GetSimOpenmp(void) const { return sim_openmp_; }
+    //! @brief              Return simulation binary arguments path.
+    //! @return             Simulation binary arguments path.
+    const char* GetSimArgsFile(void) const { return sim_args_file_; }
 
   private:
     char code_file_[STR_LEN] = "";
@@ -71,6 +205,25 @@ class CompilerParameter : public parameter::Parameter
     char timestamp_file_[STR_LEN] = "";
 
     bool pre_sched_ = false;
+    char search_mode_[STR_LEN] = "exhaustive";
+    char tile_enum_[STR_LEN] = "full";
+    char loop_order_[STR_LEN] = "all";
+    char intra_loop_order_[STR_LEN] = "all";
+    char tile_traversal_[STR_LEN] = "gray";
+    char pareto_dump_file_[STR_LEN] = "";
+    char search_shard_[STR_LEN] = "";
+    char shard_dump_file_[STR_LEN] = "";
+    char shard_merge_file_[STR_LEN] = "";
+    char schedule_cache_file_[STR_LEN] = "";
+    double search_budget_ms_ = 0.0;
+    long int search_seed_ = 1;
+    long int search_eval_cnt_ = 1 << 18;
+    char fused_layers_[STR_LEN] = "";
+    char sim_layout_[STR_LEN] = "nchw";
+    bool timing_only_ = false;
+    bool native_sim_ = false;
+    bool sim_openmp_ = false;
+    char sim_args_file_[STR_LEN] = "";
 };
 } // namespace parameter
 #endif
\ No newline at end of file
@@ -18,6 +18,8 @@ const struct option c_options[] { // compiler options
   {"kw",              1, 0, 0},
   {"kh",              1, 0, 0},
   {"oc",              1, 0, 0},
+  {"batch",           1, 0, 0},
+  {"groups",          1, 0, 0},
   {"mac-cycles",      1, 0, 0},
   {"frequency",       1, 0, 0},
   {"bandwidth",       1, 0, 0},
@@ -26,6 +28,7 @@ const struct option c_options[] { // compiler options
   {"output-mem-size", 1, 0, 0},
   {"pe-dim",          1, 0, 0},
   {"pe-structure",    1, 0, 0},
+  {"mem-levels",      1, 0, 0},
   {"code-path",       1, 0, 0},
   {"gaia-path",       1, 0, 0},
   {"latency-path",    1, 0, 0},
@@ -33,6 +36,25 @@ const struct option c_options[] { // compiler options
   {"tiling-dump",     1, 0, 0},
   {"loop-seq-dump",   1, 0, 0},
   {"layer",           1, 0, 0},
+  {"search-mode",     1, 0, 0},
+  {"tile-enum",       1, 0, 0},
+  {"loop-order",      1, 0, 0},
+  {"intra-loop-order",1, 0, 0},
+  {"tile-traversal",  1, 0, 0},
+  {"pareto-dump",     1, 0, 0},
+  {"search-shard",    1, 0, 0},
+  {"shard-dump",      1, 0, 0},
+  {"shard-merge",     1, 0, 0},
+  {"schedule-cache",  1, 0, 0},
+  {"search-budget-ms", 1, 0, 0},
+  {"search-seed",     1, 0, 0},
+  {"search-evals",    1, 0, 0},
+  {"fuse",            1, 0, 0},
+  {"sim-layout",      1, 0, 0},
+  {"timing-only",     0, 0, 0},
+  {"native-sim",      0, 0, 0},
+  {"sim-openmp",      0, 0, 0},
+  {"sim-args-path",   1, 0, 0},
   {"help",            0, 0, 0},
   {0, 0, 0, 0} // terminate
 };
@@ -0,0 +1,52 @@
+#ifndef CNNPLANNER_PARAMETER_NETWORK_PARAMETER_H_
+#define CNNPLANNER_PARAMETER_NETWORK_PARAMETER_H_
+
+#include "parameter/profiler_parameter.h"
+
+#define STR_LEN 256
+
+namespace parameter {
+////////////////////////////////////////////////////////////////////////////////
+//! @brief    Parameters for network planner.
+//! @details  Layer shapes come from the network file, so only hardware
+//!           configurations and energies of ProfilerParameter are used.
+////////////////////////////////////////////////////////////////////////////////
+class NetworkParameter : public parameter::ProfilerParameter
+{
+  public:
+    /**************************************************************************/
+    //                               SETTER                                   //
+    /**************************************************************************/
+    //! @brief              Set path of network file.
+    //! @param file_path    Network file path.
+    void SetNetworkFile(const char* file_path)
+      { strncpy(network_file_, file_path, STR_LEN); }
+    //! @brief              Set tiling search mode of each layer.
+    //! @param search_mode  Search mode name (e.g. exhaustive, bnb).
+    void SetSearchMode(const char* search_mode)
+      { strncpy(search_mode_, search_mode, STR_LEN); }
+    //! @brief              Set objective of network planning.
+    //! @param objective    Objective name (e.g. latency, energy).
+    void SetObjective(const char* objective)
+      { strncpy(objective_, objective, STR_LEN); }
+
+    /**************************************************************************/
+    //                               GETTER                                   //
+    /**************************************************************************/
+    //! @brief              Return network file path.
+    //! @return             Network file path.
+    const char* GetNetworkFile(void) const { return network_file_; }
+    //! @brief              Return tiling search mode of each layer.
+    //! @return             Search mode name.
+    const char* GetSearchMode(void) const { return search_mode_; }
+    //! @brief              Return objective of network planning.
+    //! @return             Objective name.
+    const char* GetObjective(void) const { return objective_; }
+
+  private:
+    char network_file_[STR_LEN] = "";
+    char search_mode_[STR_LEN] = "exhaustive";
+    char objective_[STR_LEN] = "latency";
+};
+} // namespace parameter
+#endif
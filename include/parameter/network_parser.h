@@ -0,0 +1,49 @@
+#ifndef CNNPLANNER_PARAMETER_NETWORK_PARSER_H_
+#define CNNPLANNER_PARAMETER_NETWORK_PARSER_H_
+
+#include <getopt.h>
+
+#include "parameter/network_parameter.h"
+
+using parameter::NetworkParameter;
+
+namespace parameter {
+const struct option n_options[] { // network planner options
+  {"mac-cycles",        1, 0, 0},
+  {"frequency",         1, 0, 0},
+  {"bandwidth",         1, 0, 0},
+  {"mac-energy",        1, 0, 0},
+  {"on-chip-32-energy", 1, 0, 0},
+  {"off-chip-32-energy",1, 0, 0},
+  {"input-mem-size",    1, 0, 0},
+  {"weight-mem-size",   1, 0, 0},
+  {"output-mem-size",   1, 0, 0},
+  {"pe-dim",            1, 0, 0},
+  {"pe-structure",      1, 0, 0},
+  {"network",           1, 0, 0},
+  {"search-mode",       1, 0, 0},
+  {"objective",         1, 0, 0},
+  {"report-path",       1, 0, 0},
+  {"help",              0, 0, 0},
+  {0, 0, 0, 0} // terminate
+};
+////////////////////////////////////////////////////////////////////////////////
+//! @brief    Command line arguments parser for network planner.
+////////////////////////////////////////////////////////////////////////////////
+class NetworkParser
+{
+  public:
+    //! @brief    Parse and check parameter from argv.
+    //! @return   NetworkParameter object which includes arguments.
+    NetworkParameter* BuildParameter(int argc, char** argv);
+
+  private:
+    NetworkParameter* Parsing(int argc, char** argv);
+    void ParseLongOptions(int opt_index,char* exe_cmd,NetworkParameter* param);
+    void CheckParameterValid(const NetworkParameter& param) const;
+
+    void PrintHelp(char* exe_cmd) const;
+};
+} // namespace parameter
+
+#endif
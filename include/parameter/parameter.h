@@ -49,6 +49,15 @@ class Parameter
     //! @param output_channel   Output channel of Convolutional layer.
     void SetOc(const int output_channel) { output_channel_ = output_channel; }
 
+    //! @brief          Set batch size in Parameter class.
+    //! @param batch    Number of images processed by the layer.
+    void SetBatch(const int batch) { batch_ = batch; }
+
+    //! @brief          Set groups of convolution in Parameter class.
+    //! @param groups   Number of channel groups. Input channels equals
+    //!                 groups for a depthwise convolution.
+    void SetGroups(const int groups) { groups_ = groups; }
+
     //! @brief              Set MAC cycles.
     //! @param mac_cycles   MAC cycles.
     void SetMacCycles(const int mac_cycles) { mac_cycles_ = mac_cycles; }
@@ -76,6 +85,12 @@ class Parameter
     //! @brief                      Set PE calculatkon structure
     //! @param pe_strt              PE calculation structure
     void SetPeStructure(const vector<vector<int>> pe_strt) {pe_strt_ = pe_strt;}
+    //! @brief                      Set on-chip memory levels above PE-local memory.
+    //! @param mem_levels           [input size, weight size, output size, 
+    //!                             bandwidth, 32-bit access energy] of each
+    //!                             level, outermost first.
+    void SetMemLevels(const vector<vector<double>> mem_levels)
+      { mem_levels_ = mem_levels; }
 
     //! @brief              Set path of latency recording file. 
     //! @details            This file provides interface 
@@ -133,6 +148,14 @@ class Parameter
     //! @return     Output channel.
     int GetOc(void) const { return output_channel_; }
 
+    //! @brief      Return batch size.
+    //! @return     Batch size.
+    int GetBatch(void) const { return batch_; }
+
+    //! @brief      Return groups of convolution.
+    //! @return     Number of channel groups.
+    int GetGroups(void) const { return groups_; }
+
     //! @brief              Return MAC cycles.
     //! @return             MAC cycles.
     int GetMacCycles(void) const { return mac_cycles_; }
@@ -157,6 +180,9 @@ class Parameter
     //! @brief      Return PE calculation structure (2D)
     //! @return     PE calculation structure
     vector<vector<int>> GetPeStructure(void) const { return pe_strt_; }
+    //! @brief      Return on-chip memory levels above PE-local memory.
+    //! @return     Memory level descriptions, outermost first.
+    vector<vector<double>> GetMemLevels(void) const { return mem_levels_; }
 
     //! @brief      Return latency file path.
     //! @return     Latency recording file path.
@@ -189,6 +215,10 @@ class Parameter
 
     int output_channel_ = NON_VALID;
 
+    int batch_ = 1;
+
+    int groups_ = 1;
+
     int mac_cycles_ = NON_VALID;
     double frequency_ = NON_VALID;
     double bandwidth_ = NON_VALID;
@@ -197,6 +227,7 @@ class Parameter
     double output_mem_size_ = NON_VALID;  // KB
     vector<vector<int>> pe_dim_;
     vector<vector<int>> pe_strt_;
+    vector<vector<double>> mem_levels_;
 
     char latency_file_[STR_LEN] = "";
     char tiling_dump_file_[STR_LEN] = "";
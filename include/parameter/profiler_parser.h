@@ -20,6 +20,8 @@ const struct option p_options[] { // profiler options
   {"kw",                1, 0, 0},
   {"kh",                1, 0, 0},
   {"oc",                1, 0, 0},
+  {"batch",             1, 0, 0},
+  {"groups",            1, 0, 0},
   {"mac-cycles",        1, 0, 0},
   {"frequency",         1, 0, 0},
   {"bandwidth",         1, 0, 0},
@@ -31,6 +33,7 @@ const struct option p_options[] { // profiler options
   {"output-mem-size",   1, 0, 0},
   {"pe-dim",            1, 0, 0},
   {"pe-structure",      1, 0, 0},
+  {"mem-levels",        1, 0, 0},
   {"latency-path",      1, 0, 0},
   {"tiling-dump",       1, 0, 0},
   {"loop-seq-dump",     1, 0, 0},
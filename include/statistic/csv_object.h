@@ -41,7 +41,7 @@ class CsvObject
   private:
     char layer_name_[STR_LEN];
 
-    int tiw_, tih_, tic_, tkw_, tkh_, tow_, toh_, toc_;
+    int tiw_, tih_, tic_, tkw_, tkh_, tow_, toh_, toc_, tn_;
 
     int s_input_reuse_;
     int s_weight_reuse_;
@@ -73,6 +73,7 @@ class CsvObject
     double performance_;
     int active_macs_;
     double pe_util_;
+    vector<double> array_pe_util_;
 
     double off_chip_acs_energy_;
     double on_chip_acs_energy_;
@@ -5,6 +5,7 @@ Description of hardware spec
 - multiply-accumulate energy
 - on-chip access energy
 - off-chip access energy
+- on-chip memory levels above PE-local memory (optional)
 """
 
 import json
@@ -29,6 +30,10 @@ class HardwareSpec:
         self._mem_size = self._cfg['mem_size']
         self._pe_dim = self._cfg['pe_dim']
         self._pe_strt = self._cfg['pe_structure']
+        self._mem_levels = []
+        for level in self._cfg.get('mem_levels', []):
+            self._mem_levels.append(level['mem_size'] +
+                                    [level['bandwidth'], level['energy_32']])
 
         for i, row in enumerate(self._pe_strt):
             for j, element in enumerate(row):
@@ -86,6 +91,14 @@ class HardwareSpec:
         r"""Get memory size"""
         return self._mem_size
 
+    @property
+    def mem_levels(self):
+        r"""
+        Get on-chip memory levels, outermost first.
+        Each level is [input KB, weight KB, output KB, bandwidth, 32-bit access energy]
+        """
+        return self._mem_levels
+
     @property
     def pe_dim(self):
         r"""Get PE's physical dimension"""
@@ -2,6 +2,8 @@ r"""
 e-PlaNNer frontend
 """
 import os
+import hashlib
+import shutil
 import subprocess
 import exceptions
 import torch.nn as nn
@@ -15,11 +17,14 @@ class Planner:
     # pylint: disable=too-many-instance-attributes
     # DNN parameter requires too many attributes.
 
-    def __init__(self, verbose=False, debug=False, output_dir='output'):
+    def __init__(self, verbose=False, debug=False, output_dir='output',
+                 timing_only=False, native_sim=False, sim_args=False,
+                 sim_cache_dir=None, sim_openmp=False):
 
         print_logo()
 
         self.batch = None
+        self.groups = None
         self.stride = None
 
         self.input_width = None
@@ -47,6 +52,7 @@ class Planner:
         self.output_mem_size = None
         self.pe_dim = None
         self.pe_strt = None
+        self.mem_levels = None
 
         self.output_dir = output_dir
         if not os.path.isdir(self.output_dir):
@@ -55,6 +61,7 @@ class Planner:
         self.gen_code = None
         self.gaia_code = None
         self.sim_binary = None
+        self.sim_args_file = None
         self.latency_file = None
         self.timestamp_file = None
         self.tiling_dump = None
@@ -67,6 +74,14 @@ class Planner:
 
         self.verbosity = verbose
         self.debug = debug
+        self.timing_only = timing_only
+        self.native_sim = native_sim
+        self.sim_args = sim_args
+        self.sim_openmp = sim_openmp
+        self.sim_cache_dir = sim_cache_dir
+        if self.sim_cache_dir and not os.path.isdir(self.sim_cache_dir):
+            print('[Front-end] Make simulation cache directory: {}/'.format(self.sim_cache_dir))
+            os.mkdir(self.sim_cache_dir)
 
         self.log_dir = 'log'
 
@@ -94,6 +109,7 @@ class Planner:
         self.gen_code = self.output_dir + '/' + self.layer_name + '.cc'
         self.gaia_code = self.output_dir + '/' + self.layer_name + '.gaia'
         self.sim_binary = self.output_dir + '/' + self.layer_name + '_sim'
+        self.sim_args_file = self.output_dir + '/' + self.layer_name + '.args'
         self.latency_file = self.output_dir + '/' + self.layer_name + '.vl'
         self.timestamp_file = self.output_dir + '/' + self.layer_name + '.json'
         self.tiling_dump = self.output_dir + '/' + self.layer_name + '_tiling.dump'
@@ -104,6 +120,7 @@ class Planner:
             raise exceptions.ValueException
 
         self.batch = self.data.shape[0]
+        self.groups = 1
         self.input_channel = self.data.shape[1]
         self.input_width = self.data.shape[2]
         self.input_height = self.data.shape[3]
@@ -124,6 +141,7 @@ class Planner:
             self.kernel_height = self.module.kernel_size[0]
 
             self.output_channel = self.module.out_channels
+            self.groups = self.module.groups
         elif isinstance(self.module, nn.Linear):
             self.stride = 1
 
@@ -187,12 +205,21 @@ class Planner:
         self.output_mem_size = kwargs['hw_spec'].mem_size[2]
         self.pe_dim = kwargs['hw_spec'].pe_dim
         self.pe_strt = kwargs['hw_spec'].pe_strt
+        self.mem_levels = kwargs['hw_spec'].mem_levels
 
     def __make_compiler_argv(self, presched):
         argv = self.__make_argv()
 
         if presched:
             argv.append('-p')
+        if self.timing_only:
+            argv.append('--timing-only')
+        if self.native_sim:
+            argv.append('--native-sim')
+        if self.sim_openmp:
+            argv.append('--sim-openmp')
+        if self.sim_args:
+            argv.append('--sim-args-path=' + str(self.sim_args_file))
 
         argv.append('--code-path=' + str(self.gen_code))
         argv.append('--gaia-path=' + str(self.gaia_code))
@@ -229,6 +256,8 @@ class Planner:
         argv.append('--kw=' + str(self.kernel_width))
         argv.append('--kh=' + str(self.kernel_height))
         argv.append('--oc=' + str(self.output_channel))
+        argv.append('--batch=' + str(self.batch))
+        argv.append('--groups=' + str(self.groups))
 
         argv.append('--mac-cycles=' + str(self.mac_cycles))
         argv.append('--frequency=' + str(self.frequency))
@@ -238,6 +267,8 @@ class Planner:
         argv.append('--output-mem-size=' + str(self.output_mem_size))
         argv.append('--pe-dim=' + str(self.pe_dim))
         argv.append('--pe-structure=' + str(self.pe_strt))
+        if self.mem_levels:
+            argv.append('--mem-levels=' + str(self.mem_levels).replace(' ', ''))
 
         argv.append('--latency-path=' + str(self.latency_file))
         argv.append('--tiling-dump=' + str(self.tiling_dump))
@@ -255,12 +286,32 @@ class Planner:
     def __compile_code(self):
         print('[Front-end][Compiler] Generated source code compile...')
         cxx = 'g++'
-        cxx_flags = '-std=c++11 -Ofast -Wall -Werror -o ' + self.sim_binary + ' ' + self.gen_code
-        return subprocess.Popen([cxx] + cxx_flags.split()).wait()
+        cxx_flags = '-std=c++11 -Ofast -Wall -Werror'
+        if self.sim_openmp:
+            cxx_flags += ' -fopenmp'
+        if self.sim_cache_dir:
+            # Binaries are keyed by the emitted source and the flags.
+            with open(self.gen_code, 'rb') as code:
+                key = hashlib.sha256(code.read() + cxx_flags.encode()).hexdigest()
+            self.sim_binary = os.path.join(self.sim_cache_dir, key)
+            if os.path.isfile(self.sim_binary):
+                print('[Front-end][Compiler] Reuse cached binary: ' + key)
+                return 0
+            shutil.copyfile(self.gen_code, self.sim_binary + '.cc')
+            tmp_binary = self.sim_binary + '.' + str(os.getpid())
+            ret = subprocess.Popen([cxx] + cxx_flags.split() + ['-o', tmp_binary, self.sim_binary + '.cc']).wait()
+            if ret == 0:
+                os.replace(tmp_binary, self.sim_binary)
+            return ret
+        return subprocess.Popen([cxx] + cxx_flags.split() + ['-o', self.sim_binary, self.gen_code]).wait()
 
     def __run_binary(self):
         print('[Front-end][Simulation] Run simulation code...')
-        return subprocess.Popen(['./' + self.sim_binary]).wait()
+        args = []
+        if self.sim_args:
+            with open(self.sim_args_file) as args_file:
+                args = args_file.read().splitlines()
+        return subprocess.Popen([os.path.join('.', self.sim_binary)] + args).wait()
 
     def __run_profiler(self, exe_bin_path):
         print('[Front-end][Profiler] Profiling start...')
@@ -285,9 +336,9 @@ class Planner:
             self.output_height = (self.input_height + 2*self.padding_height - self.kernel_height)//self.stride + 1
             if self.__run_compiler(exe_bin_path, presched) is exit_failure:
                 raise exceptions.CodeGenerationFail
-            elif self.__compile_code() is exit_failure:
+            elif not self.native_sim and self.__compile_code() is exit_failure:
                 raise exceptions.CodeCompileFail
-            elif self.__run_binary() is exit_failure:
+            elif not self.native_sim and self.__run_binary() is exit_failure:
                 raise exceptions.RunCodeFail
             elif self.__run_profiler(exe_bin_path) is exit_failure:
                 raise exceptions.ReportFail
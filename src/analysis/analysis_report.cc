@@ -2,12 +2,29 @@
 
 #include <glog/logging.h>
 #include <iostream>
+#include <cmath>
+#include <algorithm>
 
 #include "general/data_type.h"
 
 using std::endl;
+using std::ceil;
+using std::max;
 
 using analysis::AnalysisReport;
+using arch::MemoryLevel;
+
+//! @brief  Return how many times the inner tile is visited in the outer tile.
+static long int CountTileRepeats(const Variables& outer, const Variables& inner)
+{
+  return  (long int)ceil((double)outer.GetOw() / inner.GetOw()) *
+          (long int)ceil((double)outer.GetOh() / inner.GetOh()) *
+          (long int)ceil((double)outer.GetOc() / inner.GetOc()) *
+          (long int)ceil((double)outer.GetIc() / inner.GetIc()) *
+          (long int)ceil((double)outer.GetKw() / inner.GetKw()) *
+          (long int)ceil((double)outer.GetKh() / inner.GetKh()) *
+          (long int)ceil((double)outer.GetN()  / inner.GetN());
+}
 
 AnalysisReport::AnalysisReport(void)
 {
@@ -37,15 +54,43 @@ void AnalysisReport::PreAnalyze(const VariableSet& varset,
   /* #endregion */
   reg_size_ = comput_anlyzr_->AnalyzeRegisterSize(varset);
   num_ops_  = comput_anlyzr_->AnalyzeNumOps(varset);
-  num_pe_   = arch.GetPeDim()[0][0] * arch.GetPeDim()[0][1];
+  num_pe_   = 0;
+  for (const vector<int>& pe_dim : arch.GetPeDim())
+    num_pe_ += pe_dim[0] * pe_dim[1];
   off_loop_itrs_ = comput_anlyzr_->AnalyzeOffLoopIterations(varset);
   on_loop_itrs_  = comput_anlyzr_->AnalyzeOnLoopIterations(varset);
   opt_exe_cycles_= comput_anlyzr_->AnalyzeOptExeCycles(num_ops_, num_pe_);
-  estimated_exe_cycles_ =comput_anlyzr_->AnalyzeExeCycles(off_loop_itrs_, 
-                                                          on_loop_itrs_);
   active_macs_ =comput_anlyzr_->AnalyzeActiveMacs(varset.GetParlLoopVariables(), 
                                                   arch.GetMacCycles());
+  // PE arrays share a tile, so a tile takes as long as the slowest array.
+  const vector<Variables>& array_vars = varset.GetArrayLoopVariables();
+  const vector<Variables>& array_parl_vars = varset.GetArrayParlLoopVariables();
+  vector<long int> array_on_loop_itrs(array_vars.size());
+  if (!array_vars.empty()) {
+    on_loop_itrs_ = 0;
+    active_macs_ = 0;
+  }
+  for (size_t a = 0 ; a < array_vars.size() ; a++) {
+    array_on_loop_itrs[a] = comput_anlyzr_->AnalyzeArrayOnLoopIterations(
+                                              array_vars[a], array_parl_vars[a]);
+    on_loop_itrs_ = max(on_loop_itrs_, array_on_loop_itrs[a]);
+    if (array_on_loop_itrs[a] > 0)
+      active_macs_ += comput_anlyzr_->AnalyzeActiveMacs(array_parl_vars[a],
+                                                        arch.GetMacCycles());
+  }
+  estimated_exe_cycles_ =comput_anlyzr_->AnalyzeExeCycles(off_loop_itrs_, 
+                                                          on_loop_itrs_);
   pe_util_ = (double)num_ops_ / estimated_exe_cycles_ / num_pe_ * 100;
+  array_pe_util_.clear();
+  for (size_t a = 0 ; a < array_vars.size() ; a++) {
+    // Each array computes its share of every tile.
+    double share = (array_on_loop_itrs[a] == 0) ? 0.0 :
+                   (double)array_vars[a].GetOc() / varset.GetToc() *
+                   array_vars[a].GetOh() / varset.GetToh();
+    int array_pe = arch.GetPeDim()[a][0] * arch.GetPeDim()[a][1];
+    array_pe_util_.push_back(
+      num_ops_ * share / estimated_exe_cycles_ / array_pe * 100);
+  }
   /* #region Logging */
   LOG(INFO) << "  Register size: " << reg_size_ << " Bytes";
   LOG(INFO) << "  Number of operations: " << num_ops_;
@@ -56,6 +101,8 @@ void AnalysisReport::PreAnalyze(const VariableSet& varset,
   LOG(INFO) << "  Estimated execution cycles: " << estimated_exe_cycles_;
   LOG(INFO) << "  Active MACs: " << active_macs_;
   LOG(INFO) << "  PE utilization: " << pe_util_;
+  for (size_t a = 0 ; a < array_pe_util_.size() ; a++)
+    LOG(INFO) << "  PE array " << a << " utilization: " << array_pe_util_[a];
   /* #endregion */
   s_input_reuse_ = data_reuse_anlyzr_->AnalyzeSpatialInputReuse(varset);
   s_weight_reuse_= data_reuse_anlyzr_->AnalyzeSpatialWeightReuse(varset);
@@ -147,11 +194,11 @@ void AnalysisReport::PreAnalyze(const VariableSet& varset,
 
 long int AnalysisReport::DecideInputBufferSize(const VariableSet& varset) const
 {
-  if (varset.GetOffLoopVariables().GetInputSize() == 
-      varset.GetOnLoopVariables().GetInputSize()) {
-        return varset.GetOffLoopVariables().GetInputSize();
+  if (varset.GetInputSize(varset.GetOffLoopVariables()) == 
+      varset.GetInputSize(varset.GetOnLoopVariables())) {
+        return varset.GetInputSize(varset.GetOffLoopVariables());
   } else {
-        return varset.GetOnLoopVariables().GetInputSize() * 2;
+        return varset.GetInputSize(varset.GetOnLoopVariables()) * 2;
   }
 }
 
@@ -206,18 +253,74 @@ void AnalysisReport::Analyze( const VariableSet& varset,
                                           arch.GetOnChipEnergy());
   execution_energy_ = energy_anlyzr_->AnalyzeExecutionEnergy(num_ops_, 
                                                           arch.GetMacEnergy());
-  total_energy_ = off_chip_acs_energy_+on_chip_acs_energy_+execution_energy_;
+  level_acs_energy_ = 0;
+  for (size_t l = 0 ; l < level_acs_sizes_.size() ; l++) {
+    level_acs_energy_ += energy_anlyzr_->AnalyzeOnChipAccessEnergy(
+                                          level_acs_sizes_[l],
+                                          arch.GetMemLevels()[l].energy_32);
+  }
+  total_energy_ = off_chip_acs_energy_+on_chip_acs_energy_+execution_energy_+
+                  level_acs_energy_;
   power_ = energy_anlyzr_->AnalyzePower(latency, total_energy_);
   /* #region Logging */
   LOG(INFO) << "  Off-chip access energy: " << off_chip_acs_energy_ << " nJ";
   LOG(INFO) << "  On-chip access energy: " << on_chip_acs_energy_ << " nJ";
   LOG(INFO) << "  Execution energy: " << execution_energy_ << " nJ";
+  LOG(INFO) << "  Memory level access energy: " << level_acs_energy_ << " nJ";
   LOG(INFO) << "  Total energy: " << total_energy_ << " nJ";
   LOG(INFO) << "  Power: " << power_ << " Watt";
   /* #endregion */
   CheckValidAnalysisValues();
 }
 
+void AnalysisReport::AnalyzeMemoryLevels(const VariableSet& varset,
+                                        const vector<Structure>& level_strts,
+                                        const Structure& off_strt,
+                                        const Architecture& arch)
+{
+  const vector<Variables>& level_vars = varset.GetLevelLoopVariables();
+  CHECK(level_vars.size() == level_strts.size() &&
+        level_vars.size() == arch.GetMemLevels().size())
+    << "Memory level tiles do not match the architecture: "
+    << level_vars.size() << " tiles, " << level_strts.size()
+    << " structures, " << arch.GetMemLevels().size() << " levels";
+  /* #region Logging */
+  LOG(INFO) << "Run memory level analyze.";
+  /* #endregion */
+  level_acs_sizes_.clear();
+  // Boundary b moves the inner tile into the outer one, once per outer tile.
+  for (size_t b = 0 ; b <= level_vars.size() ; b++) {
+    const Variables& outer = (b == 0) ? varset.GetOffLoopVariables() :
+                                        level_vars[b-1];
+    const Variables& inner = (b == level_vars.size()) ?
+                              varset.GetOnLoopVariables() : level_vars[b];
+    const Structure& strt = (b == level_vars.size()) ? off_strt :
+                                                        level_strts[b];
+    VariableSet boundary(varset);
+    boundary.SetOffLoopVariables(outer);
+    boundary.SetOnLoopVariables(inner);
+    long int repeats = CountTileRepeats(varset.GetOffLoopVariables(), outer);
+    long int input  = repeats * off_chip_acs_anlyzr_->AnalyzeInputLoad(
+                                                        boundary, strt);
+    long int weight = repeats * off_chip_acs_anlyzr_->AnalyzeWeightLoad(
+                                                        boundary, strt);
+    long int output = repeats * off_chip_acs_anlyzr_->AnalyzeOutputStore(
+                                                        boundary, strt);
+    if (b == 0) {
+      off_chip_input_load_size_   = input;
+      off_chip_weight_load_size_  = weight;
+      off_chip_output_store_size_ = output;
+      off_chip_total_access_size_ = input + weight + output;
+    } else {
+      level_acs_sizes_.push_back(input + weight + output);
+    }
+    /* #region Logging */
+    LOG(INFO) << "  Memory boundary " << b << " access size: "
+              << input + weight + output << " Bytes";
+    /* #endregion */
+  }
+}
+
 int AnalysisReport::GetEncodedPsumVariables(void) const
 {
   return encoded_psum_variables_;
@@ -268,6 +371,11 @@ double AnalysisReport::GetPeUtilization(void) const
   return pe_util_;
 }
 
+const vector<double>& AnalysisReport::GetArrayPeUtilization(void) const
+{
+  return array_pe_util_;
+}
+
 int AnalysisReport::GetSpatialInputReuse(void) const
 {
   return s_input_reuse_;
@@ -413,6 +521,16 @@ double AnalysisReport::GetPower(void) const
   return power_;
 }
 
+const vector<long int>& AnalysisReport::GetLevelAccessSizes(void) const
+{
+  return level_acs_sizes_;
+}
+
+double AnalysisReport::GetLevelAccessEnergy(void) const
+{
+  return level_acs_energy_;
+}
+
 ostream& AnalysisReport::PrintComputeAnalysisReport(ostream& out) const
 {
   CheckValidComputeAnalysisValues();
@@ -422,6 +540,8 @@ ostream& AnalysisReport::PrintComputeAnalysisReport(ostream& out) const
       << "# of Operations: " << num_ops_              << endl
       << "active MACs: "     << active_macs_          << endl
       << "PE utilization: "  << pe_util_              << endl;
+  for (size_t a = 0 ; a < array_pe_util_.size() ; a++)
+    out << "PE array " << a << " utilization: " << array_pe_util_[a] << endl;
   return out;
 }
 
@@ -495,6 +615,18 @@ ostream& AnalysisReport::PrintEnergyAnalysisReport(ostream& out) const
   return out;
 }
 
+ostream& AnalysisReport::PrintMemoryLevelAnalysisReport(ostream& out) const
+{
+  CheckValidOffChipAccessAnalysisValues();
+
+  out << "DRAM access size: " << off_chip_total_access_size_ << " Bytes" << endl;
+  for (size_t l = 0 ; l < level_acs_sizes_.size() ; l++)
+    out << "level " << l << " access size: " << level_acs_sizes_[l]
+        << " Bytes" << endl;
+  out << "memory level access energy: " << level_acs_energy_ << " nJ" << endl;
+  return out;
+}
+
 ostream& AnalysisReport::PrintAnalysisReport(ostream& out) const
 {
   CheckValidAnalysisValues();
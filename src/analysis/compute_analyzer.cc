@@ -20,13 +20,15 @@ int ComputeAnalyzer::AnalyzeRegisterSize(const VariableSet& varset) const
 long int ComputeAnalyzer::AnalyzeNumOps(const VariableSet& varset) const
 {
   return  (long int)varset.GetKw()*varset.GetKh()*varset.GetIc()* 
-                    varset.GetOw()*varset.GetOh()*varset.GetOc();
+                    varset.GetOw()*varset.GetOh()*varset.GetOc()*
+                    varset.GetN();
 }
 
 long int ComputeAnalyzer::AnalyzeNumTileOps(const VariableSet& varset) const
 {
   return  (long int)varset.GetTkw()*varset.GetTkh()*varset.GetTic()* 
-                    varset.GetTow()*varset.GetToh()*varset.GetToc();
+                    varset.GetTow()*varset.GetToh()*varset.GetToc()*
+                    varset.GetTn();
 }
 
 long int ComputeAnalyzer::AnalyzeOptExeCycles(const long int num_ops, 
@@ -39,6 +41,7 @@ long int ComputeAnalyzer::AnalyzeOffLoopIterations(const VariableSet& varset)
   const
 {
   return (long int)(
+      ceil((double)varset.GetN() / varset.GetTn()) *
       ceil((double)varset.GetOc() / varset.GetToc()) *
       ceil((double)varset.GetOh() / varset.GetToh()) * 
       ceil((double)varset.GetOw() / varset.GetTow()) *
@@ -52,6 +55,7 @@ long int ComputeAnalyzer::AnalyzeOnLoopIterations(const VariableSet& varset)
   const
 {
   return (long int)(
+      ceil((double)varset.GetTn() / varset.GetPn()) *
       ceil((double)varset.GetToc() / varset.GetPoc()) *
       ceil((double)varset.GetToh() / varset.GetPoh()) *
       ceil((double)varset.GetTow() / varset.GetPow()) *
@@ -61,6 +65,21 @@ long int ComputeAnalyzer::AnalyzeOnLoopIterations(const VariableSet& varset)
       );
 }
 
+long int ComputeAnalyzer::AnalyzeArrayOnLoopIterations(
+  const Variables& array_vars, const Variables& array_parl_vars) const
+{
+  if (array_vars.GetOc() == 0 || array_vars.GetOh() == 0) return 0;
+  return (long int)(
+      ceil((double)array_vars.GetN()  / array_parl_vars.GetN()) *
+      ceil((double)array_vars.GetOc() / array_parl_vars.GetOc()) *
+      ceil((double)array_vars.GetOh() / array_parl_vars.GetOh()) *
+      ceil((double)array_vars.GetOw() / array_parl_vars.GetOw()) *
+      ceil((double)array_vars.GetIc() / array_parl_vars.GetIc()) *
+      ceil((double)array_vars.GetKh() / array_parl_vars.GetKh()) *
+      ceil((double)array_vars.GetKw() / array_parl_vars.GetKw())
+      );
+}
+
 long int ComputeAnalyzer::AnalyzeExeCycles( const long int off_loop_itr, 
                                             const long int on_loop_itr) const
 {
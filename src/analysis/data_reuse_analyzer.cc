@@ -2,17 +2,24 @@
 
 #include <glog/logging.h>
 #include <math.h>
+#include <algorithm>
+
+#include "general/utils.h"
 
 using analysis::DataReuseAnalyzer;
 
 using std::ceil;
+using std::min;
+using std::max;
 
 int DataReuseAnalyzer::AnalyzeSpatialInputReuse(const VariableSet& varset) const
 {
   int ppx; // parallel input pixel
   int num_p_ops; // parallel operations
 
-  ppx = varset.GetPic() * varset.GetPih() * varset.GetPiw();
+  // Parallel output channels of other groups read other input channels.
+  ppx = varset.GetPic() * varset.GetPih() * varset.GetPiw() *
+        CalcGroupSpan(varset.GetPoc(), varset.GetGroupOc(), varset.GetGroups());
   num_p_ops = varset.GetPic() * varset.GetPkh() * varset.GetPkw() * 
               varset.GetPoc() * varset.GetPoh() * varset.GetPow();
 
@@ -49,7 +56,10 @@ int DataReuseAnalyzer::AnalyzeTemporalInputReuse( const Location intra_oc,
     /* #region Loggin */
     LOG(INFO) << "Intra output channel is inner most.";
     /* #endregion */
-    return varset.GetToc() / varset.GetPoc();
+    // Input is reused only by the output channels of its group.
+    int reuse_oc = (varset.GetGroups() == 1) ? varset.GetToc() :
+                   min(varset.GetToc(), varset.GetGroupOc());
+    return max(1, reuse_oc / varset.GetPoc());
   } else {
     /* #region Loggin */
     LOG(INFO) << "Intra output channel is not inner most.";
@@ -66,8 +76,8 @@ int DataReuseAnalyzer::AnalyzeTemporalWeightReuse(const Location on_loop_out_map
     /* #region Loggin */
     LOG(INFO) << "Intra output map is inner most.";
     /* #endregion */
-    return  (varset.GetTow() * varset.GetToh()) / 
-            (varset.GetPow() * varset.GetPoh());
+    return  (varset.GetTow() * varset.GetToh() * varset.GetTn()) / 
+            (varset.GetPow() * varset.GetPoh() * varset.GetPn());
   } else {
     /* #region Loggin */
     LOG(INFO) << "Intra output map is not inner most.";
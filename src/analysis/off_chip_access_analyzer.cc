@@ -4,6 +4,7 @@
 #include <cmath>
 
 #include "general/data_type.h"
+#include "general/utils.h"
 
 using analysis::OffChipAccessAnalyzer;
 
@@ -13,7 +14,7 @@ long int OffChipAccessAnalyzer::AnalyzeInputLoad( const VariableSet& varset,
                                                   const Structure& off_strt) 
                                                   const
 {
-  long int input_size = varset.GetOffLoopVariables().GetInputSize() *
+  long int input_size = varset.GetInputSize(varset.GetOffLoopVariables()) *
                         sizeof(DataType);
   /* #region Logging */
   LOG(INFO) << "  Input size: " << input_size << " Bytes";
@@ -33,7 +34,10 @@ int OffChipAccessAnalyzer::AnalyzeInputReload(const VariableSet& varset,
     /* #region Logging */
     LOG(INFO) << "Input reload case 2 (Not Input Stationary).";
     /* #endregion */
-    return  ceil((double)varset.GetOc() / varset.GetToc()) *
+    // Output channel tiles of other groups read other inputs.
+    int groups = CalcGroupSpan(varset.GetOc(), varset.GetGroupOc(),
+                               varset.GetGroups());
+    return  ceil(ceil((double)varset.GetOc() / varset.GetToc()) / groups) *
             ceil((double)varset.GetKw() / varset.GetTkw()) *
             ceil((double)varset.GetKh() / varset.GetTkh());
   }
@@ -72,7 +76,8 @@ int OffChipAccessAnalyzer::AnalyzeWeightReload( const VariableSet& varset,
     LOG(INFO) << "Weight reload case 2 (Not Weight Stationary).";
     /* #endregion */
     return  ceil((double)varset.GetOw() / varset.GetTow()) *
-            ceil((double)varset.GetOh() / varset.GetToh());
+            ceil((double)varset.GetOh() / varset.GetToh()) *
+            ceil((double)varset.GetN() / varset.GetTn());
   }
 }
 
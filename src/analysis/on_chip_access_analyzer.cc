@@ -26,7 +26,8 @@ long int OnChipAccessAnalyzer::AnalyzePartialSumAccess(const long int exe_cycles
 long int OnChipAccessAnalyzer::AnalyzeOutputStore(const VariableSet& varset) 
   const
 {
-  return varset.GetOc() * varset.GetOh() * varset.GetOw();
+  return (long int)varset.GetOc() * varset.GetOh() * varset.GetOw() *
+         varset.GetN();
 }
 
 long int OnChipAccessAnalyzer::AnalyzeTotalAccess(const long int input_load, 
@@ -17,15 +17,18 @@ Variables PartialSumAnalyzer::GetPartialSumVariables( const VariableSet& varset,
       off_strt.IsFullyTiled(Type::INPUT_CHANNEL)) {
     psum_var.SetOw(varset.GetTow());
     psum_var.SetOh(varset.GetToh());
+    psum_var.SetN(varset.GetTn());
     psum_var.SetOc(varset.GetToc());
   } else if (off_strt.IsFullyTiled(Type::KERNEL_MAP)) {
     if (off_strt.GetInputChannel() > 
         off_strt.GetOutputMap()) {
       psum_var.SetOw(varset.GetOw());
       psum_var.SetOh(varset.GetOh());
+      psum_var.SetN(varset.GetN());
     } else {
       psum_var.SetOw(varset.GetTow());
       psum_var.SetOh(varset.GetToh());
+      psum_var.SetN(varset.GetTn());
     }
     if (off_strt.GetInputChannel() >
         off_strt.GetOutputChannel()) {
@@ -38,9 +41,11 @@ Variables PartialSumAnalyzer::GetPartialSumVariables( const VariableSet& varset,
         off_strt.GetOutputMap()) {
       psum_var.SetOw(varset.GetOw());
       psum_var.SetOh(varset.GetOh());
+      psum_var.SetN(varset.GetN());
     } else {
       psum_var.SetOw(varset.GetTow());
       psum_var.SetOh(varset.GetToh());
+      psum_var.SetN(varset.GetTn());
     }
     if (off_strt.GetKernelMap() >
         off_strt.GetOutputChannel()) {
@@ -55,9 +60,11 @@ Variables PartialSumAnalyzer::GetPartialSumVariables( const VariableSet& varset,
         off_strt.GetOutputMap()) {
       psum_var.SetOw(varset.GetOw());
       psum_var.SetOh(varset.GetOh());
+      psum_var.SetN(varset.GetN());
     } else {
       psum_var.SetOw(varset.GetTow());
       psum_var.SetOh(varset.GetToh());
+      psum_var.SetN(varset.GetTn());
     }
     if (off_strt.GetKernelMap() >
         off_strt.GetOutputChannel() &&
@@ -20,7 +20,7 @@ double RooflineAnalyzer::AnalyzeOptArithIntensity(const long int num_ops,
                                                   const VariableSet& varset) 
                                                   const
 {
-  long int input_size  =  varset.GetOffLoopVariables().GetInputSize() *
+  long int input_size  =  varset.GetInputSize(varset.GetOffLoopVariables()) *
                           sizeof(DataType);
   long int weight_size =  varset.GetOffLoopVariables().GetWeightSize() *
                           sizeof(DataType);
@@ -12,6 +12,7 @@ arch::Architecture::Architecture(const CompilerParameter& param)
   SetOutputMemSize(param.GetOutputMemSize());
   SetPeDim(param.GetPeDim());
   SetPeStructure(param.GetPeStructure());
+  SetMemLevels(param.GetMemLevels());
   /* #region Logging */
   LOG(INFO) << "Initialize Architecture instance for compiler.";
   LOG(INFO) << "  MAC cycles: " << mac_cycles_ << " cycles";
@@ -33,6 +34,14 @@ arch::Architecture::Architecture(const CompilerParameter& param)
   for (auto pe_strt_col : pe_structure_[1]) {
     LOG(INFO) << "    " << pe_strt_col;
   }
+  for (size_t l = 0 ; l < mem_levels_.size() ; l++) {
+    LOG(INFO) << "  Memory level " << l << ": "
+              << mem_levels_[l].input_mem_size << "/"
+              << mem_levels_[l].weight_mem_size << "/"
+              << mem_levels_[l].output_mem_size << " Bytes, "
+              << mem_levels_[l].bandwidth << " GB/s, "
+              << mem_levels_[l].energy_32 << " nJ";
+  }
   /* #endregion */
 }
 
@@ -49,6 +58,7 @@ arch::Architecture::Architecture(const ProfilerParameter& param)
   SetOutputMemSize(param.GetOutputMemSize());
   SetPeDim(param.GetPeDim());
   SetPeStructure(param.GetPeStructure());
+  SetMemLevels(param.GetMemLevels());
   /* #region Logging */
   LOG(INFO) << "Initialize Architecture instance for compiler.";
   LOG(INFO) << "  MAC cycles: " << mac_cycles_ << " cycles";
@@ -73,6 +83,14 @@ arch::Architecture::Architecture(const ProfilerParameter& param)
   for (auto pe_strt_col : pe_structure_[1]) {
     LOG(INFO) << "    " << pe_strt_col;
   }
+  for (size_t l = 0 ; l < mem_levels_.size() ; l++) {
+    LOG(INFO) << "  Memory level " << l << ": "
+              << mem_levels_[l].input_mem_size << "/"
+              << mem_levels_[l].weight_mem_size << "/"
+              << mem_levels_[l].output_mem_size << " Bytes, "
+              << mem_levels_[l].bandwidth << " GB/s, "
+              << mem_levels_[l].energy_32 << " nJ";
+  }
   /* #endregion */
 }
 
@@ -124,6 +142,23 @@ void arch::Architecture::SetOutputMemSize(long int output_mem_size)
 void arch::Architecture::SetPeDim(vector<vector<int>> pe_dim)
 {
   pe_dim_ = pe_dim;
+  pe_factors_.clear();
+  for (const vector<int>& pe_len : pe_dim_) {
+    vector<vector<int>> array_factors;
+    for (int len : pe_len) {
+      vector<int> factors;
+      for (int prime_num = 2 ; len > 1 ; ) {
+        if (len % prime_num == 0) {
+          factors.push_back(prime_num);
+          len /= prime_num;
+        } else {
+          prime_num++;
+        }
+      }
+      array_factors.push_back(factors);
+    }
+    pe_factors_.push_back(array_factors);
+  }
 }
 
 void arch::Architecture::SetPeStructure(vector<vector<int>> pe_structure)
@@ -131,6 +166,9 @@ void arch::Architecture::SetPeStructure(vector<vector<int>> pe_structure)
   for (auto row : pe_structure) {
     vector<DataDimension> enum_row;
     for (auto col : row) {
+      // Batch is never unrolled on PE.
+      CHECK(col >= DataDimension::KW && col <= DataDimension::IH)
+        << "Invalid PE mapping dimension: " << col;
       enum_row.push_back((DataDimension)col);
     }
     pe_structure_.push_back(enum_row);
@@ -188,13 +226,41 @@ long int arch::Architecture::GetOutputMemSize(void) const
   return output_mem_size_;
 }
 
+void arch::Architecture::SetMemLevels(const vector<MemoryLevel>& mem_levels)
+{
+  CHECK(mem_levels.size() <= (size_t)kMaxMemLevelCnt)
+    << "Too many memory levels: " << mem_levels.size();
+  mem_levels_ = mem_levels;
+}
+
+void arch::Architecture::SetMemLevels(const vector<vector<double>>& mem_levels)
+{
+  vector<MemoryLevel> levels;
+  for (const vector<double>& row : mem_levels) {
+    CHECK(row.size() == 5) << "Memory level needs 5 values: " << row.size();
+    levels.push_back({(long int)row[0], (long int)row[1], (long int)row[2],
+                      row[3], row[4]});
+  }
+  SetMemLevels(levels);
+}
+
 vector<vector<int>> arch::Architecture::GetPeDim(void) const
 {
   return pe_dim_;
 }
 
+const vector<vector<vector<int>>>& arch::Architecture::GetPeFactors(void) const
+{
+  return pe_factors_;
+}
+
 vector<vector<arch::DataDimension>> arch::Architecture::GetPeStructure(void)
 const
 {
   return pe_structure_;
-}
\ No newline at end of file
+}
+
+const vector<arch::MemoryLevel>& arch::Architecture::GetMemLevels(void) const
+{
+  return mem_levels_;
+}
@@ -14,6 +14,9 @@ ostream& codegen::gaia::operator<<(ostream& out, const Convolution& conv)
                               << conv.GetRightPadding() << ","
                               << conv.GetUpPadding()    << "," 
                               << conv.GetDownPadding()
-                      << ")"  << endl;
+                      << ")";
+  // Dense convolutions keep the original format.
+  if (conv.GetGroups() > 1) out << "  " << conv.GetGroups();
+  out << endl;
   return out;
 }
\ No newline at end of file
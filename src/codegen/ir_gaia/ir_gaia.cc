@@ -6,6 +6,7 @@
 
 #include "loop/variable_set.h"
 #include "loop/structure.h"
+#include "general/utils.h"
 #include "codegen/ir_gaia/memory.h"
 #include "codegen/ir_gaia/data.h"
 #include "codegen/ir_gaia/data_4d.h"
@@ -96,14 +97,16 @@ void GaiaIr::AddSymbols(const CnnLoop& loop, const Architecture& arch,
   const VariableSet varset = loop.GetVariableSet();
   /* #region Logging */
   LOG(INFO) << "Add data variable before tiled.";
-  LOG(INFO) << "Input(1," << varset.GetIc() << "," 
+  LOG(INFO) << "Input("  << varset.GetN()  << ","
+                          << varset.GetIc()*varset.GetGroups() << "," 
                           << varset.GetIh() << "," 
                           << varset.GetIw() << ")";
   LOG(INFO) << "Weight("  << varset.GetOc() << ","
                           << varset.GetIc() << ","
                           << varset.GetKh() << ","
                           << varset.GetKw() << ")";
-  LOG(INFO) << "Output(1,"<< varset.GetOc() << ","
+  LOG(INFO) << "Output(" << varset.GetN()  << ","
+                          << varset.GetOc() << ","
                           << varset.GetOh() << ","
                           << varset.GetOw() << ")";
   /* #endregion */
@@ -111,8 +114,8 @@ void GaiaIr::AddSymbols(const CnnLoop& loop, const Architecture& arch,
   Data4d* input_data = new Data4d("INPUT_"+std::to_string(layer_num),
                                   DataLayout::NCHW,
                                   0,
-                                  1,
-                                  varset.GetIc(),
+                                  varset.GetN(),
+                                  varset.GetIc()*varset.GetGroups(),
                                   varset.GetIh(),
                                   varset.GetIw());
   Data4d* weight_data =new Data4d("WEIGHT_"+std::to_string(layer_num),
@@ -123,7 +126,7 @@ void GaiaIr::AddSymbols(const CnnLoop& loop, const Architecture& arch,
   Data4d* output_data =new Data4d("OUTPUT_"+std::to_string(layer_num),
                                   DataLayout::NCHW,
                                   0,
-                                  1,
+                                  varset.GetN(),
                                   varset.GetOc(),
                                   varset.GetOh(),
                                   varset.GetOw());
@@ -138,50 +141,66 @@ void GaiaIr::AddSymbols(const CnnLoop& loop, const Architecture& arch,
   vector<Variable*> output_tiles;
 
   // Input tiles
+  // Batch tiles are outermost, so each of them repeats the tiles of an image.
+  // A grouped convolution has input tiles for each output channel tile,
+  // bounding the input channels of the groups it spans.
+  const int in_c = varset.GetIc()*varset.GetGroups();
+  const int num_ig_tile = (varset.GetGroups() > 1) ?
+                          CeilDiv(varset.GetOc(), varset.GetToc()) : 1;
   int tiling_cnt=0;
   int batch=1;
-  for (int t_ic=0 ; t_ic < varset.GetIc() ; t_ic+=varset.GetTic()) {
-    num_ic_tile_++;
-    int ic_idx = t_ic;
-    int channel = min(varset.GetIc()-t_ic, varset.GetTic());
-    const int tih = (varset.GetToh()-1)*varset.GetStride()+
-                    (varset.GetIh()-varset.GetKh())%varset.GetStride()+
-                    varset.GetKh();
-    int tih_start=-varset.GetPh(), tih_end=0;
-    while (tih_end < varset.GetIh()+varset.GetPh()-1) {
-      tih_end = min(tih_start+tih-1, varset.GetIh()+varset.GetPh()-1);
-      int ih_idx = max(0, tih_start);
-      int height = min(tih_end, varset.GetIh()-1) - ih_idx + 1;
+  for (int t_n=0 ; t_n<varset.GetN() ; t_n+=varset.GetTn()) {
+    num_n_tile_++;
+    batch = min(varset.GetN()-t_n, varset.GetTn());
+    for (int t_g=0 ; t_g < num_ig_tile ; t_g++) {
+      const int g_begin = GetGroupBegin(varset, t_g);
+      const int g_span = GetGroupSpan(varset, t_g);
+      for (int t_ic=0 ; t_ic < varset.GetIc() ; t_ic+=varset.GetTic()) {
+        if (t_n == 0 && t_g == 0) num_ic_tile_++;
+        int ic_idx = g_begin*varset.GetIc() + t_ic;
+        int channel = (g_span-1)*varset.GetIc() +
+                      min(varset.GetIc()-t_ic, varset.GetTic());
+        const int tih = (varset.GetToh()-1)*varset.GetStride()+
+                        (varset.GetIh()-varset.GetKh())%varset.GetStride()+
+                        varset.GetKh();
+        int tih_start=-varset.GetPh(), tih_end=0;
+        while (tih_end < varset.GetIh()+varset.GetPh()-1) {
+          tih_end = min(tih_start+tih-1, varset.GetIh()+varset.GetPh()-1);
+          int ih_idx = max(0, tih_start);
+          int height = min(tih_end, varset.GetIh()-1) - ih_idx + 1;
       
-      const int tiw = (varset.GetTow()-1)*varset.GetStride()+
-                      (varset.GetIw()-varset.GetKw())%varset.GetStride()+
-                      varset.GetKw();
-      int tiw_start=-varset.GetPw(), tiw_end=0;
-      while (tiw_end < varset.GetIh()+varset.GetPh()-1) {
-        tiw_end = min(tiw_start+tiw-1, varset.GetIw()+varset.GetPw()-1);
-        int iw_idx = max(0, tiw_start);
-        int width = min(tiw_end, varset.GetIw()-1) - iw_idx + 1;
-
-        string name = "INPUT_" +  std::to_string(layer_num) + "_" + 
-                                  std::to_string(tiling_cnt++);
-        int start_idx = iw_idx+varset.GetIw()*(ih_idx+varset.GetIh()*ic_idx);
-        input_tiles.push_back(new Data4d( name,DataLayout::NCHW,start_idx,
-                                          batch,channel,height,width));
-        LOG(INFO) << "Add input tile ("
-                  << start_idx << ", "
-                  << batch << ", "
-                  << varset.GetTic() << ", "
-                  << height << ", "
-                  << width << ")";
-
-        tiw_start = tiw_end - (varset.GetKw()-1) + 1;
-        tiw_start = ((tiw_start-varset.GetPw())/varset.GetStride())*
-                    varset.GetStride() + varset.GetPw();
-      }
+          const int tiw = (varset.GetTow()-1)*varset.GetStride()+
+                          (varset.GetIw()-varset.GetKw())%varset.GetStride()+
+                          varset.GetKw();
+          int tiw_start=-varset.GetPw(), tiw_end=0;
+          while (tiw_end < varset.GetIh()+varset.GetPh()-1) {
+            tiw_end = min(tiw_start+tiw-1, varset.GetIw()+varset.GetPw()-1);
+            int iw_idx = max(0, tiw_start);
+            int width = min(tiw_end, varset.GetIw()-1) - iw_idx + 1;
+
+            string name = "INPUT_" +  std::to_string(layer_num) + "_" + 
+                                      std::to_string(tiling_cnt++);
+            int start_idx = iw_idx+varset.GetIw()*
+                            (ih_idx+varset.GetIh()*(ic_idx+in_c*t_n));
+            input_tiles.push_back(new Data4d( name,DataLayout::NCHW,start_idx,
+                                              batch,channel,height,width));
+            LOG(INFO) << "Add input tile ("
+                      << start_idx << ", "
+                      << batch << ", "
+                      << channel << ", "
+                      << height << ", "
+                      << width << ")";
+
+            tiw_start = tiw_end - (varset.GetKw()-1) + 1;
+            tiw_start = ((tiw_start-varset.GetPw())/varset.GetStride())*
+                        varset.GetStride() + varset.GetPw();
+          }
 
-      tih_start = tih_end - (varset.GetKh()-1) + 1;
-      tih_start = ((tih_start-varset.GetPh())/varset.GetStride())*
-                  varset.GetStride() + varset.GetPw();
+          tih_start = tih_end - (varset.GetKh()-1) + 1;
+          tih_start = ((tih_start-varset.GetPh())/varset.GetStride())*
+                      varset.GetStride() + varset.GetPw();
+        }
+      }
     }
   }
 
@@ -216,31 +235,34 @@ void GaiaIr::AddSymbols(const CnnLoop& loop, const Architecture& arch,
 
   // Output tiles
   tiling_cnt = 0;
-  batch = 1;
-  for (int t_oc=0 ; t_oc<varset.GetOc() ; t_oc+=varset.GetToc()) {
-    num_oc_tile_++;
-    for (int t_oh=0 ; t_oh<varset.GetOh() ; t_oh+=varset.GetToh()) {
-      num_oh_tile_++;
-      for (int t_ow=0 ; t_ow<varset.GetOw() ; t_ow+=varset.GetTow()) {
-        num_ow_tile_++;
-        int oc_idx = t_oc;
-        int oh_idx = t_oh;
-        int ow_idx = t_ow;
-        int start_idx = t_ow + varset.GetOw()*(t_oh + varset.GetOh()*t_oc);
-
-        string name = "OUTPUT_" + std::to_string(layer_num) + "_" +
-                                  std::to_string(tiling_cnt++);
-        int channel = min(varset.GetOc()-oc_idx, varset.GetToc());
-        int height = min(varset.GetOh()-oh_idx, varset.GetToh());
-        int width = min(varset.GetOw()-ow_idx, varset.GetTow());
-        output_tiles.push_back(new Data4d(name, DataLayout::NCHW, start_idx,
-                                          batch, channel, height, width));
-        LOG(INFO) << "Add output tile ("
-                  << start_idx << ", "
-                  << batch << ", "
-                  << channel << ", "
-                  << height << ", "
-                  << width << ")";
+  for (int t_n=0 ; t_n<varset.GetN() ; t_n+=varset.GetTn()) {
+    batch = min(varset.GetN()-t_n, varset.GetTn());
+    for (int t_oc=0 ; t_oc<varset.GetOc() ; t_oc+=varset.GetToc()) {
+      if (t_n == 0) num_oc_tile_++;
+      for (int t_oh=0 ; t_oh<varset.GetOh() ; t_oh+=varset.GetToh()) {
+        if (t_n == 0) num_oh_tile_++;
+        for (int t_ow=0 ; t_ow<varset.GetOw() ; t_ow+=varset.GetTow()) {
+          if (t_n == 0) num_ow_tile_++;
+          int oc_idx = t_oc;
+          int oh_idx = t_oh;
+          int ow_idx = t_ow;
+          int start_idx = t_ow + varset.GetOw()*
+                          (t_oh + varset.GetOh()*(t_oc + varset.GetOc()*t_n));
+
+          string name = "OUTPUT_" + std::to_string(layer_num) + "_" +
+                                    std::to_string(tiling_cnt++);
+          int channel = min(varset.GetOc()-oc_idx, varset.GetToc());
+          int height = min(varset.GetOh()-oh_idx, varset.GetToh());
+          int width = min(varset.GetOw()-ow_idx, varset.GetTow());
+          output_tiles.push_back(new Data4d(name, DataLayout::NCHW, start_idx,
+                                            batch, channel, height, width));
+          LOG(INFO) << "Add output tile ("
+                    << start_idx << ", "
+                    << batch << ", "
+                    << channel << ", "
+                    << height << ", "
+                    << width << ")";
+        }
       }
     }
   }
@@ -253,6 +275,13 @@ void GaiaIr::AddSymbols(const CnnLoop& loop, const Architecture& arch,
 }
 
 void GaiaIr::AddTexts(const CnnLoop& loop)
+{
+  //NOTE Batch tiles run outermost, and weights are loaded again for each.
+  for (int n = 0 ; n < num_n_tile_ ; n++)
+    AddBatchTexts(loop, n);
+}
+
+void GaiaIr::AddBatchTexts(const CnnLoop& loop, const int n)
 {
   vector<Variable*> input_mems;
   vector<Variable*> weight_mems;
@@ -289,11 +318,21 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
   const int num_ic_tile = num_ic_tile_;
   const int num_oh_tile = num_oh_tile_;
   const int num_ow_tile = num_ow_tile_;
+  // Input and output tiles of the batch tile n.
+  const int in_base = n*input_tiles.size()/num_n_tile_;
+  const int ot_base = n*num_oc_tile*num_oh_tile*num_ow_tile;
+  // Input tiles of a grouped convolution follow output channel tiles.
+  const bool is_grouped = varset.GetGroups() > 1;
+  auto input_index = [&](int ic, int oh, int ow, int oc) {
+    return in_base+ow+num_ow_tile*
+           (oh+num_oh_tile*(ic+num_ic_tile*(is_grouped ? oc : 0)));
+  };
   /* #region Logging */
   LOG(INFO) << "The number of output channel tile: " << num_oc_tile;
   LOG(INFO) << "The number of input channel tile: " << num_ic_tile;
   LOG(INFO) << "The number of output height tile: " << num_oh_tile;
   LOG(INFO) << "The number of output width tile: " << num_ow_tile;
+  LOG(INFO) << "Batch tile: " << n << "/" << num_n_tile_;
   /* #endregion */
 
   Memory* input_mem = dynamic_cast<Memory*>(input_mems[0]);
@@ -329,8 +368,9 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
                         << " ic: " << ic << "/" << num_ic_tile
                         << " oh: " << oh << "/" << num_oh_tile
                         << " ow: " << ow << "/" << num_ow_tile;
-              if (num_oh_tile*num_ow_tile*num_ic_tile > 1 || oc == 0) {
-                index = ow+num_ow_tile*(oh+ic*num_oh_tile);
+              if (num_oh_tile*num_ow_tile*num_ic_tile > 1 || oc == 0 ||
+                  is_grouped) {
+                index = input_index(ic, oh, ow, oc);
                 in_tile = dynamic_cast<Data4d*>(input_tiles[index]);
                 LOG(INFO) << "size of input tiles: " << input_tiles.size()
                           << "index: " << index;
@@ -344,7 +384,7 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
               }
               LOG(INFO) << "LOAD1";
               if (num_oh_tile*num_ow_tile > 1 || ic == 0) {
-                index = ow+num_ow_tile*(oh+oc*num_oh_tile);
+                index = ot_base+ow+num_ow_tile*(oh+oc*num_oh_tile);
                 ot_tile = dynamic_cast<Data4d*>(output_tiles[index]);
                 text_.push_back(
                   {
@@ -366,7 +406,8 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
                                   ow == 0 ? varset.GetPw() : 0,
                                   ow == num_ow_tile-1 ? varset.GetPw() : 0,
                                   oh == 0 ? varset.GetPh() : 0,
-                                  oh == num_oh_tile-1 ? varset.GetPh() : 0)
+                                  oh == num_oh_tile-1 ? varset.GetPh() : 0,
+                                  GetGroupSpan(varset, oc))
                 }
               );
               LOG(INFO) << "CONV";
@@ -403,8 +444,9 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
           );
           for (int oh = 0 ; oh < num_oh_tile ; oh++) {
             for (int ow = 0 ; ow < num_ow_tile ; ow++) {
-              if (num_oh_tile*num_ow_tile > 1 || oc == 0) {
-                index = ow+num_ow_tile*(oh+ic*num_oh_tile);
+              if (num_oh_tile*num_ow_tile > 1 || oc == 0 ||
+                  is_grouped) {
+                index = input_index(ic, oh, ow, oc);
                 in_tile = dynamic_cast<Data4d*>(input_tiles[index]);
                 text_.push_back(
                   {
@@ -414,7 +456,7 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
                 );
               }
               if (num_oc_tile*num_oh_tile*num_ow_tile > 1 || ic == 0) {
-                index = ow+num_ow_tile*(oh+oc*num_oh_tile);
+                index = ot_base+ow+num_ow_tile*(oh+oc*num_oh_tile);
                 ot_tile = dynamic_cast<Data4d*>(output_tiles[index]);
                 text_.push_back(
                   {
@@ -434,7 +476,8 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
                                   ow == 0 ? varset.GetPw() : 0,
                                     ow == num_ow_tile-1 ? varset.GetPw() : 0,
                                   oh == 0 ? varset.GetPh() : 0,
-                                  oh == num_oh_tile-1 ? varset.GetPh() : 0)
+                                  oh == num_oh_tile-1 ? varset.GetPh() : 0,
+                                  GetGroupSpan(varset, oc))
                 }
               );
               if (num_oc_tile*num_oh_tile*num_ow_tile>1 || ic==num_ic_tile-1) {
@@ -464,7 +507,7 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
       for (int oc = 0 ; oc < num_oc_tile ; oc++) {
         for (int oh = 0 ; oh < num_oh_tile ; oh++) {
           for (int ow = 0 ; ow < num_ow_tile ; ow++) {
-            index = ow+num_ow_tile*(oh+oc*num_oh_tile);
+            index = ot_base+ow+num_ow_tile*(oh+oc*num_oh_tile);
             Data4d* ot_tile = dynamic_cast<Data4d*>(output_tiles[index]);
             text_.push_back(
               {
@@ -473,8 +516,9 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
               }
             );
             for (int ic = 0 ; ic < num_ic_tile ; ic++) {
-              if (num_ic_tile*num_ow_tile*num_oh_tile > 1 || oc == 0) {
-                index = ow+num_ow_tile*(oh+ic*num_oh_tile);
+              if (num_ic_tile*num_ow_tile*num_oh_tile > 1 || oc == 0 ||
+                  is_grouped) {
+                index = input_index(ic, oh, ow, oc);
                 in_tile = dynamic_cast<Data4d*>(input_tiles[index]);
                 text_.push_back(
                   {
@@ -504,7 +548,8 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
                                   ow == 0 ? varset.GetPw() : 0,
                                   ow == num_ow_tile-1 ? varset.GetPw() : 0,
                                   oh == 0 ? varset.GetPh() : 0,
-                                  oh == num_oh_tile-1 ? varset.GetPh() : 0)
+                                  oh == num_oh_tile-1 ? varset.GetPh() : 0,
+                                  GetGroupSpan(varset, oc))
                 }
               );
             }
@@ -528,7 +573,7 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
       for (int oh = 0 ; oh < num_oh_tile ; oh++) {
         for (int ow = 0 ; ow < num_ow_tile ; ow++) {
           for (int oc = 0 ; oc < num_oc_tile ; oc++) {
-            index = ow+num_ow_tile*(oh+oc*num_oh_tile);
+            index = ot_base+ow+num_ow_tile*(oh+oc*num_oh_tile);
             Data4d* ot_tile = dynamic_cast<Data4d*>(output_tiles[index]);
             text_.push_back(
               {
@@ -537,8 +582,9 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
               }
             );
             for (int ic = 0 ; ic < num_ic_tile ; ic++) {
-              if (num_ic_tile > 1 || oc == 0) {
-                index = ow+num_ow_tile*(oh+ic*num_oh_tile);
+              if (num_ic_tile > 1 || oc == 0 ||
+                  is_grouped) {
+                index = input_index(ic, oh, ow, oc);
                 in_tile = dynamic_cast<Data4d*>(input_tiles[index]);
                 text_.push_back(
                   {
@@ -568,7 +614,8 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
                                   ow == 0 ? varset.GetPw() : 0,
                                   ow == num_ow_tile-1 ? varset.GetPw() : 0,
                                   oh == 0 ? varset.GetPh() : 0,
-                                  oh == num_oh_tile-1 ? varset.GetPh() : 0)
+                                  oh == num_oh_tile-1 ? varset.GetPh() : 0,
+                                  GetGroupSpan(varset, oc))
                 }
               );
             }
@@ -596,15 +643,29 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
       for (int ic = 0 ; ic < num_ic_tile ; ic++) {
         for (int oh = 0 ; oh < num_oh_tile ; oh++) {
           for (int ow = 0 ; ow < num_ow_tile ; ow++) {
-            index = ow+num_ow_tile*(oh+ic*num_oh_tile);
-            in_tile = dynamic_cast<Data4d*>(input_tiles[index]);
-            text_.push_back(
-              {
-                "LOAD",
-                new Load(*input_mem, *in_tile, 0, in_tile->GetSize()-1)
-              }
-            );
+            // Each output channel tile of a grouped convolution loads the
+            // input of its own groups.
+            if (!is_grouped) {
+              index = input_index(ic, oh, ow, 0);
+              in_tile = dynamic_cast<Data4d*>(input_tiles[index]);
+              text_.push_back(
+                {
+                  "LOAD",
+                  new Load(*input_mem, *in_tile, 0, in_tile->GetSize()-1)
+                }
+              );
+            }
             for (int oc = 0 ; oc < num_oc_tile ; oc++) {
+              if (is_grouped) {
+                index = input_index(ic, oh, ow, oc);
+                in_tile = dynamic_cast<Data4d*>(input_tiles[index]);
+                text_.push_back(
+                  {
+                    "LOAD",
+                    new Load(*input_mem, *in_tile, 0, in_tile->GetSize()-1)
+                  }
+                );
+              }
               if (num_oc_tile > 1 || ow+oh == 0) {
                 index = ic+oc*num_ic_tile;
                 wt_tile = dynamic_cast<Data4d*>(weight_tiles[index]);
@@ -616,7 +677,7 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
                 );
               }
               if (num_oc_tile*num_ow_tile*num_oh_tile > 1 || ic == 0) {
-                index = ow+num_ow_tile*(oh+oc*num_oh_tile);
+                index = ot_base+ow+num_ow_tile*(oh+oc*num_oh_tile);
                 ot_tile = dynamic_cast<Data4d*>(output_tiles[index]);
                 text_.push_back(
                   {
@@ -636,7 +697,8 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
                                   ow == 0 ? varset.GetPw() : 0,
                                   ow == num_ow_tile-1 ? varset.GetPw() : 0,
                                   oh == 0 ? varset.GetPh() : 0,
-                                  oh == num_oh_tile-1 ? varset.GetPh() : 0)
+                                  oh == num_oh_tile-1 ? varset.GetPh() : 0,
+                                  GetGroupSpan(varset, oc))
                 }
               );
               if (num_oc_tile*num_ow_tile*num_oh_tile>1 || ic==num_ic_tile-1) {
@@ -662,15 +724,29 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
       for (int oh = 0 ; oh < num_oh_tile ; oh++) {
         for (int ow = 0 ; ow < num_ow_tile ; ow++) {
           for (int ic = 0 ; ic < num_ic_tile ; ic++) {
-            index = ow+num_ow_tile*(oh+ic*num_oh_tile);
-            in_tile = dynamic_cast<Data4d*>(input_tiles[index]);
-            text_.push_back(
-              {
-                "LOAD",
-                new Load(*input_mem, *in_tile, 0, in_tile->GetSize()-1)
-              }
-            );
+            // Each output channel tile of a grouped convolution loads the
+            // input of its own groups.
+            if (!is_grouped) {
+              index = input_index(ic, oh, ow, 0);
+              in_tile = dynamic_cast<Data4d*>(input_tiles[index]);
+              text_.push_back(
+                {
+                  "LOAD",
+                  new Load(*input_mem, *in_tile, 0, in_tile->GetSize()-1)
+                }
+              );
+            }
             for (int oc = 0 ; oc < num_oc_tile ; oc++) {
+              if (is_grouped) {
+                index = input_index(ic, oh, ow, oc);
+                in_tile = dynamic_cast<Data4d*>(input_tiles[index]);
+                text_.push_back(
+                  {
+                    "LOAD",
+                    new Load(*input_mem, *in_tile, 0, in_tile->GetSize()-1)
+                  }
+                );
+              }
               if (num_oc_tile*num_ic_tile > 1 || ow+oh == 0) {
                 index = ic+oc*num_ic_tile;
                 wt_tile = dynamic_cast<Data4d*>(weight_tiles[index]);
@@ -682,7 +758,7 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
                 );
               }
               if (num_oc_tile > 1 || ic == 0) {
-                index = ow+num_ow_tile*(oh+oc*num_oh_tile);
+                index = ot_base+ow+num_ow_tile*(oh+oc*num_oh_tile);
                 ot_tile = dynamic_cast<Data4d*>(output_tiles[index]);
                 text_.push_back(
                   {
@@ -702,7 +778,8 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
                                   ow == 0 ? varset.GetPw() : 0,
                                   ow == num_ow_tile-1 ? varset.GetPw() : 0,
                                   oh == 0 ? varset.GetPh() : 0,
-                                  oh == num_oh_tile-1 ? varset.GetPh() : 0)
+                                  oh == num_oh_tile-1 ? varset.GetPh() : 0,
+                                  GetGroupSpan(varset, oc))
                 }
               );
               if (num_oc_tile > 1 || ic == num_ic_tile-1) {
@@ -727,6 +804,17 @@ void GaiaIr::AddTexts(const CnnLoop& loop)
   }
 }
 
+int GaiaIr::GetGroupBegin(const VariableSet& varset, const int oc_tile) const
+{
+  return oc_tile*varset.GetToc() / varset.GetGroupOc();
+}
+
+int GaiaIr::GetGroupSpan(const VariableSet& varset, const int oc_tile) const
+{
+  int oc_end = min(varset.GetOc(), (oc_tile+1)*varset.GetToc());
+  return (oc_end-1) / varset.GetGroupOc() - GetGroupBegin(varset, oc_tile) + 1;
+}
+
 ostream& codegen::gaia::operator<<(ostream& out, const GaiaIr& gaia_ir)
 {
   out << "[var]" << endl;
@@ -1,15 +1,22 @@
 #include <glog/logging.h>
 #include <stdlib.h>
+#include <stdio.h>
 #include <iostream>
 #include <fstream>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "general/data_type.h"
 #include "parameter/compiler_parser.h"
 #include "loop/cnn_loop.h"
 #include "arch/architecture.h"
 #include "loop/scheduler.h"
+#include "loop/schedule_cache.h"
+#include "loop/fusion_scheduler.h"
+#include "graph/layer_parser.h"
 #include "codegen/simulation_code_generator.h"
+#include "codegen/timing_simulator.h"
 #include "codegen/ir_gaia/ir_gaia.h"
 
 using std::cout;
@@ -17,15 +24,71 @@ using std::endl;
 using std::ofstream;
 using std::ifstream;
 using std::unique_ptr;
+using std::string;
+using std::vector;
 
 using parameter::CompilerParser;
 using loop::CnnLoop;
 using arch::Architecture;
 using loop::Scheduler;
+using loop::ScheduleCache;
+using loop::ScheduleKey;
+using loop::FusionScheduler;
+using loop::FusionPlan;
+using graph::layer::Layer;
 using codegen::CodeGenerator;
 using codegen::simulation::SimulationCodeGenerator;
+using codegen::simulation::TimingSimulator;
 using codegen::gaia::GaiaIr;
 
+//! @brief          Tag and rearrange structures of a scheduled loop.
+//! @param loop     Loop returned by the scheduler.
+//! @param arch     Hardware configurations.
+//! @param sched    Scheduler which decides the on-chip structure.
+static void FinishScheduledLoop(CnnLoop* loop, const Architecture& arch,
+                                Scheduler* sched);
+//! @brief          Dump tiling and loop sequence in the pre-scheduled format.
+//! @param loop     Scheduled loop.
+//! @param tiling   Tiling dump file path.
+//! @param loop_seq Loop sequence dump file stream.
+static void DumpScheduledLoop(const CnnLoop& loop, const char* tiling,
+                              ofstream& loop_seq);
+//! @brief          Dump every Pareto point of the last search.
+//! @details        The CSV lists objectives and dump files of each point.
+//!                 Each point is loadable with -p, --tiling-dump and
+//!                 --loop-seq-dump.
+//! @param arch     Hardware configurations.
+//! @param sched    Scheduler which searched the frontier.
+//! @param path     CSV file path.
+static void DumpParetoFrontier( const Architecture& arch, Scheduler* sched,
+                                const char* path);
+//! @brief          Search one shard of the tiling space and dump its result.
+//! @param loop     Overall loop informantion of CNN.
+//! @param arch     Hardware configurations.
+//! @param sched    Scheduler which searches the shard.
+//! @param shard    "<i>/<n>" for the i-th of n shards from 0.
+//! @param path     Shard result dump file path.
+static void SearchShard(const CnnLoop& loop, const Architecture& arch,
+                        Scheduler* sched, const char* shard, const char* path);
+//! @brief          Merge shard results into the best loop.
+//! @param loop     Overall loop informantion of CNN.
+//! @param arch     Hardware configurations.
+//! @param sched    Scheduler which makes the final loop.
+//! @param path     Concatenated shard result dumps.
+//! @return         New instance of CnnLoop.
+static CnnLoop* MergeShards(const CnnLoop& loop, const Architecture& arch,
+                            Scheduler* sched, const char* path);
+
+//! @brief              Schedule the layers fused after the compiled layer.
+//! @details            Report the fused tiling and the off-chip accesses
+//!                     saved compared with scheduling layer by layer.
+//! @param loop         Scheduled loop of the compiled layer.
+//! @param arch         Hardware configurations.
+//! @param spec         Comma separated fused layers, e.g. "relu,pool:2:2:0".
+//! @param search_mode  Tiling search mode of the fused convolutions.
+static void ScheduleFusedLayers(const CnnLoop& loop, const Architecture& arch,
+                                const char* spec, const char* search_mode);
+
 // Initialize global variables.
 int kStride     = NON_VALID;
 int kFilter_len = NON_VALID;
@@ -49,21 +112,58 @@ int main(int argc, char** argv)
   unique_ptr<Architecture> arch(new Architecture(*param));
   unique_ptr<CnnLoop> loop(new CnnLoop(*param));
   unique_ptr<Scheduler> sched(new Scheduler());
+  sched->SetSearchMode(param->GetSearchMode());
+  sched->SetTileEnumeration(param->GetTileEnumeration());
+  sched->SetLoopOrderSearch(param->GetLoopOrder());
+  sched->SetIntraOrderSearch(param->GetIntraLoopOrder());
+  sched->SetTileTraversal(param->GetTileTraversal());
+  sched->SetParetoFrontier(strcmp(param->GetParetoDumpFile(), "") != 0);
+  sched->SetSearchBudget(param->GetSearchBudget());
+  sched->SetSearchSeed(param->GetSearchSeed());
+  sched->SetSearchEvaluations(param->GetSearchEvaluations());
 
+  if (strcmp(param->GetSearchShard(), "") != 0) {
+    SearchShard(*loop, *arch, sched.get(), param->GetSearchShard(),
+                param->GetShardDumpFile());
+    cout << "[Back-end][Compiler] Shard is dumped to "
+         << param->GetShardDumpFile() << endl;
+    return 0;
+  }
   if (!param->GetPreScheduled()) {
-    loop.reset(sched->SearchBestLoopCase(*loop, *arch));
-    /* #region Off-chip structure Tagging */
-    Structure* tagged_off_strt = new Structure(loop->GetOffStructure());
-    tagged_off_strt->TagStationary( loop->GetVariableSet().GetOffLoopVariables(), 
-                                    loop->GetVariableSet().GetOnLoopVariables());
-    Structure* on_strt = new Structure(loop->GetOnStructure());
-    on_strt->SetOutputStationary();
-    loop->SetOffStructure(tagged_off_strt);
-    loop->SetOnStructure(on_strt);
-    /* #endregion */
-    loop->SetOnStructure(sched->FixOnLoopStructure());
-    loop->MoveFullyTiledToInnerMost();
-    loop->CheckValid();
+    unique_ptr<ScheduleCache> cache;
+    ScheduleKey key;
+    bool is_cached = false;
+    if (strcmp(param->GetScheduleCacheFile(), "") != 0 &&
+        ScheduleCache::MakeKey(*loop, *arch, param->GetSearchMode(),
+                               param->GetTileEnumeration(),
+                               param->GetLoopOrder(),
+                               param->GetIntraLoopOrder(), &key)) {
+      cache.reset(new ScheduleCache(param->GetScheduleCacheFile()));
+      // The Pareto frontier is only known by searching.
+      if (strcmp(param->GetParetoDumpFile(), "") == 0)
+        is_cached = cache->Find(key, loop.get());
+    }
+    if (is_cached) {
+      cout << "[Back-end][Compiler] Schedule cache hit from "
+           << param->GetScheduleCacheFile() << endl;
+      loop->SetVariableSet(sched->PartitionPeArrays(loop->GetVariableSet(),
+                                                    *arch));
+    } else {
+      if (strcmp(param->GetShardMergeFile(), "") != 0)
+        loop.reset(MergeShards(*loop, *arch, sched.get(),
+                               param->GetShardMergeFile()));
+      else
+        loop.reset(sched->SearchBestLoopCase(*loop, *arch));
+      FinishScheduledLoop(loop.get(), *arch, sched.get());
+      if (param->GetSearchBudget() > 0)
+        cout << "[Back-end][Compiler] Budgeted search covered "
+             << sched->GetSearchCoverage()*100 << "% of the tiling space"
+             << " with optimality gap " << sched->GetOptimalityGap()*100
+             << "%" << endl;
+      // Budgeted and engine searches may miss the best loop.
+      if (cache && sched->IsSearchExact())
+        cache->Insert(key, *loop);
+    }
     /* #region Logging */
     LOG(INFO) << "Final Tiling Factors.";
     LOG(INFO) << "  TIW: " << loop->GetVariableSet().GetTiw();
@@ -74,17 +174,17 @@ int main(int argc, char** argv)
     LOG(INFO) << "  TOW: " << loop->GetVariableSet().GetTow();
     LOG(INFO) << "  TOH: " << loop->GetVariableSet().GetToh();
     LOG(INFO) << "  TOC: " << loop->GetVariableSet().GetToc();
+    LOG(INFO) << "  TN: "  << loop->GetVariableSet().GetTn();
     /* #endregion */
     cout << "[Back-end][Compiler] Dump tiling information..." << endl;
-    ofstream varset_dump(param->GetTilingDumpFile());
     ofstream strt_dump(param->GetLoopSequenceDumpFile(), std::ios::app);
-    varset_dump << loop->GetVariableSet().GetOnLoopVariables() << endl
-                << loop->GetVariableSet().GetParlLoopVariables();
-    strt_dump << loop->GetOffStructure() << endl
-              << loop->GetOnStructure();
-
-    varset_dump.close();
+    DumpScheduledLoop(*loop, param->GetTilingDumpFile(), strt_dump);
     strt_dump.close();
+    if (strcmp(param->GetParetoDumpFile(), "") != 0) {
+      cout << "[Back-end][Compiler] Dump Pareto frontier to "
+           << param->GetParetoDumpFile() << endl;
+      DumpParetoFrontier(*arch, sched.get(), param->GetParetoDumpFile());
+    }
   } else {
     Variables on_loop, parl_loop;
     Structure *on_strt=new Structure(), *off_strt=new Structure();
@@ -99,9 +199,31 @@ int main(int argc, char** argv)
     varset->SetParlLoopVariables(parl_loop);
     off_strt->TagStationary(varset->GetOffLoopVariables(),
                             varset->GetOnLoopVariables());
+    // Tiles of memory levels follow the PE-local tiling in both dumps.
+    vector<Variables> level_vars(arch->GetMemLevels().size());
+    vector<Structure> level_strts(arch->GetMemLevels().size());
+    for (size_t l = 0 ; l < level_vars.size() ; l++)
+      varset_dump >> level_vars[l];
+    for (size_t l = 0 ; l < level_strts.size() ; l++) {
+      strt_dump >> level_strts[l];
+      level_strts[l].TagStationary(
+        (l == 0) ? loop->GetVariableSet().GetOffLoopVariables() :
+                   level_vars[l-1],
+        level_vars[l]);
+    }
+    varset->SetLevelLoopVariables(level_vars);
+    // Shares of PE arrays follow the memory levels in the tiling dump.
+    if (arch->GetPeDim().size() > 1) {
+      vector<Variables> array_vars(arch->GetPeDim().size());
+      vector<Variables> array_parl_vars(arch->GetPeDim().size());
+      for (size_t a = 0 ; a < array_vars.size() ; a++)
+        varset_dump >> array_vars[a] >> array_parl_vars[a];
+      varset->SetArrayLoopVariables(array_vars, array_parl_vars);
+    }
     loop->SetVariableSet(varset);
     loop->SetOffStructure(off_strt);
     loop->SetOnStructure(on_strt);
+    loop->SetLevelStructures(level_strts);
     varset_dump.close();
     strt_dump.close();
     /* #region Logging */
@@ -114,16 +236,36 @@ int main(int argc, char** argv)
     LOG(INFO) << "  TOW: " << loop->GetVariableSet().GetTow();
     LOG(INFO) << "  TOH: " << loop->GetVariableSet().GetToh();
     LOG(INFO) << "  TOC: " << loop->GetVariableSet().GetToc();
+    LOG(INFO) << "  TN: "  << loop->GetVariableSet().GetTn();
     /* #endregion */
   }
+  if (strcmp(param->GetFusedLayers(), "") != 0)
+    ScheduleFusedLayers(*loop, *arch, param->GetFusedLayers(),
+                        param->GetSearchMode());
   cout << "[Back-end][Compiler] Code generation start..." << endl;
   // Don't use unique_ptr here because of polymorphism.
-  CodeGenerator* code_gen = new SimulationCodeGenerator(
+  SimulationCodeGenerator* sim_gen = new SimulationCodeGenerator(
                                                       param->GetCodeFile(),
                                                       param->GetLatencyFile(),
                                                       param->GetTimestampFile()
                                                       );
+  sim_gen->SetDataLayout(param->GetSimLayout());
+  sim_gen->SetTimingOnly(param->GetTimingOnly());
+  sim_gen->SetParallelCompute(param->GetSimOpenmp());
+  sim_gen->SetArgsFile(param->GetSimArgsFile());
+  CodeGenerator* code_gen = sim_gen;
   code_gen->GenCode(*loop, *arch);
+  if (param->GetNativeSim()) {
+    // Latency and timestamps of the generated code without compiling it.
+    cout << "[Back-end][Compiler] Native simulation start..." << endl;
+    TimingSimulator timing_sim(*loop, *arch);
+    ofstream ts_file(param->GetTimestampFile());
+    long int latency = timing_sim.Run(&ts_file);
+    ts_file.close();
+    ofstream latency_file(param->GetLatencyFile());
+    latency_file << latency << endl;
+    latency_file.close();
+  }
   // Generate Gaia IR.
   cout << "[Back-end][Compiler] Gaia IR generation start..." << endl;
   codegen::LayerList layer_list = {codegen::LayerType::CONV};
@@ -144,3 +286,158 @@ int main(int argc, char** argv)
 
   return EXIT_SUCCESS;
 }
+
+static void FinishScheduledLoop(CnnLoop* loop, const Architecture& arch,
+                                Scheduler* sched)
+{
+  /* #region Off-chip structure Tagging */
+  Structure* tagged_off_strt = new Structure(loop->GetOffStructure());
+  tagged_off_strt->TagStationary( loop->GetVariableSet().GetOffLoopVariables(), 
+                                  loop->GetVariableSet().GetOnLoopVariables());
+  loop->SetOffStructure(tagged_off_strt);
+  /* #endregion */
+  loop->SetOnStructure(sched->DecideOnLoopStructure(loop->GetVariableSet(),
+                                                    arch));
+  // Each memory level structure walks the next tile over its own tile.
+  const VariableSet& varset = loop->GetVariableSet();
+  vector<Structure> level_strts(loop->GetLevelStructures());
+  for (size_t l = 0 ; l < level_strts.size() ; l++) {
+    level_strts[l].TagStationary(
+      (l == 0) ? varset.GetOffLoopVariables() :
+                 varset.GetLevelLoopVariables()[l-1],
+      varset.GetLevelLoopVariables()[l]);
+  }
+  loop->SetLevelStructures(level_strts);
+  loop->SetVariableSet(sched->PartitionPeArrays(varset, arch));
+  loop->MoveFullyTiledToInnerMost();
+  loop->CheckValid();
+}
+
+static void DumpScheduledLoop(const CnnLoop& loop, const char* tiling,
+                              ofstream& loop_seq)
+{
+  ofstream varset_dump(tiling);
+  varset_dump << loop.GetVariableSet().GetOnLoopVariables() << endl
+              << loop.GetVariableSet().GetParlLoopVariables();
+  loop_seq << loop.GetOffStructure() << endl
+           << loop.GetOnStructure();
+  for (const Variables& level_vars : loop.GetVariableSet().GetLevelLoopVariables())
+    varset_dump << endl << level_vars;
+  const VariableSet& varset = loop.GetVariableSet();
+  for (size_t a = 0 ; a < varset.GetArrayLoopVariables().size() ; a++) {
+    varset_dump << endl << varset.GetArrayLoopVariables()[a]
+                << endl << varset.GetArrayParlLoopVariables()[a];
+  }
+  for (const Structure& level_strt : loop.GetLevelStructures())
+    loop_seq << endl << level_strt;
+  varset_dump.close();
+}
+
+static void DumpParetoFrontier( const Architecture& arch, Scheduler* sched,
+                                const char* path)
+{
+  const vector<loop::ParetoPoint>& frontier = sched->GetParetoFrontier();
+  ofstream csv(path);
+  csv << "point,latency_ns,dram_bytes,on_chip_bytes,edp,"
+      << "tiling_dump,loop_seq_dump" << endl;
+  for (size_t i = 0 ; i < frontier.size() ; i++) {
+    string tiling = string(path) + "." + std::to_string(i) + ".tiling";
+    string loop_seq = string(path) + "." + std::to_string(i) + ".seq";
+    unique_ptr<CnnLoop> point_loop(sched->MakeParetoLoop(i));
+    FinishScheduledLoop(point_loop.get(), arch, sched);
+    ofstream strt_dump(loop_seq);
+    DumpScheduledLoop(*point_loop, tiling.c_str(), strt_dump);
+    strt_dump.close();
+    csv << i << "," << frontier[i].latency << ","
+        << frontier[i].dram_bytes << "," << frontier[i].on_chip_bytes << ","
+        << frontier[i].result.edp << "," << tiling << "," << loop_seq << endl;
+  }
+  csv.close();
+}
+
+static void SearchShard(const CnnLoop& loop, const Architecture& arch,
+                        Scheduler* sched, const char* shard, const char* path)
+{
+  int shard_id, shard_cnt;
+  CHECK_EQ(sscanf(shard, "%d/%d", &shard_id, &shard_cnt), 2)
+    << "Shard must be given as id/count: " << shard;
+  CHECK_GT(shard_cnt, 0) << "Shard count must be positive: " << shard;
+  CHECK(0 <= shard_id && shard_id < shard_cnt)
+    << "Shard id must be in [0, " << shard_cnt << "): " << shard;
+  // Shard i searches [total*i/n + 1, total*(i+1)/n], so n shards of the
+  // same layer cover the whole space for any n.
+  loop::EncodedItr total = sched->CountTilingSpace(loop, arch);
+  CHECK((loop::EncodedItr)shard_cnt <= total)
+    << "More shards than " << total << " tiling iterations";
+  loop::EncodedItr begin = (unsigned __int128)total*shard_id/shard_cnt + 1;
+  loop::EncodedItr end = (unsigned __int128)total*(shard_id+1)/shard_cnt;
+  cout << "[Back-end][Compiler] Search shard " << shard << " ["
+       << begin << ", " << end << "] of " << total << " iterations" << endl;
+  loop::ShardResult result = sched->SearchShard(loop, arch, begin, end);
+  ofstream dump(path);
+  dump << result;
+  CHECK(dump.good()) << "Cannot write shard result: " << path;
+  dump.close();
+}
+
+static CnnLoop* MergeShards(const CnnLoop& loop, const Architecture& arch,
+                            Scheduler* sched, const char* path)
+{
+  vector<loop::ShardResult> shards;
+  ifstream dump(path);
+  CHECK(dump.is_open()) << "Cannot open shard results: " << path;
+  loop::ShardResult shard;
+  while (dump >> shard)
+    shards.push_back(shard);
+  CHECK(dump.eof()) << "Shard results are broken: " << path;
+  dump.close();
+  cout << "[Back-end][Compiler] Merge " << shards.size() << " shards from "
+       << path << endl;
+  return sched->MergeShards(loop, arch, shards);
+}
+
+static void ScheduleFusedLayers(const CnnLoop& loop, const Architecture& arch,
+                                const char* spec, const char* search_mode)
+{
+  vector<unique_ptr<Layer>> layers;
+  string specs(spec);
+  size_t begin = 0;
+  while (begin <= specs.size()) {
+    size_t end = specs.find(',', begin);
+    if (end == string::npos) end = specs.size();
+    layers.emplace_back(graph::ParseLayer(specs.substr(begin, end-begin)));
+    begin = end + 1;
+  }
+  vector<const Layer*> chain;
+  for (const unique_ptr<Layer>& layer : layers)
+    chain.push_back(layer.get());
+
+  FusionScheduler fusion(loop, chain, search_mode);
+  FusionPlan plan = fusion.SearchFusedTiling(arch);
+  cout << "[Back-end][Compiler] Fuse " << chain.size()
+       << " layers after this layer" << endl;
+  if (!plan.is_feasible) {
+    cout << "[Back-end][Compiler] No fused tiling fits on-chip memory" << endl;
+    return;
+  }
+  const vector<loop::FusedLayer>& fused = fusion.GetFusedLayers();
+  for (size_t l = 0 ; l < fused.size() ; l++) {
+    cout << "[Back-end][Compiler]   Layer " << l << " output "
+         << fused[l].out_w << "x" << fused[l].out_h << "x" << fused[l].out_c
+         << ", tile " << plan.layer_tile_w[l] << "x" << plan.layer_tile_h[l]
+         << endl;
+  }
+  long int saved = plan.layerwise_dram_bytes - plan.dram_bytes;
+  cout << "[Back-end][Compiler] Fused DRAM accesses " << plan.dram_bytes
+       << " Bytes, layer by layer " << plan.layerwise_dram_bytes
+       << " Bytes, saved " << saved << " Bytes ("
+       << 100.0 * saved / plan.layerwise_dram_bytes << "%)" << endl;
+  cout << "[Back-end][Compiler] Halo recomputation " << plan.recompute_ops
+       << " ops (" << 100.0 * plan.recompute_ops / plan.num_ops << "%), "
+       << "weights " << (plan.is_weight_resident ? "resident" : "streamed")
+       << ", on-chip " << plan.on_chip_bytes << " Bytes" << endl;
+  cout << "[Back-end][Compiler] Estimated latency fused " << plan.latency
+       << " ns, layer by layer " << plan.layerwise_latency << " ns" << endl;
+  if (saved <= 0)
+    cout << "[Back-end][Compiler] Fusion does not save DRAM accesses" << endl;
+}
@@ -0,0 +1,91 @@
+#include "graph/layer_parser.h"
+
+#include <stdio.h>
+#include <glog/logging.h>
+#include <fstream>
+
+#include "graph/conv.h"
+#include "graph/max_pool.h"
+#include "graph/activation.h"
+#include "graph/batch_norm.h"
+
+using graph::layer::Convolution;
+using graph::layer::MaxPool;
+using graph::layer::Activation;
+using graph::layer::BatchNorm;
+using graph::Graph;
+using graph::Vertex;
+using graph::Edge;
+
+using std::ifstream;
+
+Layer* graph::ParseLayer(const string& spec)
+{
+  int ksize, channel, stride, padding = 0;
+  if (spec == "relu")
+    return new Activation(layer::activ::ReLU);
+  if (spec == "leaky")
+    return new Activation(layer::activ::LeakyReLU);
+  if (spec == "bn")
+    return new BatchNorm();
+  if (sscanf(spec.c_str(), "pool:%d:%d:%d", &ksize, &stride, &padding) >= 2) {
+    CHECK(ksize > 0 && stride > 0 && padding >= 0)
+      << "Pool layer is non-valid: " << spec;
+    return new MaxPool(ksize, stride, padding);
+  }
+  if (sscanf(spec.c_str(), "conv:%d:%d:%d:%d",
+             &ksize, &channel, &stride, &padding) == 4) {
+    CHECK(ksize > 0 && channel > 0 && stride > 0 && padding >= 0)
+      << "Conv layer is non-valid: " << spec;
+    return new Convolution(ksize, channel, stride, padding);
+  }
+  LOG(FATAL) << "Layer is non-valid: " << spec;
+  return nullptr; // unreachable.
+}
+
+Network* graph::ParseNetwork(const char* path)
+{
+  ifstream file(path);
+  CHECK(file.is_open()) << "Cannot open network file: " << path;
+  Graph* graph = new Graph();
+  Network* network = new Network();
+  network->SetNetwork(graph);
+
+  Data4d* data = nullptr;
+  Vertex* prev = nullptr;
+  string line;
+  while (getline(file, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    if (data == nullptr) {
+      int batch, channel, height, width;
+      CHECK(sscanf(line.c_str(), "input:%d:%d:%d:%d",
+                   &batch, &channel, &height, &width) == 4 &&
+            batch > 0 && channel > 0 && height > 0 && width > 0)
+        << "Network input is non-valid: " << line;
+      data = new Data4d(batch, channel, height, width);
+      continue;
+    }
+    Vertex* vertex = new Vertex(ParseLayer(line));
+    graph->AddVertex(vertex);
+    Edge* edge = new Edge(prev, vertex, data);
+    graph->AddEdge(edge);
+    vertex->AddIndegree(edge);
+    if (prev == nullptr) {
+      network->SetHeader(vertex);
+    } else {
+      prev->AddOutdegree(edge);
+      prev->AddOutAdjacent(vertex);
+      vertex->AddInAdjacent(prev);
+    }
+    data = dynamic_cast<Data4d*>(vertex->GetLayer()->GetOutput({data}));
+    CHECK(data->GetWidth() > 0 && data->GetHeight() > 0)
+      << "Layer has no output: " << line;
+    prev = vertex;
+  }
+  CHECK(prev != nullptr) << "Network has no layer: " << path;
+  Edge* edge = new Edge(prev, nullptr, data);
+  graph->AddEdge(edge);
+  prev->AddOutdegree(edge);
+  network->SetTrailer(prev);
+  return network;
+}
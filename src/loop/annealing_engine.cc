@@ -0,0 +1,80 @@
+#include "loop/annealing_engine.h"
+
+#include <float.h>
+#include <math.h>
+
+using loop::AnnealingEngine;
+using loop::TilingSpace;
+using loop::SearchResult;
+using loop::EncodedItr;
+
+SearchResult AnnealingEngine::Search(TilingSpace* space,
+                                     unsigned int num_threads)
+{
+  SearchResult chain_best[kAnnealingChainCnt];
+  RunJobs(num_threads, kAnnealingChainCnt,
+    [this, space, &chain_best](unsigned int thr, int chain) {
+      SearchChain(space, thr, chain, &chain_best[chain]);
+    }
+  );
+  SearchResult best = chain_best[0];
+  for (int chain = 1 ; chain < kAnnealingChainCnt ; chain++)
+    MergeResult(chain_best[chain], &best);
+  return best;
+}
+
+void AnnealingEngine::SearchChain(TilingSpace* space, unsigned int thr,
+                                  int chain, SearchResult* best) const
+{
+  best->cand = TilingCandidate();
+  best->edp = DBL_MAX;
+  best->itr = 0;
+  best->order = -1;
+  // Only digits with more than one tile size can move.
+  int movable[kTileDimensionCnt], movable_cnt = 0;
+  for (int i = 0 ; i < kTileDimensionCnt ; i++)
+    if (space->GetRadix(i) > 1) movable[movable_cnt++] = i;
+  uint64_t rng_state = GetJobSeed(chain);
+  EncodedItr step_cnt = eval_cnt_ / kAnnealingChainCnt;
+  EncodedItr eval_cnt = 0;
+  int digit[kTileDimensionCnt];
+  SearchResult curr;
+  RandomizeDigits(*space, &rng_state, digit);
+  if (!RepairDigits(space, thr, &rng_state, kAnnealingRepairTry, digit,
+                    &curr, &eval_cnt)) {
+    // Even the random start does not fit. Start from the smallest tiles.
+    for (int i = 0 ; i < kTileDimensionCnt ; i++)
+      digit[i] = 0;
+    eval_cnt++;
+    if (!space->Evaluate(thr, digit, &curr)) return;
+  }
+  *best = curr;
+  if (movable_cnt == 0) return;
+
+  double cooling = log(kAnnealingEndTemp / kAnnealingStartTemp);
+  int next[kTileDimensionCnt];
+  SearchResult cand;
+  for ( ; eval_cnt < step_cnt ; eval_cnt++) {
+    double temp = kAnnealingStartTemp *
+                  exp(cooling * (double)eval_cnt / (double)step_cnt);
+    for (int i = 0 ; i < kTileDimensionCnt ; i++)
+      next[i] = digit[i];
+    // Mostly local steps, with occasional jumps to leave flat regions.
+    int i = movable[NextRandomInt(&rng_state, movable_cnt)];
+    int radix = space->GetRadix(i);
+    if (NextRandomInt(&rng_state, 4) == 0) {
+      next[i] = NextRandomInt(&rng_state, radix);
+    } else {
+      next[i] += NextRandomInt(&rng_state, 2) ? 1 : -1;
+      if (next[i] < 0 || next[i] >= radix) continue;
+    }
+    if (!space->Evaluate(thr, next, &cand)) continue;
+    double delta = log(cand.edp / curr.edp);
+    if (delta <= 0.0 || NextRandomDouble(&rng_state) < exp(-delta / temp)) {
+      for (int d = 0 ; d < kTileDimensionCnt ; d++)
+        digit[d] = next[d];
+      curr = cand;
+      MergeResult(curr, best);
+    }
+  }
+}
@@ -0,0 +1,114 @@
+#include "loop/anytime_engine.h"
+
+#include <glog/logging.h>
+#include <float.h>
+#include <algorithm>
+
+using std::min;
+
+using loop::AnytimeEngine;
+using loop::TilingSpace;
+using loop::SearchResult;
+using loop::SearchChunk;
+using loop::SearchRegion;
+using loop::EncodedItr;
+
+SearchResult AnytimeEngine::Search(TilingSpace* space,
+                                   unsigned int num_threads)
+{
+  deadline_ = std::chrono::steady_clock::now() +
+    std::chrono::microseconds((long int)(budget_ms_*1000.0));
+  return ExhaustiveEngine::Search(space, num_threads);
+}
+
+void AnytimeEngine::DistributeChunks(void)
+{
+  // Upper digits are fixed in each region, so a region is a contiguous
+  // range of traversal ranks.
+  const int top = kTileDimensionCnt-1;
+  int depth = 1;
+  EncodedItr region_cnt = space_->GetRadix(top);
+  while (depth < kTileDimensionCnt-1 &&
+         region_cnt < num_threads_*kMinRegionPerThread &&
+         region_cnt*space_->GetRadix(top-depth) <= kMaxRegionCnt)
+    region_cnt *= space_->GetRadix(top-(depth++));
+  const int free_cnt = kTileDimensionCnt-depth;
+  EncodedItr region_size = GetDigitWeight(*space_, free_cnt);
+
+  regions_.clear();
+  infeasible_cnt_ = 0;
+  for (EncodedItr r = 0 ; r < region_cnt ; r++) {
+    SearchChunk region = { r*region_size+1, (r+1)*region_size };
+    int digit[kTileDimensionCnt];
+    double lower_bound;
+    space_->GetRankDigits(region.first, digit);
+    if (!space_->Bound(digit, free_cnt, &lower_bound)) {
+      infeasible_cnt_ += region_size;
+      continue;
+    }
+    regions_.push_back({ region, lower_bound });
+  }
+  // Promising regions first. Chunks are dealt round robin, so every
+  // worker takes them in the same order.
+  sort(regions_.begin(), regions_.end(),
+    [](const SearchRegion& left, const SearchRegion& right)->bool {
+      return  left.second < right.second ||
+              (left.second == right.second &&
+               left.first.first < right.first.first);
+    }
+  );
+  EncodedItr chunk_size = min(kMaxAnytimeChunkSize, region_size);
+  size_t chunk_cnt = 0;
+  for (const SearchRegion& region : regions_) {
+    for (EncodedItr first = region.first.first ;
+         first <= region.first.second ; first += chunk_size) {
+      queues_[chunk_cnt++ % num_threads_]->Push(
+        { first, min(first+chunk_size-1, region.first.second) }
+      );
+    }
+  }
+  sort(regions_.begin(), regions_.end());
+  /* #region Logging */
+  LOG(INFO) << "Budgeted search over " << region_cnt << " regions of "
+            << region_size << " iterations.";
+  LOG(INFO) << "  Infeasible regions: " << region_cnt - regions_.size();
+  /* #endregion */
+}
+
+bool AnytimeEngine::IsStopped(void) const
+{
+  // The budget only stops the search once something can be returned.
+  return has_feasible_.load(std::memory_order_relaxed) &&
+         std::chrono::steady_clock::now() > deadline_;
+}
+
+void AnytimeEngine::FinishSearch(const SearchResult& result)
+{
+  // Chunks left in the queues are never visited. Their regions bound
+  // what the rest of the search could have found.
+  EncodedItr total_cnt = CountTilings(*space_);
+  EncodedItr unvisited_cnt = 0;
+  double lower_bound = result.edp;
+  SearchChunk chunk;
+  for (size_t thr = 0 ; thr < num_threads_ ; thr++) {
+    while (queues_[thr]->Pop(&chunk)) {
+      unvisited_cnt += chunk.second - chunk.first + 1;
+      auto region = std::upper_bound(regions_.begin(), regions_.end(),
+                                     SearchRegion({ chunk.first, total_cnt },
+                                                  DBL_MAX));
+      lower_bound = min(lower_bound, (region-1)->second);
+    }
+  }
+  coverage_ = (double)(total_cnt - unvisited_cnt) / total_cnt;
+  gap_ = 0.0;
+  if (result.edp < DBL_MAX)
+    gap_ = (result.edp - lower_bound) / result.edp;
+  /* #region Logging */
+  LOG(INFO) << "Budgeted search is finished...";
+  LOG(INFO) << "  Coverage: " << coverage_
+            << " (" << total_cnt - unvisited_cnt << " / " << total_cnt
+            << ", " << infeasible_cnt_ << " infeasible by bound)";
+  LOG(INFO) << "  Lower bound: " << lower_bound;
+  LOG(INFO) << "  Optimality gap: " << gap_;
+  /* #endregion */
+}
@@ -0,0 +1,68 @@
+#include "loop/branch_and_bound_engine.h"
+
+#include <float.h>
+
+using loop::BranchAndBoundEngine;
+using loop::SearchResult;
+using loop::SearchChunk;
+using loop::EncodedItr;
+
+void BranchAndBoundEngine::DistributeChunks(void)
+{
+  // Roots are the tilings of the two most significant digits.
+  const int top = kTileDimensionCnt-1;
+  DistributeRange(1, (EncodedItr)space_->GetRadix(top) *
+                     space_->GetRadix(top-1));
+  bound_edp_ = DBL_MAX;
+}
+
+EncodedItr BranchAndBoundEngine::VisitChunk(unsigned int thr,
+                                            const SearchChunk& chunk,
+                                            SearchResult* best)
+{
+  const int top = kTileDimensionCnt-1;
+  const EncodedItr low_cnt = space_->GetRadix(top-1);
+  int digit[kTileDimensionCnt];
+
+  // Larger tiles first. They find a good bound early.
+  for (EncodedItr it = chunk.second ; it >= chunk.first ; it--) {
+    EncodedItr offset = it-1;
+    digit[top] = offset / low_cnt;
+    digit[top-1] = offset % low_cnt;
+    SearchBranch(thr, top-2, digit, best);
+    if (it == chunk.first) break; // it is unsigned.
+  }
+  return (chunk.second - chunk.first + 1) * GetDigitWeight(*space_, top-1);
+}
+
+void BranchAndBoundEngine::SearchBranch(unsigned int thr, int i, int* digit,
+                                        SearchResult* best)
+{
+  if (i < 0) { // Every digit is set.
+    SearchResult result;
+    if (!space_->Evaluate(thr, digit, &result)) return;
+    if (best->edp > result.edp ||
+        (best->edp == result.edp && best->itr < result.itr)) {
+      *best = result;
+      // Share the bound with other workers.
+      double bound = bound_edp_.load();
+      while (result.edp < bound &&
+             !bound_edp_.compare_exchange_weak(bound, result.edp));
+    }
+    return;
+  }
+  /* #region Bounding */
+  double lower_bound;
+  if (!space_->Bound(digit, i+1, &lower_bound) ||
+      lower_bound > bound_edp_.load()) {
+    prune_cnt_[thr] += GetDigitWeight(*space_, i+1);
+    return;
+  }
+  /* #endregion */
+  /* #region Branching */
+  for (int d = space_->GetRadix(i) ; d > 0 ; d--) {
+    digit[i] = d-1;
+    SearchBranch(thr, i-1, digit, best);
+  }
+  /* #endregion */
+}
@@ -22,6 +22,7 @@ CnnLoop::CnnLoop(const CnnLoop& loop)
   varset_   =unique_ptr<VariableSet>(new VariableSet(loop.GetVariableSet()));
   off_strt_ =unique_ptr<Structure>(new Structure(loop.GetOffStructure()));
   on_strt_  =unique_ptr<Structure>(new Structure(loop.GetOnStructure()));
+  level_strts_ = loop.GetLevelStructures();
 }
 
 void CnnLoop::SetVariableSet(VariableSet* varset)
@@ -39,6 +40,11 @@ void CnnLoop::SetOnStructure(Structure* on_strt)
   on_strt_.reset(on_strt);
 }
 
+void CnnLoop::SetLevelStructures(const vector<Structure>& level_strts)
+{
+  level_strts_ = level_strts;
+}
+
 const VariableSet& CnnLoop::GetVariableSet(void) const
 {
   return *varset_;
@@ -54,6 +60,11 @@ const Structure& CnnLoop::GetOnStructure(void) const
   return *on_strt_;
 }
 
+const vector<Structure>& CnnLoop::GetLevelStructures(void) const
+{
+  return level_strts_;
+}
+
 void CnnLoop::MoveFullyTiledToInnerMost(void)
 {
   if (varset_->GetOc() == varset_->GetToc()) {
@@ -65,8 +76,10 @@ void CnnLoop::MoveFullyTiledToInnerMost(void)
     off_strt_->SetIcFullyTiled();
   }
   //NOTE (MinsuKim): OW stands for output map in this case.
+  // The batch loop is part of the output map.
   if (varset_->GetOw() == varset_->GetTow() &&
-      varset_->GetOh() == varset_->GetToh()) {
+      varset_->GetOh() == varset_->GetToh() &&
+      varset_->GetN() == varset_->GetTn()) {
     off_strt_->MoveToInnerMost(OUTPUT_MAP);
     off_strt_->SetOmFullyTiled();
   }
@@ -0,0 +1,163 @@
+#include "loop/cost_kernel.h"
+
+#include <float.h>
+
+#include "general/data_type.h"
+
+using loop::CostKernel;
+using loop::CostBlock;
+
+// Clone the kernels for the widest vector unit of the host. The lane loops
+// below are plain C++, so every clone computes bit-identical results.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define COST_KERNEL_CLONES \
+  __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define COST_KERNEL_CLONES
+#endif
+
+// Same bit positions as 1 << Stationary.
+static const int kInputStationary  = 1 << 0;
+static const int kWeightStationary = 1 << 1;
+static const int kOutputStationary = 1 << 2;
+
+void CostKernel::Init(const SearchContext& ctx, int stationary,
+                      const int* reach_flags)
+{
+  const int* dim = ctx.dim;
+  input_size_  = (double)dim[DataDimension::IW] * dim[DataDimension::IH] *
+                 dim[DataDimension::IC] * dim[DataDimension::N] * ctx.groups;
+  weight_size_ = (double)dim[DataDimension::KW] * dim[DataDimension::KH] *
+                 dim[DataDimension::IC] * dim[DataDimension::OC];
+  output_size_ = (double)dim[DataDimension::OW] * dim[DataDimension::OH] *
+                 dim[DataDimension::OC] * dim[DataDimension::N];
+  input_mem_size_   = ctx.input_mem_size;
+  weight_mem_size_  = ctx.weight_mem_size;
+  output_mem_size_  = ctx.output_mem_size;
+  input_half_size_  = ctx.input_mem_size / 2;
+  weight_half_size_ = ctx.weight_mem_size / 2;
+  output_half_size_ = ctx.output_mem_size / 2;
+
+  long int num_ops = (long int)dim[DataDimension::KW] *
+                     dim[DataDimension::KH] * dim[DataDimension::IC] *
+                     dim[DataDimension::OW] * dim[DataDimension::OH] *
+                     dim[DataDimension::OC] * dim[DataDimension::N];
+  peak_perf_ = ctx.frequency * ctx.num_pe;
+  ops_bandwidth_ = num_ops * ctx.bandwidth;
+
+  stationary_ = stationary;
+  for (int m = 0 ; m < kFullyTiledMaskCnt ; m++)
+    reach_flags_[m] = (stationary < 0) ? reach_flags[m] : 0;
+}
+
+COST_KERNEL_CLONES
+int CostKernel::Overflow(CostBlock* block) const
+{
+  const int* iw = block->tile[DataDimension::IW];
+  const int* ih = block->tile[DataDimension::IH];
+  const int* ic = block->tile[DataDimension::IC];
+  const int* kw = block->tile[DataDimension::KW];
+  const int* kh = block->tile[DataDimension::KH];
+  const int* ow = block->tile[DataDimension::OW];
+  const int* oh = block->tile[DataDimension::OH];
+  const int* oc = block->tile[DataDimension::OC];
+  const int* bn = block->tile[DataDimension::N];
+  const double* group_span = block->group_span;
+  const double bytes = sizeof(DataType);
+  const int n = block->size;
+  int fit_cnt = 0;
+  for (int i = 0 ; i < n ; i++) {
+    double on_input  = (double)iw[i] * ih[i] * ic[i] * bn[i] * group_span[i];
+    double on_weight = (double)kw[i] * kh[i] * ic[i] * oc[i];
+    double on_output = (double)ow[i] * oh[i] * oc[i] * bn[i];
+    // If data is not fully tiled, it is double buffered.
+    double input_mem  = (on_input  < input_size_)  ? input_half_size_  :
+                                                     input_mem_size_;
+    double weight_mem = (on_weight < weight_size_) ? weight_half_size_ :
+                                                     weight_mem_size_;
+    double output_mem = (on_output < output_size_) ? output_half_size_ :
+                                                     output_mem_size_;
+    block->overflow[i] = (on_input  * bytes > input_mem)  |
+                         (on_weight * bytes > weight_mem) |
+                         (on_output * bytes > output_mem);
+    fit_cnt += !block->overflow[i];
+  }
+  return fit_cnt;
+}
+
+COST_KERNEL_CLONES
+void CostKernel::Evaluate(CostBlock* block) const
+{
+  const int* q_kw = block->quot[DataDimension::KW];
+  const int* q_kh = block->quot[DataDimension::KH];
+  const int* q_ic = block->quot[DataDimension::IC];
+  const int* q_ow = block->quot[DataDimension::OW];
+  const int* q_oh = block->quot[DataDimension::OH];
+  const int* q_oc = block->quot[DataDimension::OC];
+  const int* q_bn = block->quot[DataDimension::N];
+  const double* q_group = block->group_quot;
+  const double* pe_util = block->pe_util;
+  const double bytes = sizeof(DataType);
+  const double correction_constant = 1000.0;
+  double* edp = block->edp;
+  const int n = block->size;
+
+  if (stationary_ >= 0) { // Same reload model as every loop order below.
+    const double input_fixed  = (stationary_ == 0) ? 1.0 : 0.0;
+    const double weight_fixed = (stationary_ == 1) ? 1.0 : 0.0;
+    const double output_fixed = (stationary_ == 2) ? 1.0 : 0.0;
+    for (int i = 0 ; i < n ; i++) {
+      double km = (double)q_kw[i] * q_kh[i];
+      double input_reload  = input_fixed  ? 1.0 :
+                             km * q_group[i];
+      double weight_reload = weight_fixed ? 1.0 :
+                             (double)q_ow[i] * q_oh[i] * q_bn[i];
+      double psum_reload   = output_fixed ? 0.0 : km * q_ic[i] - 1.0;
+      double dram = (input_reload  * input_size_  +
+                     weight_reload * weight_size_ +
+                     (2.0 * psum_reload + 1.0) * output_size_) * bytes;
+      double pe_perf = peak_perf_ * pe_util[i];
+      double mem_perf = ops_bandwidth_ / dram;
+      double perf = (mem_perf < pe_perf) ? mem_perf : pe_perf;
+      edp[i] = dram / perf / correction_constant;
+    }
+    return;
+  }
+  // Every loop order. Only the stationary flags reachable in the block
+  // are costed, and each lane keeps the ones reachable by itself.
+  int reach[kCostBlockLen];
+  int block_reach = 0;
+  for (int i = 0 ; i < n ; i++) {
+    int mask = ((q_kw[i] == 1 && q_kh[i] == 1) << 0) |
+               ((q_ic[i] == 1) << 1) |
+               ((q_ow[i] == 1 && q_oh[i] == 1 && q_bn[i] == 1) << 2) |
+               ((q_oc[i] == 1) << 3);
+    reach[i] = reach_flags_[mask];
+    block_reach |= reach[i];
+    edp[i] = DBL_MAX;
+  }
+  for (int flags = 0 ; flags < 8 ; flags++) {
+    if (!(block_reach & (1 << flags))) continue;
+    const bool input_fixed  = flags & kInputStationary;
+    const bool weight_fixed = flags & kWeightStationary;
+    const bool output_fixed = flags & kOutputStationary;
+    for (int i = 0 ; i < n ; i++) {
+      // Reload model of OffChipAccessAnalyzer.
+      double km = (double)q_kw[i] * q_kh[i];
+      double input_reload  = input_fixed  ? 1.0 :
+                             km * q_group[i];
+      double weight_reload = weight_fixed ? 1.0 :
+                             (double)q_ow[i] * q_oh[i] * q_bn[i];
+      double psum_reload   = output_fixed ? 0.0 : km * q_ic[i] - 1.0;
+      double dram = (input_reload  * input_size_  +
+                     weight_reload * weight_size_ +
+                     (2.0 * psum_reload + 1.0) * output_size_) * bytes;
+      double pe_perf = peak_perf_ * pe_util[i];
+      double mem_perf = ops_bandwidth_ / dram;
+      double perf = (mem_perf < pe_perf) ? mem_perf : pe_perf;
+      double flags_edp = dram / perf / correction_constant;
+      bool is_reached = (reach[i] >> flags) & 1;
+      edp[i] = (is_reached && flags_edp < edp[i]) ? flags_edp : edp[i];
+    }
+  }
+}
@@ -0,0 +1,136 @@
+#include "loop/exhaustive_engine.h"
+
+#include <float.h>
+#include <limits.h>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+using std::thread;
+using std::min;
+using std::max;
+
+using loop::ExhaustiveEngine;
+using loop::TilingSpace;
+using loop::SearchResult;
+using loop::SearchChunk;
+using loop::EncodedItr;
+
+SearchResult ExhaustiveEngine::Search(TilingSpace* space,
+                                      unsigned int num_threads)
+{
+  space_ = space;
+  num_threads_ = num_threads;
+  has_feasible_ = false;
+  ResetStats(num_threads_);
+  queues_.clear();
+  for (size_t thr = 0 ; thr < num_threads_ ; thr++)
+    queues_.push_back(unique_ptr<SearchQueue>(new SearchQueue()));
+  DistributeChunks();
+
+  vector<SearchResult> best_result(num_threads_);
+  for (SearchResult& result : best_result) {
+    result.cand = TilingCandidate();
+    result.edp = DBL_MAX;
+    result.itr = 0;
+    result.order = -1;
+  }
+  EncodedItr total = (end_ > 0) ? end_ - begin_ + 1 : CountTilings(*space_);
+  StartProgress(total);
+  vector<thread> workers;
+  for (unsigned int thr = 0 ; thr < num_threads_ ; thr++) {
+    workers.push_back(thread(&ExhaustiveEngine::SearchWorker, this, thr,
+                             &best_result[thr]));
+  }
+  for (thread& worker : workers)
+    worker.join();
+  progress_bar_.finish();
+
+  SearchResult final_result = best_result[0];
+  for (size_t thr = 1 ; thr < num_threads_ ; thr++)
+    MergeResult(best_result[thr], &final_result);
+  FinishSearch(final_result);
+  return final_result;
+}
+
+void ExhaustiveEngine::SetRange(EncodedItr begin, EncodedItr end)
+{
+  begin_ = begin;
+  end_ = end;
+}
+
+void ExhaustiveEngine::DistributeChunks(void)
+{
+  if (end_ > 0) DistributeRange(begin_, end_);
+  else          DistributeRange(1, CountTilings(*space_));
+}
+
+EncodedItr ExhaustiveEngine::VisitChunk(unsigned int thr,
+                                        const SearchChunk& chunk,
+                                        SearchResult* best)
+{
+  space_->EvaluateRange(thr, chunk.first, chunk.second, best);
+  return chunk.second - chunk.first + 1;
+}
+
+void ExhaustiveEngine::DistributeRange(EncodedItr begin, EncodedItr end)
+{
+  EncodedItr job_cnt = end - begin + 1;
+  EncodedItr chunk_size = max((EncodedItr)1,
+                              job_cnt/(num_threads_*kChunksPerThread));
+  // Each worker owns a contiguous range first.
+  for (size_t thr = 0 ; thr < num_threads_ ; thr++) {
+    EncodedItr first = begin + thr*(job_cnt / num_threads_);
+    EncodedItr last  = (thr < num_threads_-1) ?
+                       begin + (thr+1)*(job_cnt / num_threads_) - 1 : end;
+    for ( ; first <= last ; first += chunk_size)
+      queues_[thr]->Push({ first, min(first+chunk_size-1, last) });
+  }
+}
+
+void ExhaustiveEngine::SearchWorker(unsigned int thr, SearchResult* best)
+{
+  SearchChunk chunk;
+
+  while (GetChunk(thr, &chunk)) {
+    auto chunk_start = std::chrono::steady_clock::now();
+    EncodedItr covered = VisitChunk(thr, chunk, best);
+    std::chrono::duration<double, std::milli> chunk_time =
+      std::chrono::steady_clock::now() - chunk_start;
+    busy_time_[thr] += chunk_time.count();
+    if (best->edp < DBL_MAX) has_feasible_ = true;
+    IncreaseProgress(covered);
+  }
+}
+
+bool ExhaustiveEngine::GetChunk(unsigned int thr, SearchChunk* chunk)
+{
+  if (IsStopped()) return false;
+  if (queues_[thr]->Pop(chunk)) return true;
+  // Own queue is empty. Steal the farthest work of other workers.
+  for (unsigned int i = 1 ; i < num_threads_ ; i++) {
+    if (queues_[(thr+i) % num_threads_]->Steal(chunk)) {
+      steal_cnt_[thr]++;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ExhaustiveEngine::StartProgress(EncodedItr total)
+{
+  // tqdm counts in int, so large spaces are shown in coarser steps.
+  progress_ = 0;
+  progress_total_ = total;
+  progress_scale_ = total / INT_MAX + 1;
+  progress_bar_.progress(0, progress_total_ / progress_scale_);
+}
+
+void ExhaustiveEngine::IncreaseProgress(EncodedItr interval)
+{
+  mtx_lock_.lock();
+  progress_ += interval;
+  progress_bar_.progress(progress_ / progress_scale_,
+                         progress_total_ / progress_scale_);
+  mtx_lock_.unlock();
+}
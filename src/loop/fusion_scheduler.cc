@@ -0,0 +1,311 @@
+#include "loop/fusion_scheduler.h"
+
+#include <glog/logging.h>
+#include <algorithm>
+#include <memory>
+
+#include "general/data_type.h"
+#include "general/utils.h"
+#include "parameter/parameter.h"
+#include "loop/scheduler.h"
+#include "graph/conv.h"
+#include "graph/max_pool.h"
+
+using loop::FusionScheduler;
+using loop::FusedLayer;
+using loop::FusionPlan;
+using loop::Scheduler;
+using parameter::Parameter;
+using graph::layer::Convolution;
+using graph::layer::MaxPool;
+using graph::data::Data4d;
+
+using std::endl;
+using std::min;
+using std::max;
+using std::unique_ptr;
+
+FusionScheduler::FusionScheduler( const CnnLoop& head_loop,
+                                  const vector<const Layer*>& chain,
+                                  const char* search_mode)
+  : head_(new CnnLoop(head_loop)), search_mode_(search_mode)
+{
+  const VariableSet& head = head_loop.GetVariableSet();
+  batch_ = head.GetN();
+  FusedLayer conv;
+  conv.in_w   = head.GetIw();
+  conv.in_h   = head.GetIh();
+  conv.in_c   = head.GetIc() * head.GetGroups();
+  conv.out_w  = head.GetOw();
+  conv.out_h  = head.GetOh();
+  conv.out_c  = head.GetOc();
+  conv.ksize  = head.GetKw();
+  conv.stride = head.GetStride();
+  conv.pad    = head.GetPw();
+  conv.weight_size = (long int)head.GetKw() * head.GetKh() * head.GetIc() *
+                     head.GetOc();
+  conv.ops_per_out = (long int)head.GetKw() * head.GetKh() * head.GetIc();
+  conv.is_elementwise = false;
+  layers_.push_back(conv);
+
+  for (const Layer* layer : chain) {
+    const FusedLayer& prev = layers_.back();
+    Data4d input(batch_, prev.out_c, prev.out_h, prev.out_w);
+    unique_ptr<Data4d> output(dynamic_cast<Data4d*>(layer->GetOutput({&input})));
+    FusedLayer fused;
+    fused.in_w  = prev.out_w;
+    fused.in_h  = prev.out_h;
+    fused.in_c  = prev.out_c;
+    fused.out_w = output->GetWidth();
+    fused.out_h = output->GetHeight();
+    fused.out_c = output->GetChannel();
+    fused.ksize = 1;
+    fused.stride = 1;
+    fused.pad = 0;
+    fused.weight_size = 0;
+    fused.ops_per_out = 0;
+    fused.is_elementwise = true;
+    if (const Convolution* c = dynamic_cast<const Convolution*>(layer)) {
+      fused.ksize  = c->GetKsize();
+      fused.stride = c->GetStride();
+      fused.pad    = c->GetPadding();
+      fused.weight_size = (long int)c->GetKsize() * c->GetKsize() *
+                          fused.in_c * fused.out_c;
+      fused.ops_per_out = (long int)c->GetKsize()*c->GetKsize()*fused.in_c;
+      fused.is_elementwise = false;
+    } else if (const MaxPool* p = dynamic_cast<const MaxPool*>(layer)) {
+      // MaxPool pads half of the padding on the leading side.
+      fused.ksize  = p->GetKsize();
+      fused.stride = p->GetStride();
+      fused.pad    = p->GetPadding() / 2;
+      fused.ops_per_out = (long int)p->GetKsize() * p->GetKsize();
+      fused.is_elementwise = false;
+    }
+    CHECK(fused.out_w > 0 && fused.out_h > 0 && fused.out_c > 0)
+      << "Fused layer " << layers_.size() << " has no output";
+    layers_.push_back(fused);
+  }
+  /* #region Logging */
+  LOG(INFO) << "Build fused layer chain.";
+  for (size_t l = 0 ; l < layers_.size() ; l++) {
+    LOG(INFO) << "  Layer " << l << ": " << layers_[l].in_w << "x"
+              << layers_[l].in_h << "x" << layers_[l].in_c << " -> "
+              << layers_[l].out_w << "x" << layers_[l].out_h << "x"
+              << layers_[l].out_c << ", window " << layers_[l].ksize
+              << "/" << layers_[l].stride << "/" << layers_[l].pad;
+  }
+  /* #endregion */
+}
+
+FusionPlan FusionScheduler::SearchFusedTiling(const Architecture& arch) const
+{
+  const long int data_size = sizeof(DataType);
+  const FusedLayer& first = layers_.front();
+  const FusedLayer& last = layers_.back();
+  const size_t layer_cnt = layers_.size();
+
+  long int num_pe = 0;
+  for (const vector<int>& pe_dim : arch.GetPeDim())
+    num_pe += (long int)pe_dim[0] * pe_dim[1];
+  const double peak_perf = arch.GetFrequency() * num_pe; // ops/ns
+  const double bandwidth = arch.GetBandwidth();          // Bytes/ns
+
+  FusionPlan best;
+  long int weight_size = 0, filter_size = 0;
+  for (size_t l = 0 ; l < layer_cnt ; l++) {
+    const FusedLayer& layer = layers_[l];
+    long int layer_bytes = GetLayerwiseDramBytes(l, arch);
+    best.num_ops += GetLayerOps(layer);
+    best.layerwise_dram_bytes += layer_bytes;
+    best.layerwise_latency += max(GetLayerOps(layer) / peak_perf,
+                                  layer_bytes / bandwidth);
+    weight_size += layer.weight_size;
+    filter_size = max(filter_size, layer.weight_size / layer.out_c);
+  }
+  // Weights stay on-chip if all fit, or every tile streams them filter by
+  // filter through double buffers.
+  bool is_weight_resident = weight_size*data_size <= arch.GetWeightMemSize();
+  if (!is_weight_resident &&
+      2 * filter_size * data_size > arch.GetWeightMemSize()) {
+    LOG(WARNING) << "Weights of a fused layer do not fit on-chip.";
+    return best;
+  }
+
+  vector<int> tiles_w, tiles_h;
+  GetTileSpace(last.out_w, &tiles_w);
+  GetTileSpace(last.out_h, &tiles_h);
+  // Extents of width and height are independent, so they are computed once.
+  vector<vector<long int>> sum_w(tiles_w.size()), sum_h(tiles_h.size());
+  vector<vector<int>> max_w(tiles_w.size()), max_h(tiles_h.size());
+  for (size_t i = 0 ; i < tiles_w.size() ; i++)
+    GetHaloExtents(true, tiles_w[i], &sum_w[i], &max_w[i]);
+  for (size_t j = 0 ; j < tiles_h.size() ; j++)
+    GetHaloExtents(false, tiles_h[j], &sum_h[j], &max_h[j]);
+
+  for (size_t i = 0 ; i < tiles_w.size() ; i++) {
+    for (size_t j = 0 ; j < tiles_h.size() ; j++) {
+      long int tile_cnt = (long int)CeilDiv(last.out_w, tiles_w[i]) *
+                          CeilDiv(last.out_h, tiles_h[j]) * batch_;
+      // Data crossing the chip boundary is double buffered unless it is
+      // loaded once, like Scheduler::IsMemorySizeOverflow.
+      long int buf_cnt = (tile_cnt > 1) ? 2 : 1;
+      long int input_bytes = (long int)first.in_c * max_w[i][0] *
+                             max_h[j][0] * data_size * buf_cnt;
+      long int output_bytes = (long int)last.out_c * tiles_w[i] *
+                              tiles_h[j] * data_size * buf_cnt;
+      // Intermediate tiles are single buffered. Element-wise layers run
+      // in place on the tile of the layer before.
+      for (size_t l = 0 ; l+1 < layer_cnt ; l++) {
+        if (layers_[l+1].is_elementwise) continue;
+        output_bytes += (long int)layers_[l].out_c * max_w[i][l+1] *
+                        max_h[j][l+1] * data_size;
+      }
+      if (input_bytes > arch.GetInputMemSize() ||
+          output_bytes > arch.GetOutputMemSize())
+        continue;
+
+      FusionPlan plan = best;
+      plan.is_feasible = true;
+      plan.tile_w = tiles_w[i];
+      plan.tile_h = tiles_h[j];
+      plan.is_weight_resident = is_weight_resident;
+      plan.layer_tile_w.assign(max_w[i].begin()+1, max_w[i].end());
+      plan.layer_tile_h.assign(max_h[j].begin()+1, max_h[j].end());
+      long int weight_bytes = is_weight_resident ?
+        weight_size * data_size : 2 * filter_size * data_size;
+      plan.on_chip_bytes = input_bytes + weight_bytes + output_bytes;
+      plan.dram_bytes = (batch_ * first.in_c * sum_w[i][0] * sum_h[j][0] +
+                         (is_weight_resident ? 1 : tile_cnt) * weight_size +
+                         (long int)batch_ * last.out_c * last.out_w *
+                         last.out_h) * data_size;
+      long int fused_ops = 0;
+      for (size_t l = 0 ; l < layer_cnt ; l++) {
+        fused_ops += batch_ * layers_[l].out_c * layers_[l].ops_per_out *
+                     sum_w[i][l+1] * sum_h[j][l+1];
+      }
+      plan.recompute_ops = fused_ops - plan.num_ops;
+      plan.latency = max(fused_ops / peak_perf, plan.dram_bytes / bandwidth);
+
+      if (!best.is_feasible || plan.latency < best.latency ||
+          (plan.latency == best.latency &&
+           (plan.dram_bytes < best.dram_bytes ||
+            (plan.dram_bytes == best.dram_bytes &&
+             plan.on_chip_bytes < best.on_chip_bytes))))
+        best = plan;
+    }
+  }
+  /* #region Logging */
+  LOG(INFO) << "Search fused tiling.";
+  LOG(INFO) << "  Feasible: " << best.is_feasible;
+  LOG(INFO) << "  Output tile: " << best.tile_w << "x" << best.tile_h;
+  LOG(INFO) << "  Weight resident: " << best.is_weight_resident;
+  LOG(INFO) << "  On-chip bytes: " << best.on_chip_bytes;
+  LOG(INFO) << "  Fused DRAM bytes: " << best.dram_bytes;
+  LOG(INFO) << "  Layer-by-layer DRAM bytes: " << best.layerwise_dram_bytes;
+  LOG(INFO) << "  Recomputed operations: " << best.recompute_ops << " of "
+            << best.num_ops;
+  LOG(INFO) << "  Fused latency: " << best.latency << " ns";
+  LOG(INFO) << "  Layer-by-layer latency: " << best.layerwise_latency << " ns";
+  /* #endregion */
+  return best;
+}
+
+const vector<FusedLayer>& FusionScheduler::GetFusedLayers(void) const
+{
+  return layers_;
+}
+
+void FusionScheduler::GetHaloExtents( bool is_width, int tile,
+                                      vector<long int>* sum_ext,
+                                      vector<int>* max_ext) const
+{
+  // Index 0 is the input of the head, index l+1 is the output of layer l.
+  sum_ext->assign(layers_.size()+1, 0);
+  max_ext->assign(layers_.size()+1, 0);
+  const int len = is_width ? layers_.back().out_w : layers_.back().out_h;
+  for (int begin = 0 ; begin < len ; begin += tile) {
+    int o0 = begin, o1 = min(len, begin + tile);
+    for (int l = layers_.size()-1 ; l >= 0 ; l--) {
+      const FusedLayer& layer = layers_[l];
+      (*sum_ext)[l+1] += o1 - o0;
+      (*max_ext)[l+1] = max((*max_ext)[l+1], o1 - o0);
+      // Window of the first and the last output, clipped by padding.
+      const int in_len = is_width ? layer.in_w : layer.in_h;
+      int i0 = max(0, o0*layer.stride - layer.pad);
+      int i1 = min(in_len, (o1-1)*layer.stride - layer.pad + layer.ksize);
+      o0 = i0;
+      o1 = i1;
+    }
+    (*sum_ext)[0] += o1 - o0;
+    (*max_ext)[0] = max((*max_ext)[0], o1 - o0);
+  }
+}
+
+void FusionScheduler::GetTileSpace(int len, vector<int>* tiles) const
+{
+  // Tiles of the same count ceil(len/tile) load the same halos, so the
+  // smallest tile of each count has the smallest buffers.
+  for (int quot = len ; quot >= 1 ; quot--) {
+    int tile = CeilDiv(len, quot);
+    if (tiles->empty() || tiles->back() != tile) tiles->push_back(tile);
+  }
+}
+
+long int FusionScheduler::GetLayerwiseDramBytes(size_t l,
+                                                const Architecture& arch) const
+{
+  const FusedLayer& layer = layers_[l];
+  // Element-wise layers run before the output of the layer before leaves.
+  if (layer.is_elementwise) return 0;
+  if (l == 0) {
+    Scheduler sched;
+    return sched.GetLoopDramAccesses(*head_, arch);
+  }
+  if (layer.weight_size > 0) return ScheduleConvolution(layer, arch);
+  // MaxPool streams its input once and has no weights.
+  return ((long int)batch_ * layer.in_c * layer.in_w * layer.in_h +
+          (long int)batch_ * layer.out_c * layer.out_w * layer.out_h) *
+         sizeof(DataType);
+}
+
+long int FusionScheduler::ScheduleConvolution(const FusedLayer& layer,
+                                              const Architecture& arch) const
+{
+  // The scheduler derives tile shapes from the global layer shape, which
+  // the head loop still needs afterwards.
+  const int stride = kStride, filter_len = kFilter_len, padding = kPadding;
+  kStride     = layer.stride;
+  kFilter_len = layer.ksize;
+  kPadding    = layer.pad;
+  Parameter param;
+  param.SetStride(layer.stride);
+  param.SetIw(layer.in_w);
+  param.SetIh(layer.in_h);
+  param.SetIc(layer.in_c);
+  param.SetPw(layer.pad);
+  param.SetPh(layer.pad);
+  param.SetKw(layer.ksize);
+  param.SetKh(layer.ksize);
+  param.SetOc(layer.out_c);
+  param.SetBatch(batch_);
+
+  CnnLoop loop(param);
+  Scheduler sched;
+  sched.SetSearchMode(search_mode_.c_str());
+  unique_ptr<CnnLoop> best(sched.SearchBestLoopCase(loop, arch));
+  long int dram_bytes = sched.GetLoopDramAccesses(*best, arch);
+  kStride     = stride;
+  kFilter_len = filter_len;
+  kPadding    = padding;
+  /* #region Logging */
+  LOG(INFO) << "Fused convolution is scheduled alone.";
+  LOG(INFO) << "  DRAM bytes: " << dram_bytes;
+  /* #endregion */
+  return dram_bytes;
+}
+
+long int FusionScheduler::GetLayerOps(const FusedLayer& layer) const
+{
+  return (long int)batch_ * layer.out_c * layer.out_w * layer.out_h *
+         layer.ops_per_out;
+}
@@ -0,0 +1,98 @@
+#include "loop/genetic_engine.h"
+
+#include <float.h>
+#include <algorithm>
+
+using loop::GeneticEngine;
+using loop::TilingSpace;
+using loop::SearchResult;
+using loop::EncodedItr;
+
+SearchResult GeneticEngine::Search(TilingSpace* space,
+                                   unsigned int num_threads)
+{
+  SearchResult island_best[kGeneticIslandCnt];
+  RunJobs(num_threads, kGeneticIslandCnt,
+    [this, space, &island_best](unsigned int thr, int island) {
+      SearchIsland(space, thr, island, &island_best[island]);
+    }
+  );
+  SearchResult best = island_best[0];
+  for (int island = 1 ; island < kGeneticIslandCnt ; island++)
+    MergeResult(island_best[island], &best);
+  return best;
+}
+
+void GeneticEngine::SearchIsland( TilingSpace* space, unsigned int thr,
+                                  int island, SearchResult* best) const
+{
+  best->cand = TilingCandidate();
+  best->edp = DBL_MAX;
+  best->itr = 0;
+  best->order = -1;
+  uint64_t rng_state = GetJobSeed(island);
+  EncodedItr eval_budget = eval_cnt_ / kGeneticIslandCnt;
+  EncodedItr eval_cnt = 0;
+
+  vector<Individual> population(kGeneticPopulation), children;
+  for (Individual& ind : population) {
+    RandomizeDigits(*space, &rng_state, ind.digit);
+    Evaluate(space, thr, &rng_state, &ind, &eval_cnt);
+  }
+  while (eval_cnt < eval_budget) {
+    std::sort(population.begin(), population.end(), IsBetter);
+    children.assign(population.begin(),
+                    population.begin() + kGeneticEliteCnt);
+    while (children.size() < population.size()) {
+      const Individual& mother = SelectParent(population, &rng_state);
+      const Individual& father = SelectParent(population, &rng_state);
+      Individual child;
+      for (int i = 0 ; i < kTileDimensionCnt ; i++) {
+        child.digit[i] = NextRandomInt(&rng_state, 2) ? mother.digit[i] :
+                                                        father.digit[i];
+        if (NextRandomInt(&rng_state, kTileDimensionCnt) == 0) {
+          int radix = space->GetRadix(i);
+          if (NextRandomInt(&rng_state, 2))
+            child.digit[i] = NextRandomInt(&rng_state, radix);
+          else
+            child.digit[i] = std::max(0, std::min(radix-1,
+              child.digit[i] + (NextRandomInt(&rng_state, 2) ? 1 : -1)));
+        }
+      }
+      Evaluate(space, thr, &rng_state, &child, &eval_cnt);
+      children.push_back(child);
+    }
+    population.swap(children);
+  }
+  for (const Individual& ind : population)
+    MergeResult(ind.result, best);
+}
+
+void GeneticEngine::Evaluate( TilingSpace* space, unsigned int thr,
+                              uint64_t* rng_state, Individual* ind,
+                              EncodedItr* eval_cnt) const
+{
+  if (!RepairDigits(space, thr, rng_state, kGeneticRepairTry, ind->digit,
+                    &ind->result, eval_cnt)) {
+    ind->result.cand = TilingCandidate();
+    ind->result.edp = DBL_MAX;
+    ind->result.itr = 0;
+    ind->result.order = -1;
+  }
+}
+
+const GeneticEngine::Individual& GeneticEngine::SelectParent(
+  const vector<Individual>& population, uint64_t* rng_state) const
+{
+  const Individual& a = population[NextRandomInt(rng_state,
+                                                 population.size())];
+  const Individual& b = population[NextRandomInt(rng_state,
+                                                 population.size())];
+  return IsBetter(a, b) ? a : b;
+}
+
+bool GeneticEngine::IsBetter(const Individual& a, const Individual& b)
+{
+  return  a.result.edp < b.result.edp ||
+          (a.result.edp == b.result.edp && a.result.itr > b.result.itr);
+}
@@ -0,0 +1,270 @@
+#include "loop/network_scheduler.h"
+
+#include <glog/logging.h>
+#include <string.h>
+#include <float.h>
+#include <algorithm>
+#include <memory>
+
+#include "general/data_type.h"
+#include "general/utils.h"
+#include "parameter/parameter.h"
+#include "loop/cnn_loop.h"
+#include "loop/scheduler.h"
+#include "graph/conv.h"
+#include "graph/max_pool.h"
+
+using loop::NetworkScheduler;
+using loop::NetworkPlan;
+using loop::LayerPlan;
+using loop::Scheduler;
+using loop::CnnLoop;
+using parameter::Parameter;
+using graph::Vertex;
+using graph::layer::Convolution;
+using graph::layer::MaxPool;
+
+using std::endl;
+using std::min;
+using std::to_string;
+using std::unique_ptr;
+
+NetworkScheduler::NetworkScheduler( const Network& network,
+                                    const Architecture& arch,
+                                    const char* search_mode)
+  : arch_(arch)
+{
+  long int num_pe = 0;
+  for (const vector<int>& pe_dim : arch.GetPeDim())
+    num_pe += (long int)pe_dim[0] * pe_dim[1];
+  peak_perf_ = arch.GetFrequency() * num_pe;
+
+  int conv_cnt = 0, pool_cnt = 0;
+  for (Vertex* vertex = network.GetHeader() ; vertex != nullptr ; ) {
+    CHECK(vertex->GetIndegrees().size() == 1 &&
+          vertex->GetOutdegrees().size() == 1)
+      << "Network planner only schedules sequential networks.";
+    const Data4d& input =
+      *dynamic_cast<Data4d*>(vertex->GetIndegrees()[0]->GetData());
+    const Data4d& output =
+      *dynamic_cast<Data4d*>(vertex->GetOutdegrees()[0]->GetData());
+    long int output_bytes = (long int)output.GetBatch() * output.GetChannel() *
+                            output.GetHeight() * output.GetWidth() *
+                            sizeof(DataType);
+    const Layer* layer = vertex->GetLayer();
+    if (const Convolution* c = dynamic_cast<const Convolution*>(layer)) {
+      Stage stage;
+      stage.name = "conv_" + to_string(++conv_cnt);
+      stage.num_ops = (long int)output.GetBatch() * output.GetChannel() *
+                      output.GetHeight() * output.GetWidth() *
+                      c->GetKsize() * c->GetKsize() * input.GetChannel();
+      stage.output_bytes = output_bytes;
+      SearchConvolution(input, c->GetKsize(), c->GetStride(), c->GetPadding(),
+                        c->GetChannel(), search_mode, &stage);
+      stages_.push_back(stage);
+    } else if (const MaxPool* p = dynamic_cast<const MaxPool*>(layer)) {
+      // Pooling streams its input once and has no weights.
+      Stage stage;
+      stage.name = "pool_" + to_string(++pool_cnt);
+      stage.num_ops = (long int)output.GetBatch() * output.GetChannel() *
+                      output.GetHeight() * output.GetWidth() *
+                      p->GetKsize() * p->GetKsize();
+      stage.output_bytes = output_bytes;
+      LayerOption option;
+      option.data_bytes[Stationary::INPUT] =
+        (long int)input.GetBatch() * input.GetChannel() * input.GetHeight() *
+        input.GetWidth() * sizeof(DataType);
+      option.data_bytes[Stationary::WEIGHT] = 0;
+      option.data_bytes[Stationary::OUTPUT] = output_bytes;
+      option.output_buf_bytes = 0;
+      option.pe_util = 1.0;
+      stage.options.push_back(option);
+      stages_.push_back(stage);
+    } else if (!stages_.empty()) {
+      // Element-wise layers run before the output leaves the layer before.
+      stages_.back().output_bytes = output_bytes;
+    }
+    vector<Vertex*> next = vertex->GetOutAdjacents();
+    vertex = next.empty() ? nullptr : next[0];
+  }
+  CHECK(!stages_.empty()) << "Network has no convolution or pool layer.";
+  /* #region Logging */
+  LOG(INFO) << "Build network stages.";
+  for (const Stage& stage : stages_) {
+    LOG(INFO) << "  " << stage.name << ": " << stage.num_ops << " ops, "
+              << stage.output_bytes << " output Bytes, "
+              << stage.options.size() << " schedules";
+  }
+  /* #endregion */
+}
+
+void NetworkScheduler::SetObjective(const char* objective)
+{
+  if (strcmp(objective, S_LATENCY) == 0)
+    objective_ = NetworkObjective::LATENCY;
+  else if (strcmp(objective, S_ENERGY) == 0)
+    objective_ = NetworkObjective::ENERGY;
+  else
+    LOG(ERROR) << "Invalid network objective: " << objective;
+}
+
+NetworkPlan NetworkScheduler::SearchNetworkPlan(void) const
+{
+  const size_t stage_cnt = stages_.size();
+  // cost[r] is the best objective of the stages so far whose last output
+  // is resident (r=1) or stored (r=0). from[i][r] remembers how stage i
+  // reached it.
+  struct Choice { size_t option; bool is_input_resident; };
+  double cost[2] = {0.0, DBL_MAX};
+  vector<Choice> from[2];
+  from[0].resize(stage_cnt);
+  from[1].resize(stage_cnt);
+  for (size_t i = 0 ; i < stage_cnt ; i++) {
+    double next_cost[2] = {DBL_MAX, DBL_MAX};
+    // The network input and output are always off-chip.
+    for (int r_out = 0 ; r_out <= ((i+1 < stage_cnt) ? 1 : 0) ; r_out++) {
+      for (int r_in = 0 ; r_in <= ((i > 0) ? 1 : 0) ; r_in++) {
+        if (cost[r_in] == DBL_MAX) continue;
+        for (size_t o = 0 ; o < stages_[i].options.size() ; o++) {
+          LayerPlan plan;
+          if (!MakeLayerPlan(i, o, r_in, r_out, &plan)) continue;
+          double c = cost[r_in] + GetObjective(plan);
+          if (c < next_cost[r_out]) {
+            next_cost[r_out] = c;
+            from[r_out][i] = {o, r_in == 1};
+          }
+        }
+      }
+    }
+    cost[0] = next_cost[0];
+    cost[1] = next_cost[1];
+  }
+  CHECK(cost[0] != DBL_MAX) << "No network plan fits on-chip memory.";
+
+  NetworkPlan net_plan;
+  net_plan.layers.resize(stage_cnt);
+  bool r_out = false;
+  for (size_t i = stage_cnt ; i-- > 0 ; ) {
+    const Choice& choice = from[r_out][i];
+    MakeLayerPlan(i, choice.option, choice.is_input_resident, r_out,
+                  &net_plan.layers[i]);
+    r_out = choice.is_input_resident;
+  }
+  for (size_t i = 0 ; i < stage_cnt ; i++) {
+    const LayerPlan& plan = net_plan.layers[i];
+    net_plan.dram_bytes += plan.dram_bytes;
+    net_plan.latency += plan.latency;
+    net_plan.energy += plan.energy;
+    // Layer by layer, each stage takes its best schedule alone.
+    LayerPlan best, layerwise;
+    bool has_plan = false;
+    for (size_t o = 0 ; o < stages_[i].options.size() ; o++) {
+      if (!MakeLayerPlan(i, o, false, false, &layerwise)) continue;
+      if (!has_plan || GetObjective(layerwise) < GetObjective(best))
+        best = layerwise;
+      has_plan = true;
+    }
+    CHECK(has_plan) << stages_[i].name << " has no schedule.";
+    net_plan.layerwise_dram_bytes += best.dram_bytes;
+    net_plan.layerwise_latency += best.latency;
+    net_plan.layerwise_energy += best.energy;
+  }
+  /* #region Logging */
+  LOG(INFO) << "Search network plan.";
+  for (const LayerPlan& plan : net_plan.layers) {
+    LOG(INFO) << "  " << plan.name << ": point " << plan.point
+              << ", input resident " << plan.is_input_resident
+              << ", output resident " << plan.is_output_resident
+              << ", " << plan.dram_bytes << " Bytes, "
+              << plan.latency << " ns, " << plan.energy << " nJ";
+  }
+  LOG(INFO) << "  Network: " << net_plan.dram_bytes << " Bytes, "
+            << net_plan.latency << " ns, " << net_plan.energy << " nJ";
+  LOG(INFO) << "  Layer by layer: " << net_plan.layerwise_dram_bytes
+            << " Bytes, " << net_plan.layerwise_latency << " ns, "
+            << net_plan.layerwise_energy << " nJ";
+  /* #endregion */
+  return net_plan;
+}
+
+void NetworkScheduler::SearchConvolution( const Data4d& input, int ksize,
+                                          int stride, int padding,
+                                          int channel, const char* search_mode,
+                                          Stage* stage)
+{
+  // The scheduler derives tile shapes from the global layer shape.
+  kStride     = stride;
+  kFilter_len = ksize;
+  kPadding    = padding;
+  Parameter param;
+  param.SetStride(stride);
+  param.SetIw(input.GetWidth());
+  param.SetIh(input.GetHeight());
+  param.SetIc(input.GetChannel());
+  param.SetPw(padding);
+  param.SetPh(padding);
+  param.SetKw(ksize);
+  param.SetKh(ksize);
+  param.SetOc(channel);
+  param.SetBatch(input.GetBatch());
+
+  CnnLoop loop(param);
+  Scheduler sched;
+  sched.SetSearchMode(search_mode);
+  sched.SetParetoFrontier(true);
+  unique_ptr<CnnLoop> best(sched.SearchBestLoopCase(loop, arch_));
+  for (const ParetoPoint& point : sched.GetParetoFrontier()) {
+    LayerOption option;
+    std::copy(point.data_bytes, point.data_bytes+3, option.data_bytes);
+    option.output_buf_bytes = point.output_buf_bytes;
+    option.pe_util = point.pe_util;
+    stage->options.push_back(option);
+  }
+  CHECK(!stage->options.empty()) << stage->name << " has no schedule.";
+}
+
+bool NetworkScheduler::MakeLayerPlan( size_t i, size_t option,
+                                      bool is_input_resident,
+                                      bool is_output_resident,
+                                      LayerPlan* plan) const
+{
+  const Stage& stage = stages_[i];
+  const LayerOption& opt = stage.options[option];
+  long int input_bytes = is_input_resident ? stages_[i-1].output_bytes : 0;
+  long int output_bytes = is_output_resident ? stage.output_bytes : 0;
+  long int output_mem_bytes = input_bytes +
+    (is_output_resident ? stage.output_bytes : opt.output_buf_bytes);
+  if (output_mem_bytes > arch_.GetOutputMemSize()) return false;
+
+  long int dram_bytes = opt.data_bytes[Stationary::WEIGHT];
+  if (!is_input_resident)  dram_bytes += opt.data_bytes[Stationary::INPUT];
+  if (!is_output_resident) dram_bytes += opt.data_bytes[Stationary::OUTPUT];
+  // Roofline like Scheduler::CalcPerformance.
+  double performance = peak_perf_ * opt.pe_util;
+  if (dram_bytes > 0)
+    performance = min(performance,
+                      stage.num_ops * arch_.GetBandwidth() / dram_bytes);
+  // Data crossing the chip boundary is written to and read from on-chip
+  // memory once. A resident activation is written by its producer and
+  // read by its consumer.
+  const double word_size = 4.0; // Energies are per 32 bits.
+  double on_chip_words = (2.0*dram_bytes + input_bytes + output_bytes) /
+                         word_size;
+
+  plan->name = stage.name;
+  plan->point = stage.name.compare(0, 4, "conv") == 0 ? (int)option : -1;
+  plan->is_input_resident = is_input_resident;
+  plan->is_output_resident = is_output_resident;
+  plan->dram_bytes = dram_bytes;
+  plan->latency = stage.num_ops / performance;
+  plan->energy = stage.num_ops * arch_.GetMacEnergy() +
+                 dram_bytes / word_size * arch_.GetOffChipEnergy() +
+                 on_chip_words * arch_.GetOnChipEnergy();
+  return true;
+}
+
+double NetworkScheduler::GetObjective(const LayerPlan& plan) const
+{
+  return (objective_ == NetworkObjective::LATENCY) ? plan.latency :
+                                                     plan.energy;
+}
@@ -0,0 +1,250 @@
+#include "loop/schedule_cache.h"
+
+#include <glog/logging.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+
+#include "loop/tiling_candidate.h"
+
+using loop::ScheduleCache;
+using loop::ScheduleKey;
+using loop::Variables;
+using loop::Structure;
+using arch::DataDimension;
+using arch::MemoryLevel;
+
+static const char kScheduleCacheMagic[8] = "EPLNSCH";
+
+static_assert(std::is_trivially_copyable<Variables>::value &&
+              std::is_trivially_copyable<Structure>::value,
+              "Schedule cache slots copy variables and structures by bytes");
+// Fixed words, PE arrays, PE structure and memory levels of MakeKey.
+static_assert(30 + (loop::kMaxPeArrayCnt*3 + 1) + 2*(loop::kDimensionCnt + 1) +
+              arch::kMaxMemLevelCnt*5 <= loop::kScheduleKeyLen,
+              "Schedule keys must fit every architecture the scheduler takes");
+
+ScheduleCache::ScheduleCache(const char* path)
+{
+  fd_ = open(path, O_RDWR | O_CREAT, 0644);
+  CHECK(fd_ >= 0) << "Cannot open schedule cache: " << path;
+  map_size_ = sizeof(Header) + kScheduleCacheSlotCnt*sizeof(Slot);
+  // The first process sizes the file and writes the header.
+  flock(fd_, LOCK_EX);
+  struct stat st;
+  CHECK(fstat(fd_, &st) == 0) << "Cannot stat schedule cache: " << path;
+  Header header;
+  memset(&header, 0, sizeof(Header));
+  if ((size_t)st.st_size >= sizeof(Header))
+    CHECK(pread(fd_, &header, sizeof(Header), 0) == sizeof(Header))
+      << "Cannot read schedule cache: " << path;
+  bool is_new = (header.magic[0] == '\0');
+  if (is_new) {
+    memcpy(header.magic, kScheduleCacheMagic, sizeof(header.magic));
+    header.version = kScheduleCacheVersion;
+    header.slot_size = sizeof(Slot);
+    header.slot_cnt = kScheduleCacheSlotCnt;
+    CHECK(ftruncate(fd_, map_size_) == 0 &&
+          pwrite(fd_, &header, sizeof(Header), 0) == sizeof(Header))
+      << "Cannot initialize schedule cache: " << path;
+  }
+  if (!IsValidHeader(header) || (!is_new && (size_t)st.st_size != map_size_)) {
+    LOG(WARNING) << "Schedule cache of another version is ignored: " << path;
+  } else {
+    map_ = mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map_ == MAP_FAILED) {
+      map_ = nullptr;
+      LOG(WARNING) << "Cannot map schedule cache: " << path;
+    }
+  }
+  flock(fd_, LOCK_UN);
+  /* #region Logging */
+  LOG(INFO) << "Schedule cache: " << path << (map_ ? "" : " (disabled)");
+  /* #endregion */
+}
+
+ScheduleCache::~ScheduleCache(void)
+{
+  if (map_) munmap(map_, map_size_);
+  if (fd_ >= 0) close(fd_);
+}
+
+bool ScheduleCache::MakeKey(const CnnLoop& loop, const Architecture& arch,
+                            const char* search_mode, const char* tile_enum,
+                            const char* loop_order, const char* intra_order,
+                            ScheduleKey* key)
+{
+  memset(key, 0, sizeof(ScheduleKey));
+  // Words past the end are counted but dropped, so the caller can tell.
+  int len = 0;
+  auto push = [key, &len](int64_t word) {
+    if (len < kScheduleKeyLen) key->word[len] = word;
+    len++;
+  };
+  auto push_double = [&push](double value) {
+    int64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    push(bits);
+  };
+  auto push_name = [&push](const char* name) { // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char* c = name ; *c ; c++)
+      hash = (hash ^ (unsigned char)*c) * 1099511628211ULL;
+    push((int64_t)hash);
+  };
+  push(PLANNER_VERSION_MAJOR);
+  push(PLANNER_VERSION_MINOR);
+  push(PLANNER_VERSION_PATCH);
+  push(kScheduleCacheVersion);
+  // Search mode and tile enumeration may find another loop.
+  push_name(search_mode);
+  push_name(tile_enum);
+  push(strcmp(loop_order, "all") == 0);
+  push(strcmp(intra_order, "all") == 0);
+  // Layer shape.
+  const Variables& vars = loop.GetVariableSet().GetOffLoopVariables();
+  push(vars.GetStride());
+  push(vars.GetIw());
+  push(vars.GetIh());
+  push(vars.GetIc());
+  push(vars.GetPw());
+  push(vars.GetPh());
+  push(vars.GetKw());
+  push(vars.GetKh());
+  push(vars.GetOw());
+  push(vars.GetOh());
+  push(vars.GetOc());
+  push(vars.GetN());
+  push(loop.GetVariableSet().GetGroups());
+  // Architecture.
+  push(arch.GetMacCycles());
+  push_double(arch.GetBandwidth());
+  push_double(arch.GetFrequency());
+  push_double(arch.GetMacEnergy());
+  push_double(arch.GetOnChipEnergy());
+  push_double(arch.GetOffChipEnergy());
+  push(arch.GetInputMemSize());
+  push(arch.GetWeightMemSize());
+  push(arch.GetOutputMemSize());
+  // PE arrays are pushed side by side, each side ended by -1.
+  for (const vector<int>& pe_dim : arch.GetPeDim()) {
+    for (int pe_len : pe_dim) push(pe_len);
+    push(-1);
+  }
+  push(-1);
+  for (const vector<DataDimension>& pe_strt : arch.GetPeStructure()) {
+    for (DataDimension d : pe_strt) push(d);
+    push(-1);
+  }
+  for (const MemoryLevel& level : arch.GetMemLevels()) {
+    push(level.input_mem_size);
+    push(level.weight_mem_size);
+    push(level.output_mem_size);
+    push_double(level.bandwidth);
+    push_double(level.energy_32);
+  }
+  if (len > kScheduleKeyLen) {
+    LOG(WARNING) << "Schedule key needs " << len << " words, more than "
+                 << kScheduleKeyLen << ". The layer is not cached.";
+    return false;
+  }
+  return true;
+}
+
+bool ScheduleCache::Find(const ScheduleKey& key, CnnLoop* loop) const
+{
+  if (!map_) return false;
+  uint64_t hash = GetHash(key);
+  bool is_found = false;
+  Slot* slots = GetSlots();
+  flock(fd_, LOCK_SH);
+  for (int p = 0 ; p < kScheduleCacheProbeLen ; p++) {
+    const Slot& slot = slots[(hash+p) % kScheduleCacheSlotCnt];
+    if (slot.state == SlotState::EMPTY) break;
+    if (slot.hash == hash &&
+        memcmp(&slot.key, &key, sizeof(ScheduleKey)) == 0) {
+      VariableSet* varset = new VariableSet(loop->GetVariableSet());
+      varset->SetOnLoopVariables(slot.on_loop_vars);
+      varset->SetParlLoopVariables(slot.parl_loop_vars);
+      varset->SetLevelLoopVariables(vector<Variables>(
+        slot.level_loop_vars, slot.level_loop_vars + slot.level_cnt));
+      loop->SetVariableSet(varset);
+      loop->SetOffStructure(new Structure(slot.off_strt));
+      loop->SetOnStructure(new Structure(slot.on_strt));
+      loop->SetLevelStructures(vector<Structure>(
+        slot.level_strts, slot.level_strts + slot.level_cnt));
+      is_found = true;
+      break;
+    }
+  }
+  flock(fd_, LOCK_UN);
+  return is_found;
+}
+
+void ScheduleCache::Insert(const ScheduleKey& key, const CnnLoop& loop)
+{
+  if (!map_) return;
+  uint64_t hash = GetHash(key);
+  bool is_inserted = false;
+  Slot* slots = GetSlots();
+  flock(fd_, LOCK_EX);
+  for (int p = 0 ; p < kScheduleCacheProbeLen ; p++) {
+    Slot& slot = slots[(hash+p) % kScheduleCacheSlotCnt];
+    if (slot.state == SlotState::READY) {
+      // Another process may have scheduled the same layer meanwhile.
+      if (slot.hash == hash &&
+          memcmp(&slot.key, &key, sizeof(ScheduleKey)) == 0) {
+        is_inserted = true;
+        break;
+      }
+      continue;
+    }
+    slot.hash = hash;
+    slot.key = key;
+    slot.on_loop_vars = loop.GetVariableSet().GetOnLoopVariables();
+    slot.parl_loop_vars = loop.GetVariableSet().GetParlLoopVariables();
+    slot.off_strt = loop.GetOffStructure();
+    slot.on_strt = loop.GetOnStructure();
+    slot.level_cnt = loop.GetLevelStructures().size();
+    for (uint64_t l = 0 ; l < slot.level_cnt ; l++) {
+      slot.level_loop_vars[l] =
+        loop.GetVariableSet().GetLevelLoopVariables()[l];
+      slot.level_strts[l] = loop.GetLevelStructures()[l];
+    }
+    __atomic_store_n(&slot.state, (uint64_t)SlotState::READY,
+                     __ATOMIC_RELEASE);
+    is_inserted = true;
+    break;
+  }
+  flock(fd_, LOCK_UN);
+  if (!is_inserted)
+    LOG(WARNING) << "Schedule cache is full around the key.";
+}
+
+uint64_t ScheduleCache::GetHash(const ScheduleKey& key) const
+{
+  // FNV-1a over the key.
+  uint64_t hash = 14695981039346656037ULL;
+  for (int w = 0 ; w < kScheduleKeyLen ; w++) {
+    hash ^= (uint64_t)key.word[w];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+bool ScheduleCache::IsValidHeader(const Header& header) const
+{
+  return  memcmp(header.magic, kScheduleCacheMagic, sizeof(header.magic)) == 0
+          && header.version == kScheduleCacheVersion
+          && header.slot_size == sizeof(Slot)
+          && header.slot_cnt == kScheduleCacheSlotCnt;
+}
+
+ScheduleCache::Slot* ScheduleCache::GetSlots(void) const
+{
+  return reinterpret_cast<Slot*>(static_cast<char*>(map_) + sizeof(Header));
+}
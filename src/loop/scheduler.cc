@@ -2,11 +2,18 @@
 
 #include <glog/logging.h>
 #include <float.h>
+#include <limits.h>
+#include <string.h>
 #include <assert.h>
 #include <algorithm>
 #include <memory>
 
 #include "loop/variable_set.h"
+#include "loop/exhaustive_engine.h"
+#include "loop/anytime_engine.h"
+#include "loop/branch_and_bound_engine.h"
+#include "loop/annealing_engine.h"
+#include "loop/genetic_engine.h"
 #include "general/data_type.h"
 #include "general/utils.h"
 
@@ -18,12 +25,149 @@ using std::unique_ptr;
 
 using loop::VariableSet;
 using loop::Stationary;
+using loop::SearchContext;
+using loop::TilingCandidate;
+using loop::TilingCursor;
+using loop::CostBlock;
+using loop::SearchResult;
+using loop::ShardResult;
+using loop::EncodedItr;
+using loop::ParetoPoint;
+using loop::SearchMode;
+using loop::TilingSpace;
+using loop::ExhaustiveEngine;
+using loop::AnytimeEngine;
+using loop::BranchAndBoundEngine;
+using loop::AnnealingEngine;
+using loop::GeneticEngine;
+using loop::Structure;
+using loop::Type;
+using loop::Location;
 using arch::DataDimension;
+using arch::MemoryLevel;
+
+// Encoding order of the tiling iterations from the least significant.
+static const DataDimension kEncodingOrder[] = {
+  DataDimension::KW, DataDimension::KH, DataDimension::OW,
+  DataDimension::OH, DataDimension::IC, DataDimension::OC, DataDimension::N
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! @brief      Tiling space of one layer for the search engines.
+//! @details    Digits index tile_space_ in the encoding order. Ranges of
+//!             ranks are walked by the tile traversal of the scheduler, so
+//!             the engines only decide which ranges to visit.
+////////////////////////////////////////////////////////////////////////////////
+class Scheduler::EngineSpace : public TilingSpace
+{
+  public:
+    EngineSpace(Scheduler* sched, const SearchContext& ctx,
+                const TilingCandidate& seed, Stationary s)
+      : sched_(sched), ctx_(ctx), seed_(seed), s_(s) {}
+
+    int GetRadix(int digit) const override
+    {
+      return sched_->GetItrCnt(kEncodingOrder[digit]);
+    }
+
+    bool Evaluate(unsigned int thr, const int* digit,
+                  SearchResult* result) override
+    {
+      TilingCandidate cand = seed_;
+      EncodedItr itr = 1;
+      for (int i = 0 ; i < kTileDimensionCnt ; i++) {
+        DataDimension d = kEncodingOrder[i];
+        sched_->SetCandidateTile(ctx_, seed_, d,
+                                 sched_->tile_space_[d][digit[i]], &cand);
+        itr += digit[i] * sched_->GetItrRadix(d);
+      }
+      sched_->thread_itr_cnt_[thr]++;
+      if (sched_->IsMemorySizeOverflow(ctx_, cand)) return false;
+      sched_->MakeParlLoopVariables(ctx_, 0, &cand);
+      int order;
+      double edp = sched_->GetSearchEdp(ctx_, cand, s_, &order);
+      *result = { cand, edp, itr, order };
+      return true;
+    }
+
+    bool Bound(const int* digit, int free_cnt, double* bound) const override
+    {
+      // Free digits are tiled smallest for the on-chip footprint and
+      // largest for the DRAM accesses. Both are monotonic in the tile size.
+      TilingCandidate min_cand = seed_, max_cand = seed_;
+      for (int i = 0 ; i < kTileDimensionCnt ; i++) {
+        DataDimension d = kEncodingOrder[i];
+        const vector<int>& tiles = sched_->tile_space_[d];
+        sched_->SetCandidateTile(ctx_, seed_, d,
+                                 (i < free_cnt) ? tiles.front() :
+                                                  tiles[digit[i]], &min_cand);
+        sched_->SetCandidateTile(ctx_, seed_, d,
+                                 (i < free_cnt) ? tiles.back() :
+                                                  tiles[digit[i]], &max_cand);
+      }
+      if (sched_->IsMemorySizeOverflowBound(ctx_, min_cand)) return false;
+      *bound = (sched_->loop_order_ == LoopOrderSearch::ALL_ORDERS) ?
+               sched_->GetBestOrderEdpLowerBound(ctx_, min_cand, max_cand) :
+               sched_->GetEdpLowerBound(ctx_, max_cand, s_);
+      return true;
+    }
+
+    void GetRankDigits(EncodedItr rank, int* digit) const override
+    {
+      if (sched_->tile_traversal_ == TileTraversal::GRAY_TRAVERSAL) {
+        TilingCursor cursor;
+        sched_->SeekTilingCursor(ctx_, seed_, rank-1, &cursor);
+        std::copy(cursor.digit, cursor.digit+kTileDimensionCnt, digit);
+        return;
+      }
+      EncodedItr encoded_it = rank-1;
+      for (int i = 0 ; i < kTileDimensionCnt ; i++) {
+        digit[i] = encoded_it % GetRadix(i);
+        encoded_it /= GetRadix(i);
+      }
+    }
+
+    void EvaluateRange( unsigned int thr, EncodedItr first, EncodedItr last,
+                        SearchResult* best) override
+    {
+      SearchChunk chunk = { first, last };
+      if (sched_->tile_traversal_ == TileTraversal::GRAY_TRAVERSAL)
+        sched_->SearchGrayCodeChunk(ctx_, seed_, s_, thr, chunk, best);
+      else
+        sched_->SearchDecodedChunk(ctx_, seed_, s_, thr, chunk, best);
+      sched_->thread_itr_cnt_[thr] += last - first + 1;
+    }
+
+  private:
+    Scheduler* sched_;
+    const SearchContext& ctx_;
+    const TilingCandidate& seed_;
+    Stationary s_;
+};
 
 Scheduler::Scheduler(void)
 {
   num_threads_ = thread::hardware_concurrency();
-  search_threads_ = new thread[num_threads_];
+  search_mode_ = SearchMode::EXHAUSTIVE;
+  tile_enum_ = TileEnumeration::FULL_TILES;
+  loop_order_ = LoopOrderSearch::ALL_ORDERS;
+  intra_order_ = IntraOrderSearch::ALL_INTRA_ORDERS;
+  tile_traversal_ = TileTraversal::GRAY_TRAVERSAL;
+  is_shard_ = false;
+  search_budget_ms_ = 0.0;
+  search_seed_ = 1;
+  search_eval_cnt_ = 1 << 18;
+  is_search_exact_ = true;
+  use_pareto_ = false;
+  // Every permutation of the off-chip loops, innermost first.
+  Type order[kLoopCnt] = {
+    Type::KERNEL_MAP, Type::INPUT_CHANNEL, Type::OUTPUT_MAP,
+    Type::OUTPUT_CHANNEL
+  };
+  for (int o = 0 ; o < kLoopOrderCnt ; o++) {
+    std::copy(order, order+kLoopCnt, loop_orders_[o]);
+    std::next_permutation(order, order+kLoopCnt);
+  }
   /* #region Logging */
   LOG(INFO) << "LoopScheduler is constructed.";
   LOG(INFO) << "  The number of threads: " << num_threads_;
@@ -32,26 +176,6 @@ Scheduler::Scheduler(void)
 
 Scheduler::~Scheduler(void)
 {
-  delete search_threads_;
-}
-
-void Scheduler::StartProgress(void)
-{
-  progress_ = 0;
-  progress_bar_.progress(progress_, total_itr_);
-}
-
-void Scheduler::IncreaseProgress(int interval)
-{
-  mtx_lock_.lock();
-  progress_ += interval;
-  progress_bar_.progress(progress_, total_itr_);
-  mtx_lock_.unlock();
-}
-
-void Scheduler::FinishProgress(void)
-{
-  progress_bar_.finish();
 }
 
 VariableSet* Scheduler::LoopInitializing( const VariableSet& varset, 
@@ -67,10 +191,13 @@ VariableSet* Scheduler::LoopInitializing( const VariableSet& varset,
   new_varset->SetTow(varset.GetOw());
   new_varset->SetToh(1);
   new_varset->SetToc(1);
+  new_varset->SetTn(1);
   // PE Utilization Optimizing
   const int row = 0, col = 1;
   for (int row_col = row ; row_col <= col ; row_col++) {
     vector<DataDimension> pe_strt = arch.GetPeStructure()[row_col];
+    // Tiles from here are the smallest searched ones. They fill the first PE
+    // array as with a single array, so more arrays keep its search space.
     int len = arch.GetPeDim()[0][row_col];
     for (DataDimension row_col_dim : pe_strt) {
       switch (row_col_dim) {
@@ -166,6 +293,7 @@ CnnLoop* Scheduler::LoopElimination(const CnnLoop& loop,
           best_varset->SetToh(best_varset->GetOh());
           best_varset->SetTiw(best_varset->GetIw());
           best_varset->SetTih(best_varset->GetIh());
+          best_varset->SetTn(best_varset->GetN());
           break;
         case DataDimension::IC:
           best_varset->SetTic(best_varset->GetIc());
@@ -212,7 +340,9 @@ CnnLoop* Scheduler::LoopElimination(const CnnLoop& loop,
           itr_varset->SetToh(itr_varset->GetOh());
           itr_varset->SetTiw(itr_varset->GetIw());
           itr_varset->SetTih(itr_varset->GetIh());
-          itr_elimination_cnt *= itr_varset->GetOw() * itr_varset->GetOh();
+          itr_varset->SetTn(itr_varset->GetN());
+          itr_elimination_cnt *= itr_varset->GetOw() * itr_varset->GetOh() *
+                                 itr_varset->GetN();
           break;
         case DataDimension::IC:
           itr_varset->SetTic(itr_varset->GetIc());
@@ -265,7 +395,8 @@ pair<CnnLoop*, Stationary> Scheduler::LoopInterchange(const CnnLoop& loop)
     }, {
       DataDimension::OW,
       ceil((double)varset.GetOw() / varset.GetTow()) *
-      ceil((double)varset.GetOh() / varset.GetToh())
+      ceil((double)varset.GetOh() / varset.GetToh()) *
+      ceil((double)varset.GetN() / varset.GetTn())
     }, {
       DataDimension::OC,
       ceil((double)varset.GetOc() / varset.GetToc())
@@ -299,6 +430,162 @@ pair<CnnLoop*, Stationary> Scheduler::LoopInterchange(const CnnLoop& loop)
 
 CnnLoop* Scheduler::SearchBestLoopCase( const CnnLoop& loop, 
                                         const Architecture& arch)
+{
+  if (!arch.GetMemLevels().empty()) return SearchMemoryLevels(loop, arch);
+  SearchContext ctx;
+  TilingCandidate seed;
+  Stationary s;
+  unique_ptr<CnnLoop> new_loop(PrepareSearch(loop, arch, &ctx, &seed, &s));
+  SearchResult final_result = SearchTilingSpace(ctx, seed, s, 1, total_itr_);
+  return FinishSearch(*new_loop, final_result);
+}
+
+CnnLoop* Scheduler::SearchMemoryLevels( const CnnLoop& loop,
+                                        const Architecture& arch)
+{
+  const vector<MemoryLevel>& levels = arch.GetMemLevels();
+  vector<Variables> level_vars;
+  vector<Structure> level_strts;
+  unique_ptr<CnnLoop> level_loop(new CnnLoop(loop));
+  unique_ptr<CnnLoop> level_result;
+  for (size_t l = 0 ; l <= levels.size() ; l++) {
+    // The last search tiles the innermost level for PE-local memory.
+    Architecture level_arch(arch);
+    level_arch.SetMemLevels(vector<MemoryLevel>());
+    if (l > 0)
+      level_arch.SetBandwidth(levels[l-1].bandwidth);
+    if (l < levels.size()) {
+      level_arch.SetInputMemSize(levels[l].input_mem_size);
+      level_arch.SetWeightMemSize(levels[l].weight_mem_size);
+      level_arch.SetOutputMemSize(levels[l].output_mem_size);
+    }
+    search_level_ = (l < levels.size()) ?
+                    "memory level " + std::to_string(l) : "PE-local memory";
+    level_result.reset(SearchBestLoopCase(*level_loop, level_arch));
+    search_level_.clear();
+    if (l == levels.size()) break;
+
+    level_vars.push_back(level_result->GetVariableSet().GetOnLoopVariables());
+    level_strts.push_back(level_result->GetOffStructure());
+    // Keep stride and padding of the layer, and shrink it to the tile.
+    VariableSet* level_varset = new VariableSet(loop.GetVariableSet());
+    level_varset->SetOffLoopVariables(level_vars.back());
+    level_varset->SetOnLoopVariables(level_vars.back());
+    level_loop.reset(new CnnLoop());
+    level_loop->SetVariableSet(level_varset);
+    /* #region Logging */
+    LOG(INFO) << "Memory level " << l << " is tiled.";
+    LOG(INFO) << "  TIW: " << level_vars.back().GetIw();
+    LOG(INFO) << "  TIH: " << level_vars.back().GetIh();
+    LOG(INFO) << "  TIC: " << level_vars.back().GetIc();
+    LOG(INFO) << "  TKW: " << level_vars.back().GetKw();
+    LOG(INFO) << "  TKH: " << level_vars.back().GetKh();
+    LOG(INFO) << "  TOW: " << level_vars.back().GetOw();
+    LOG(INFO) << "  TOH: " << level_vars.back().GetOh();
+    LOG(INFO) << "  TOC: " << level_vars.back().GetOc();
+    LOG(INFO) << "  TN: "  << level_vars.back().GetN();
+    /* #endregion */
+  }
+  VariableSet* varset = new VariableSet(loop.GetVariableSet());
+  varset->SetOnLoopVariables(
+    level_result->GetVariableSet().GetOnLoopVariables());
+  varset->SetParlLoopVariables(
+    level_result->GetVariableSet().GetParlLoopVariables());
+  varset->SetLevelLoopVariables(level_vars);
+  /* #region Logging */
+  LOG(INFO) << "Memory levels are searched one by one, so no EDP above is "
+            << "of the whole hierarchy.";
+  /* #endregion */
+  CnnLoop* final_loop = new CnnLoop(loop);
+  final_loop->SetVariableSet(varset);
+  final_loop->SetOffStructure(new Structure(level_result->GetOffStructure()));
+  final_loop->SetLevelStructures(level_strts);
+  return final_loop;
+}
+
+ShardResult Scheduler::SearchShard( const CnnLoop& loop,
+                                    const Architecture& arch,
+                                    EncodedItr begin, EncodedItr end)
+{
+  SearchContext ctx;
+  TilingCandidate seed;
+  Stationary s;
+  unique_ptr<CnnLoop> new_loop(PrepareSearch(loop, arch, &ctx, &seed, &s));
+  CHECK(begin >= 1 && begin <= end && end <= total_itr_)
+    << "Invalid shard [" << begin << ", " << end << "] of " << total_itr_
+    << " iterations";
+  if (search_mode_ == SearchMode::BRANCH_AND_BOUND)
+    LOG(WARNING) << "Shards are searched exhaustively.";
+  is_shard_ = true;
+  ShardResult shard;
+  shard.begin = begin;
+  shard.end = end;
+  shard.total = total_itr_;
+  shard.result = SearchTilingSpace(ctx, seed, s, begin, end);
+  is_shard_ = false;
+  /* #region Logging */
+  LOG(INFO) << "Shard [" << begin << ", " << end << "] of " << total_itr_
+            << " iterations is finished...";
+  LOG(INFO) << "  EDP: " << shard.result.edp;
+  LOG(INFO) << "  Encoded iteration: " << shard.result.itr;
+  /* #endregion */
+  return shard;
+}
+
+EncodedItr Scheduler::CountTilingSpace( const CnnLoop& loop,
+                                        const Architecture& arch)
+{
+  SearchContext ctx;
+  TilingCandidate seed;
+  Stationary s;
+  unique_ptr<CnnLoop> new_loop(PrepareSearch(loop, arch, &ctx, &seed, &s));
+  return total_itr_;
+}
+
+CnnLoop* Scheduler::MergeShards(const CnnLoop& loop, const Architecture& arch,
+                                const vector<ShardResult>& shards)
+{
+  SearchContext ctx;
+  TilingCandidate seed;
+  Stationary s;
+  unique_ptr<CnnLoop> new_loop(PrepareSearch(loop, arch, &ctx, &seed, &s));
+  // Shards must cover the whole space exactly once. Merging is independent
+  // of the shard order since ties go to the larger encoded iteration.
+  vector<ShardResult> sorted(shards);
+  sort(sorted.begin(), sorted.end(),
+    [](const ShardResult& left, const ShardResult& right)->bool {
+      return left.begin < right.begin;
+    }
+  );
+  EncodedItr next = 1;
+  SearchResult final_result;
+  final_result.cand = TilingCandidate();
+  final_result.edp = DBL_MAX;
+  final_result.itr = 0;
+  final_result.order = -1;
+  for (const ShardResult& shard : sorted) {
+    CHECK(shard.total == total_itr_)
+      << "Shard of " << shard.total << " iterations does not match the layer"
+      << " of " << total_itr_ << " iterations";
+    CHECK(shard.begin == next)
+      << "Shards do not cover [" << next << ", " << shard.begin-1 << "]"
+      << " or overlap";
+    next = shard.end+1;
+    MergeSearchResult(shard.result, &final_result);
+  }
+  CHECK(next == total_itr_+1)
+    << "Shards do not cover [" << next << ", " << total_itr_ << "]";
+  /* #region Logging */
+  LOG(INFO) << "Merged " << shards.size() << " shards.";
+  /* #endregion */
+  pareto_frontier_.clear();
+  return FinishSearch(*new_loop, final_result);
+}
+
+CnnLoop* Scheduler::PrepareSearch(const CnnLoop& loop,
+                                  const Architecture& arch,
+                                  SearchContext* ctx, TilingCandidate* seed,
+                                  Stationary* stationary)
 {
   unique_ptr<CnnLoop> new_loop(new CnnLoop(loop));
 
@@ -313,6 +600,7 @@ CnnLoop* Scheduler::SearchBestLoopCase( const CnnLoop& loop,
   LOG(INFO) << "  TOW: " << new_loop->GetVariableSet().GetTow();
   LOG(INFO) << "  TOH: " << new_loop->GetVariableSet().GetToh();
   LOG(INFO) << "  TOC: " << new_loop->GetVariableSet().GetToc();
+  LOG(INFO) << "  TN: "  << new_loop->GetVariableSet().GetTn();
   /* #endregion */
   new_loop.reset(LoopElimination(*new_loop, arch));
   /* #region Logging */
@@ -325,6 +613,7 @@ CnnLoop* Scheduler::SearchBestLoopCase( const CnnLoop& loop,
   LOG(INFO) << "  TOW: " << new_loop->GetVariableSet().GetTow();
   LOG(INFO) << "  TOH: " << new_loop->GetVariableSet().GetToh();
   LOG(INFO) << "  TOC: " << new_loop->GetVariableSet().GetToc();
+  LOG(INFO) << "  TN: "  << new_loop->GetVariableSet().GetTn();
   /* #endregion */
   pair<CnnLoop*, Stationary> interchange_result = LoopInterchange(*new_loop);
   new_loop.reset(interchange_result.first);
@@ -341,20 +630,10 @@ CnnLoop* Scheduler::SearchBestLoopCase( const CnnLoop& loop,
       LOG(WARNING) << "Off-chip loop is not set as any stationary.";
   }
   /* #endregion */
-  kw_itr_cnt_ = new_loop->GetVariableSet().GetKw() - 
-                new_loop->GetVariableSet().GetTkw() + 1;
-  kh_itr_cnt_ = new_loop->GetVariableSet().GetKh() - 
-                new_loop->GetVariableSet().GetTkh() + 1;
-  ow_itr_cnt_ = new_loop->GetVariableSet().GetOw() - 
-                new_loop->GetVariableSet().GetTow() + 1;
-  oh_itr_cnt_ = new_loop->GetVariableSet().GetOh() - 
-                new_loop->GetVariableSet().GetToh() + 1;
-  ic_itr_cnt_ = new_loop->GetVariableSet().GetIc() - 
-                new_loop->GetVariableSet().GetTic() + 1;
-  oc_itr_cnt_ = new_loop->GetVariableSet().GetOc() - 
-                new_loop->GetVariableSet().GetToc() + 1;
-  total_itr_  = kw_itr_cnt_ * kh_itr_cnt_ * ow_itr_cnt_ * oh_itr_cnt_ *
-                ic_itr_cnt_ * oc_itr_cnt_; // encoding the tiling iterations.
+  *stationary = s;
+  *ctx = MakeSearchContext(new_loop->GetVariableSet(), arch);
+  *seed = MakeTilingCandidate(new_loop->GetVariableSet());
+  BuildTileSpace(*ctx, *seed); // encoding the tiling iterations.
   /* #region Logging */
   LOG(INFO) << "All iteration count is " << total_itr_;
   LOG(INFO) << " kw_itr_cnt: "  << kw_itr_cnt_
@@ -375,51 +654,26 @@ CnnLoop* Scheduler::SearchBestLoopCase( const CnnLoop& loop,
   LOG(INFO) << " oc_itr_cnt: "  << oc_itr_cnt_
             << "  inter: "      << new_loop->GetVariableSet().GetOc()
             << "  tile: "       << new_loop->GetVariableSet().GetToc();
+  LOG(INFO) << " n_itr_cnt: "   << n_itr_cnt_
+            << "  inter: "      << new_loop->GetVariableSet().GetN()
+            << "  tile: "       << new_loop->GetVariableSet().GetTn();
   /* #endregion */
-  CnnLoop* best_loop[num_threads_];
-  double best_edp[num_threads_];
-  for (size_t thr = 0 ; thr < num_threads_ ; thr++) { // Initialize thread values.
-    best_loop[thr] = new CnnLoop(*new_loop);
-    best_edp[thr] = DBL_MAX;
-  }
-  // Distribute jobs for each threads.
-  StartProgress();
-  for (size_t thr = 0 ; thr < min((size_t)num_threads_, total_itr_) ; thr++) {
-    int start, end;
-    if (num_threads_ < total_itr_) {
-      start = thr*(total_itr_ / num_threads_) + 1;
-      end   = (thr < num_threads_-1) ?  (thr+1)*(total_itr_ / num_threads_) :
-                                          total_itr_;
-    } else {
-      start = thr + 1;
-      end = start;
-    }
-    search_threads_[thr] = thread(
-      &Scheduler::SearchBestLoopCaseThread, this,
-      best_loop[thr], s, arch, &best_edp[thr],
-      start, end
-    );
-  }
-  // Join threads
-  for (size_t thr = 0 ; thr < min((size_t)num_threads_, total_itr_) ; thr++)
-    search_threads_[thr].join();
-  FinishProgress();
-  // Find final best CNN loop.
-  CnnLoop* final_loop = nullptr;
-  double final_edp = DBL_MAX;
-  for (size_t thr = num_threads_ ; thr > 0 ; thr--) {
-    if (final_edp > best_edp[thr-1]) {
-      // Update best CNN loop case.
-      if (final_loop != nullptr)  delete final_loop;
-      final_loop = best_loop[thr-1];
-      final_edp = best_edp[thr-1];
-    } else {
-      delete best_loop[thr-1];
-    }
-  }
+  return new_loop.release();
+}
+
+CnnLoop* Scheduler::FinishSearch( const CnnLoop& new_loop,
+                                  const SearchResult& final_result)
+{
+  CnnLoop* final_loop = (final_result.edp < DBL_MAX) ?
+                        MakeFinalLoop(new_loop, final_result) : nullptr;
   CHECK(final_loop != nullptr) << "Cannot find best loop";
   /* #region Logging */
   LOG(INFO) << "Searching best loop case is finished...";
+  if (search_level_.empty())
+    LOG(INFO) << "  EDP: " << final_result.edp;
+  else // SearchMemoryLevels costs a level from its upper level only.
+    LOG(INFO) << "  EDP of " << search_level_ << " only: " << final_result.edp;
+  LOG(INFO) << "  Off-chip loop order: " << final_result.order;
   LOG(INFO) << "  TIW: " << final_loop->GetVariableSet().GetTiw();
   LOG(INFO) << "  TIH: " << final_loop->GetVariableSet().GetTih();
   LOG(INFO) << "  TIC: " << final_loop->GetVariableSet().GetTic();
@@ -428,6 +682,7 @@ CnnLoop* Scheduler::SearchBestLoopCase( const CnnLoop& loop,
   LOG(INFO) << "  TOW: " << final_loop->GetVariableSet().GetTow();
   LOG(INFO) << "  TOH: " << final_loop->GetVariableSet().GetToh();
   LOG(INFO) << "  TOC: " << final_loop->GetVariableSet().GetToc();
+  LOG(INFO) << "  TN: "  << final_loop->GetVariableSet().GetTn();
   LOG(INFO) << "  PIW: " << final_loop->GetVariableSet().GetPiw();
   LOG(INFO) << "  PIH: " << final_loop->GetVariableSet().GetPih();
   LOG(INFO) << "  PIC: " << final_loop->GetVariableSet().GetPic();
@@ -436,7 +691,114 @@ CnnLoop* Scheduler::SearchBestLoopCase( const CnnLoop& loop,
   LOG(INFO) << "  POW: " << final_loop->GetVariableSet().GetPow();
   LOG(INFO) << "  POH: " << final_loop->GetVariableSet().GetPoh();
   LOG(INFO) << "  POC: " << final_loop->GetVariableSet().GetPoc();
+  LOG(INFO) << "  PN: "  << final_loop->GetVariableSet().GetPn();
   /* #endregion */
+  if (use_pareto_) {
+    pareto_base_loop_.reset(new CnnLoop(new_loop));
+    /* #region Logging */
+    LOG(INFO) << "Pareto frontier has " << pareto_frontier_.size()
+              << " points.";
+    /* #endregion */
+  }
+  return final_loop;
+}
+
+SearchResult Scheduler::SearchTilingSpace(const SearchContext& ctx,
+                                          const TilingCandidate& seed,
+                                          Stationary s, EncodedItr begin,
+                                          EncodedItr end)
+{
+  ResetThreadResults();
+  InitCostKernel(ctx, s);
+  if (IsMetaheuristic()) {
+    /* #region Logging */
+    LOG(INFO) << "Search engine runs " << search_eval_cnt_
+              << " evaluations over " << total_itr_ << " iterations.";
+    /* #endregion */
+    if (search_budget_ms_ > 0.0)
+      LOG(WARNING) << "Search engines are bounded by evaluations, not time.";
+    if (search_mode_ == SearchMode::ANNEALING)
+      search_engine_.reset(new AnnealingEngine());
+    else
+      search_engine_.reset(new GeneticEngine());
+    search_engine_->SetSeed(search_seed_);
+    search_engine_->SetEvaluations(search_eval_cnt_);
+  } else {
+    if (use_pareto_ && search_mode_ == SearchMode::BRANCH_AND_BOUND)
+      LOG(WARNING) << "Pareto frontier is searched exhaustively.";
+    if (IsAnytime() && search_mode_ == SearchMode::BRANCH_AND_BOUND)
+      LOG(WARNING) << "Budgeted search visits bounded regions instead.";
+    if (IsBranchAndBound()) {
+      search_engine_.reset(new BranchAndBoundEngine());
+    } else if (IsAnytime()) {
+      search_engine_.reset(new AnytimeEngine(search_budget_ms_));
+    } else {
+      ExhaustiveEngine* engine = new ExhaustiveEngine();
+      engine->SetRange(begin, end);
+      search_engine_.reset(engine);
+    }
+  }
+  EngineSpace space(this, ctx, seed, s);
+  SearchResult final_result = search_engine_->Search(&space, num_threads_);
+  ReportLoadBalance();
+  is_search_exact_ = !IsMetaheuristic() &&
+                     (search_engine_->GetCoverage() == 1.0);
+  // Merge thread-local frontiers.
+  pareto_frontier_.clear();
+  for (size_t thr = 0 ; thr < thread_pareto_.size() ; thr++)
+    for (const ParetoPoint& point : thread_pareto_[thr])
+      InsertParetoPoint(point, &pareto_frontier_);
+  sort(pareto_frontier_.begin(), pareto_frontier_.end(),
+    [](const ParetoPoint& left, const ParetoPoint& right)->bool {
+      return  left.latency < right.latency ||
+              (left.latency == right.latency &&
+               left.result.itr > right.result.itr);
+    }
+  );
+  return final_result;
+}
+
+void Scheduler::MergeSearchResult(const SearchResult& from,
+                                  SearchResult* to) const
+{
+  // Ties are resolved to the largest encoded iteration regardless of which
+  // thread evaluated it.
+  if (to->edp > from.edp || (to->edp == from.edp && to->itr < from.itr))
+    *to = from;
+}
+
+bool Scheduler::IsBranchAndBound(void) const
+{
+  // Branch and bound prunes by EDP, which loses the other Pareto points.
+  // Its subtrees are rooted at batch and output channel tiles, not at shard
+  // ranges.
+  return search_mode_ == SearchMode::BRANCH_AND_BOUND && !use_pareto_ &&
+         !is_shard_ && !IsAnytime();
+}
+
+bool Scheduler::IsAnytime(void) const
+{
+  return search_budget_ms_ > 0.0 && !is_shard_ && !IsMetaheuristic();
+}
+
+bool Scheduler::IsMetaheuristic(void) const
+{
+  // Engines only keep the best EDP, and shards must be searched exactly.
+  // Small spaces are cheaper to enumerate than to sample.
+  return (search_mode_ == SearchMode::ANNEALING ||
+          search_mode_ == SearchMode::GENETIC) &&
+         !use_pareto_ && !is_shard_ && total_itr_ > search_eval_cnt_;
+}
+
+CnnLoop* Scheduler::MakeFinalLoop(const CnnLoop& loop,
+                                  const SearchResult& result) const
+{
+  // Materialize CnnLoop only for the chosen candidates.
+  CnnLoop* final_loop = new CnnLoop(loop);
+  final_loop->SetVariableSet(MakeVariableSet(loop.GetVariableSet(),
+                                             result.cand));
+  if (result.order >= 0)
+    final_loop->SetOffStructure(MakeLoopOrder(result.order));
   if (final_loop->GetVariableSet().GetTow() < 
       final_loop->GetVariableSet().GetToh()) {
     VariableSet* wh_swap = new VariableSet(final_loop->GetVariableSet());
@@ -458,171 +820,962 @@ CnnLoop* Scheduler::SearchBestLoopCase( const CnnLoop& loop,
   return final_loop;
 }
 
-void Scheduler::SearchBestLoopCaseThread( CnnLoop* loop, Stationary s,
-                                          const Architecture& arch,
-                                          double* edp,
-                                          int start_itr, int end_itr)
+void Scheduler::InsertParetoPoint(const ParetoPoint& point,
+                                  vector<ParetoPoint>* frontier) const
 {
-  const VariableSet& varset = loop->GetVariableSet();
+  for (const ParetoPoint& other : *frontier)
+    if (IsDominated(point, other)) return;
+  // Remove the points which the new one dominates.
+  size_t kept = 0;
+  for (size_t i = 0 ; i < frontier->size() ; i++)
+    if (!IsDominated((*frontier)[i], point))
+      (*frontier)[kept++] = (*frontier)[i];
+  frontier->resize(kept);
+  frontier->push_back(point);
+}
 
-  double best_edp = DBL_MAX;
-  CnnLoop* best_loop = nullptr;
+bool Scheduler::IsDominated(const ParetoPoint& a, const ParetoPoint& b) const
+{
+  bool no_worse = b.latency <= a.latency && b.dram_bytes <= a.dram_bytes &&
+                  b.on_chip_bytes <= a.on_chip_bytes;
+  bool better =   b.latency < a.latency || b.dram_bytes < a.dram_bytes ||
+                  b.on_chip_bytes < a.on_chip_bytes;
+  // Equal points keep the largest encoded iteration like the EDP search.
+  return no_worse && (better || b.result.itr > a.result.itr);
+}
 
-  for (int it = end_itr ; it >= start_itr ; it--) {
-    CnnLoop* itr_loop = new CnnLoop(*loop);
-    VariableSet* itr_varset = new VariableSet(loop->GetVariableSet());
-    double itr_edp;
-    int encoded_it = it-1;
-    // Decoding iterations
-    itr_varset->SetTkw(varset.GetTkw() + encoded_it%kw_itr_cnt_);
-    encoded_it /= kw_itr_cnt_;
-    itr_varset->SetTkh(varset.GetTkh() + encoded_it%kh_itr_cnt_);
-    encoded_it /= kh_itr_cnt_;
-    itr_varset->SetTow(varset.GetTow() + encoded_it%ow_itr_cnt_);
-    itr_varset->SetTiw(
-      min(itr_varset->GetIw(),
-          (itr_varset->GetTow()-1)*varset.GetStride()+varset.GetTkw()
-      ));
-    //itr_varset->SetTiw(CalcInputLength(itr_varset->GetTow()));
-    encoded_it /= ow_itr_cnt_;
-    itr_varset->SetToh(varset.GetToh() + encoded_it%oh_itr_cnt_);
-    itr_varset->SetTih(
-      min(itr_varset->GetIh(), 
-          (itr_varset->GetToh()-1)*varset.GetStride()+varset.GetTkh()
-      ));
-    //itr_varset->SetTih(CalcInputLength(itr_varset->GetToh()));
-    encoded_it /= oh_itr_cnt_;
-    itr_varset->SetTic(varset.GetTic() + encoded_it%ic_itr_cnt_);
-    encoded_it /= ic_itr_cnt_;
-    itr_varset->SetToc(varset.GetToc() + encoded_it%oc_itr_cnt_);
-    encoded_it /= oc_itr_cnt_;
+void Scheduler::MakeParetoPoint(const SearchContext& ctx, Stationary s,
+                                const SearchResult& result,
+                                ParetoPoint* point) const
+{
+  const TilingCandidate& cand = result.cand;
+  long int dram_accesses;
+  if (result.order >= 0) {
+    int quot[kDimensionCnt];
+    bool fully_tiled[kLoopCnt];
+    GetTileQuotients(ctx, cand, quot);
+    GetFullyTiled(quot, fully_tiled);
+    int flags = GetStationaryFlags(loop_orders_[result.order],
+                                   fully_tiled, fully_tiled);
+    dram_accesses = GetOrderDramAccesses(ctx, quot, flags, point->data_bytes);
+  } else {
+    dram_accesses = GetDramAccesses(ctx, cand, s, point->data_bytes);
+  }
+  point->result = result;
+  point->pe_util = GetPeUtil(ctx, cand);
+  point->latency = GetNumOps(ctx) /
+                   CalcPerformance(ctx, dram_accesses, point->pe_util);
+  point->dram_bytes = dram_accesses;
+  point->on_chip_bytes = GetOnChipBytes(ctx, cand);
+  // Same buffering as GetOnChipBytes.
+  long int output_size = GetOutputSize(cand.tile);
+  if (output_size < GetOutputSize(ctx.dim)) output_size *= 2;
+  point->output_buf_bytes = output_size * sizeof(DataType);
+}
+
+void Scheduler::ResetThreadResults(void)
+{
+  thread_itr_cnt_.assign(num_threads_, 0);
+  thread_pareto_.assign(num_threads_, vector<ParetoPoint>());
+}
+
+void Scheduler::SearchDecodedChunk( const SearchContext& ctx,
+                                    const TilingCandidate& seed, Stationary s,
+                                    unsigned int thr, const SearchChunk& chunk,
+                                    SearchResult* best)
+{
+  TilingCandidate itr_cand;
+  for (EncodedItr it = chunk.second ; it >= chunk.first ; it--) {
+    DecodeTilingCandidate(seed, ctx, it, &itr_cand);
     // Compare EDP only when it is not memory overflow.
-    if (!IsMemorySizeOverflow(*itr_varset, arch)) {
-      //REVIEW (MinsuKim): This is a main bottle neck of the very long compile time.
-      itr_varset->SetParlLoopVariables(
-        MakeParlLoopVariables(itr_varset->GetOnLoopVariables(), arch)
-      );
-      itr_loop->SetVariableSet(itr_varset);
-      itr_edp = GetEdp(*itr_loop, arch, s);
-      if (best_edp > itr_edp) {
-        if (best_loop != nullptr) delete best_loop;
-        best_loop = itr_loop; // allocate new loop.
-        best_edp = itr_edp;
-      }
-    } else {
-      delete itr_loop;
-      delete itr_varset;
+    if (!IsMemorySizeOverflow(ctx, itr_cand)) {
+      MakeParlLoopVariables(ctx, 0, &itr_cand);
+      int itr_order;
+      double itr_edp = GetSearchEdp(ctx, itr_cand, s, &itr_order);
+      UpdateSearchResult(ctx, s, thr, { itr_cand, itr_edp, it, itr_order },
+                         best);
+    }
+    if (it == chunk.first) break; // it is unsigned.
+  }
+}
+
+void Scheduler::SearchGrayCodeChunk(const SearchContext& ctx,
+                                    const TilingCandidate& seed, Stationary s,
+                                    unsigned int thr, const SearchChunk& chunk,
+                                    SearchResult* best)
+{
+  // Chunk bounds are Gray code ranks. The visited tilings are still
+  // identified by their encoded iterations, so ties resolve as in decoding.
+  // Between turnarounds only the lowest digit which has more than one
+  // tile moves, so each block sweeps a run of that digit.
+  int run = 0;
+  while (run < kTileDimensionCnt-1 &&
+         tile_space_[kEncodingOrder[run]].size() == 1)
+    run++;
+  TilingCursor cursor;
+  CostBlock block;
+  SeekTilingCursor(ctx, seed, chunk.first-1, &cursor);
+  EncodedItr rank = chunk.first;
+  while (true) {
+    EncodedItr run_left = (cursor.dir[run] > 0) ?
+      tile_space_[kEncodingOrder[run]].size()-1 - cursor.digit[run] :
+      cursor.digit[run];
+    int lane_cnt = min(min((EncodedItr)kCostBlockLen, run_left+1),
+                       chunk.second-rank+1);
+    FillCostBlock(ctx, seed, run, lane_cnt, &cursor, &block);
+    SearchCostBlock(ctx, s, thr, &cursor, &block, best);
+    rank += lane_cnt;
+    if (rank > chunk.second) break;
+    StepTilingCursor(ctx, seed, &cursor);
+  }
+}
+
+void Scheduler::FillCostBlock(const SearchContext& ctx,
+                              const TilingCandidate& seed, int run,
+                              int lane_cnt, TilingCursor* cursor,
+                              CostBlock* block) const
+{
+  block->size = lane_cnt;
+  for (int d = 0 ; d < kDimensionCnt ; d++) {
+    for (int i = 0 ; i < lane_cnt ; i++) {
+      block->tile[d][i] = cursor->cand.tile[d];
+      block->quot[d][i] = cursor->quot[d];
+    }
+  }
+  // Lanes step the run digit from the cursor.
+  DataDimension d = kEncodingOrder[run];
+  int dir = cursor->dir[run];
+  bool is_unroll = IsUnrollDimension(ctx, d);
+  for (int i = 0 ; i < lane_cnt ; i++) {
+    int digit = cursor->digit[run] + dir*i;
+    block->tile[d][i] = tile_space_[d][digit];
+    block->quot[d][i] = quot_space_[d][digit];
+    block->itr[i] = (dir > 0) ? cursor->itr + i*itr_radix_[run] :
+                                cursor->itr - i*itr_radix_[run];
+    block->parl_stale[i] = is_unroll;
+  }
+  if (d == DataDimension::OW || d == DataDimension::OH) {
+    DataDimension in_d = (d == DataDimension::OW) ? DataDimension::IW :
+                                                    DataDimension::IH;
+    int kernel = (d == DataDimension::OW) ? seed.tile[DataDimension::KW] :
+                                            seed.tile[DataDimension::KH];
+    for (int i = 0 ; i < lane_cnt ; i++)
+      block->tile[in_d][i] = min(ctx.dim[in_d],
+                                 (block->tile[d][i]-1)*ctx.stride+kernel);
+  }
+  for (int i = 0 ; i < lane_cnt ; i++) {
+    block->group_span[i] = CalcGroupSpan(block->tile[DataDimension::OC][i],
+                                         ctx.group_oc, ctx.groups);
+    block->group_quot[i] = CeilDiv(block->quot[DataDimension::OC][i],
+                                   ctx.groups);
+  }
+  // The block takes over the stale unrolling of the cursor, and the cursor
+  // moves to the last lane.
+  block->parl_stale[0] = !cursor->is_parl_valid;
+  cursor->is_parl_valid = true;
+  cursor->digit[run] += dir*(lane_cnt-1);
+  cursor->itr = block->itr[lane_cnt-1];
+  SetCandidateTile(ctx, seed, d, block->tile[d][lane_cnt-1], &cursor->cand);
+  cursor->quot[d] = block->quot[d][lane_cnt-1];
+}
+
+void Scheduler::SearchCostBlock(const SearchContext& ctx, Stationary s,
+                                unsigned int thr, TilingCursor* cursor,
+                                CostBlock* block, SearchResult* best)
+{
+  int fit_cnt = cost_kernel_.Overflow(block);
+  // Unrolling is computed only for fitting candidates after a PE mapped
+  // tile moved. Until then the lanes share the last computed one.
+  TilingCandidate cand;
+  int parl_lane = -1;
+  double pe_util = cursor->pe_util;
+  bool is_stale = false;
+  for (int i = 0 ; i < block->size ; i++) {
+    is_stale |= block->parl_stale[i];
+    if (!block->overflow[i] && is_stale) {
+      for (int d = 0 ; d < kDimensionCnt ; d++)
+        cand.tile[d] = block->tile[d][i];
+      MakeParlLoopVariables(ctx, 0, &cand);
+      for (int d = 0 ; d < kDimensionCnt ; d++)
+        block->parl[i][d] = cand.parl[d];
+      pe_util = GetPeUtil(ctx, cand);
+      parl_lane = i;
+      is_stale = false;
+    }
+    block->parl_lane[i] = parl_lane;
+    block->pe_util[i] = pe_util;
+  }
+  if (fit_cnt > 0) cost_kernel_.Evaluate(block);
+  // Candidates are materialized and their loop orders resolved only when
+  // they are kept.
+  for (int i = 0 ; i < block->size && fit_cnt > 0 ; i++) {
+    if (block->overflow[i]) continue;
+    double itr_edp = block->edp[i];
+    EncodedItr it = block->itr[i];
+    if (!use_pareto_ &&
+        !(best->edp > itr_edp || (best->edp == itr_edp && best->itr < it)))
+      continue;
+    const int* parl = (block->parl_lane[i] < 0) ? cursor->cand.parl :
+                      block->parl[block->parl_lane[i]];
+    int quot[kDimensionCnt];
+    for (int d = 0 ; d < kDimensionCnt ; d++) {
+      cand.tile[d] = block->tile[d][i];
+      cand.parl[d] = parl[d];
+      quot[d] = block->quot[d][i];
+    }
+    int itr_order = -1;
+    if (loop_order_ == LoopOrderSearch::ALL_ORDERS)
+      GetBestOrderEdp(ctx, quot, block->pe_util[i], &itr_order);
+    UpdateSearchResult(ctx, s, thr, { cand, itr_edp, it, itr_order }, best);
+  }
+  // The cursor carries the last unrolling over to the next block.
+  if (parl_lane >= 0) {
+    for (int d = 0 ; d < kDimensionCnt ; d++)
+      cursor->cand.parl[d] = block->parl[parl_lane][d];
+    cursor->pe_util = pe_util;
+  }
+  if (is_stale) cursor->is_parl_valid = false;
+  block->size = 0;
+}
+
+void Scheduler::InitCostKernel(const SearchContext& ctx, Stationary s)
+{
+  // Stationary flags reachable by some loop order for each fully tiled mask.
+  int reach_flags[kFullyTiledMaskCnt];
+  for (int mask = 0 ; mask < kFullyTiledMaskCnt ; mask++) {
+    bool fully_tiled[kLoopCnt];
+    for (int l = 0 ; l < kLoopCnt ; l++)
+      fully_tiled[l] = (mask >> l) & 1;
+    reach_flags[mask] = 0;
+    for (int o = 0 ; o < kLoopOrderCnt ; o++)
+      reach_flags[mask] |=
+        1 << GetStationaryFlags(loop_orders_[o], fully_tiled, fully_tiled);
+  }
+  cost_kernel_.Init(ctx, (loop_order_ == LoopOrderSearch::ALL_ORDERS) ? -1 : s,
+                    reach_flags);
+}
+
+void Scheduler::UpdateSearchResult( const SearchContext& ctx, Stationary s,
+                                    unsigned int thr,
+                                    const SearchResult& result,
+                                    SearchResult* best)
+{
+  // Chunks are stolen out of order, so ties are broken by the
+  // encoded iteration to keep the result independent of stealing.
+  if (best->edp > result.edp ||
+      (best->edp == result.edp && best->itr < result.itr)) {
+    *best = result;
+  }
+  if (use_pareto_) {
+    ParetoPoint point;
+    MakeParetoPoint(ctx, s, result, &point);
+    InsertParetoPoint(point, &thread_pareto_[thr]);
+  }
+}
+
+void Scheduler::SetCandidateTile( const SearchContext& ctx,
+                                  const TilingCandidate& seed,
+                                  DataDimension d, int tile,
+                                  TilingCandidate* cand) const
+{
+  cand->tile[d] = tile;
+  // Input width/height follow output width/height like decoding does.
+  if (d == DataDimension::OW) {
+    cand->tile[DataDimension::IW] = min(
+      ctx.dim[DataDimension::IW],
+      (tile-1)*ctx.stride+seed.tile[DataDimension::KW]
+    );
+  } else if (d == DataDimension::OH) {
+    cand->tile[DataDimension::IH] = min(
+      ctx.dim[DataDimension::IH],
+      (tile-1)*ctx.stride+seed.tile[DataDimension::KH]
+    );
+  }
+}
+
+EncodedItr Scheduler::GetItrCnt(DataDimension d) const
+{
+  return tile_space_[d].size();
+}
+
+EncodedItr Scheduler::GetItrRadix(DataDimension d) const
+{
+  // Encoding order from the least significant: KW, KH, OW, OH, IC, OC, N.
+  EncodedItr radix = 1;
+  switch (d) {
+    case DataDimension::N:  radix *= oc_itr_cnt_; // fall through
+    case DataDimension::OC: radix *= ic_itr_cnt_; // fall through
+    case DataDimension::IC: radix *= oh_itr_cnt_; // fall through
+    case DataDimension::OH: radix *= ow_itr_cnt_; // fall through
+    case DataDimension::OW: radix *= kh_itr_cnt_; // fall through
+    case DataDimension::KH: radix *= kw_itr_cnt_; // fall through
+    case DataDimension::KW: break;
+    default:
+      LOG(ERROR) << "Invalid data dimension: " << d;
+  }
+  return radix;
+}
+
+void Scheduler::ReportLoadBalance(void) const
+{
+  const vector<double>& busy_time = search_engine_->GetBusyTime();
+  const vector<EncodedItr>& prune_cnt = search_engine_->GetPruneCnt();
+  const vector<size_t>& steal_cnt = search_engine_->GetStealCnt();
+  double max_busy = 0.0, sum_busy = 0.0;
+  EncodedItr pruned_cnt = 0;
+  for (size_t thr = 0 ; thr < busy_time.size() ; thr++) {
+    max_busy = max(max_busy, busy_time[thr]);
+    sum_busy += busy_time[thr];
+    pruned_cnt += prune_cnt[thr];
+  }
+  double mean_busy = sum_busy / num_threads_;
+  /* #region Logging */
+  LOG(INFO) << "Search load balance.";
+  for (size_t thr = 0 ; thr < busy_time.size() ; thr++) {
+    LOG(INFO) << "  Thread " << thr
+              << "  busy: "       << busy_time[thr] << " ms"
+              << "  iterations: " << thread_itr_cnt_[thr]
+              << "  pruned: "     << prune_cnt[thr]
+              << "  steals: "     << steal_cnt[thr];
+  }
+  LOG(INFO) << "  Max/mean busy time: "
+            << ((mean_busy > 0.0) ? max_busy / mean_busy : 1.0);
+  if (IsBranchAndBound()) {
+    LOG(INFO) << "  Pruning ratio: " << GetPruningRatio()
+              << " (" << pruned_cnt << " / " << total_itr_ << ")";
+  }
+  /* #endregion */
+}
+
+double Scheduler::GetPruningRatio(void) const
+{
+  if (!search_engine_) return 0.0;
+  EncodedItr pruned_cnt = 0;
+  for (EncodedItr cnt : search_engine_->GetPruneCnt())
+    pruned_cnt += cnt;
+  return (total_itr_ > 0) ? (double)pruned_cnt / total_itr_ : 0.0;
+}
+
+void Scheduler::SetSearchMode(const char* search_mode)
+{
+  if      (strcmp(search_mode, S_EXHAUSTIVE) == 0)
+    search_mode_ = SearchMode::EXHAUSTIVE;
+  else if (strcmp(search_mode, S_BRANCH_AND_BOUND) == 0)
+    search_mode_ = SearchMode::BRANCH_AND_BOUND;
+  else if (strcmp(search_mode, S_ANNEALING) == 0)
+    search_mode_ = SearchMode::ANNEALING;
+  else if (strcmp(search_mode, S_GENETIC) == 0)
+    search_mode_ = SearchMode::GENETIC;
+  else
+    LOG(FATAL) << "Invalid search mode: " << search_mode;
+  /* #region Logging */
+  LOG(INFO) << "Search mode is set as " << search_mode;
+  /* #endregion */
+}
+
+void Scheduler::SetSearchSeed(uint64_t seed)
+{
+  search_seed_ = seed;
+  /* #region Logging */
+  LOG(INFO) << "Search seed is set as " << seed;
+  /* #endregion */
+}
+
+void Scheduler::SetSearchEvaluations(EncodedItr eval_cnt)
+{
+  search_eval_cnt_ = eval_cnt;
+  /* #region Logging */
+  LOG(INFO) << "Search evaluations are set as " << eval_cnt;
+  /* #endregion */
+}
+
+bool Scheduler::IsSearchExact(void) const
+{
+  return is_search_exact_;
+}
+
+void Scheduler::SetTileEnumeration(const char* tile_enum)
+{
+  if      (strcmp(tile_enum, S_FULL_TILES) == 0)
+    tile_enum_ = TileEnumeration::FULL_TILES;
+  else if (strcmp(tile_enum, S_CLASS_TILES) == 0)
+    tile_enum_ = TileEnumeration::CLASS_TILES;
+  else
+    LOG(FATAL) << "Invalid tile enumeration: " << tile_enum;
+  /* #region Logging */
+  LOG(INFO) << "Tile enumeration is set as " << tile_enum;
+  /* #endregion */
+}
+
+void Scheduler::SetLoopOrderSearch(const char* loop_order)
+{
+  if      (strcmp(loop_order, S_HEURISTIC_ORDER) == 0)
+    loop_order_ = LoopOrderSearch::HEURISTIC_ORDER;
+  else if (strcmp(loop_order, S_ALL_ORDERS) == 0)
+    loop_order_ = LoopOrderSearch::ALL_ORDERS;
+  else
+    LOG(FATAL) << "Invalid loop order search: " << loop_order;
+  /* #region Logging */
+  LOG(INFO) << "Loop order search is set as " << loop_order;
+  /* #endregion */
+}
+
+void Scheduler::SetIntraOrderSearch(const char* intra_order)
+{
+  if      (strcmp(intra_order, S_FIXED_INTRA_ORDER) == 0)
+    intra_order_ = IntraOrderSearch::FIXED_INTRA_ORDER;
+  else if (strcmp(intra_order, S_ALL_INTRA_ORDERS) == 0)
+    intra_order_ = IntraOrderSearch::ALL_INTRA_ORDERS;
+  else
+    LOG(FATAL) << "Invalid intra loop order search: " << intra_order;
+  /* #region Logging */
+  LOG(INFO) << "Intra loop order search is set as " << intra_order;
+  /* #endregion */
+}
+
+void Scheduler::SetTileTraversal(const char* tile_traversal)
+{
+  if      (strcmp(tile_traversal, S_DECODE_TRAVERSAL) == 0)
+    tile_traversal_ = TileTraversal::DECODE_TRAVERSAL;
+  else if (strcmp(tile_traversal, S_GRAY_TRAVERSAL) == 0)
+    tile_traversal_ = TileTraversal::GRAY_TRAVERSAL;
+  else
+    LOG(FATAL) << "Invalid tile traversal: " << tile_traversal;
+  /* #region Logging */
+  LOG(INFO) << "Tile traversal is set as " << tile_traversal;
+  /* #endregion */
+}
+
+void Scheduler::SetSearchBudget(double budget_ms)
+{
+  search_budget_ms_ = budget_ms;
+  /* #region Logging */
+  LOG(INFO) << "Search budget is set as " << budget_ms << " ms";
+  /* #endregion */
+}
+
+double Scheduler::GetSearchCoverage(void) const
+{
+  return search_engine_ ? search_engine_->GetCoverage() : 1.0;
+}
+
+double Scheduler::GetOptimalityGap(void) const
+{
+  return search_engine_ ? search_engine_->GetOptimalityGap() : 0.0;
+}
+
+void Scheduler::SetParetoFrontier(bool use_pareto)
+{
+  use_pareto_ = use_pareto;
+  /* #region Logging */
+  LOG(INFO) << "Pareto frontier is " << (use_pareto ? "on" : "off");
+  /* #endregion */
+}
+
+const vector<ParetoPoint>& Scheduler::GetParetoFrontier(void) const
+{
+  return pareto_frontier_;
+}
+
+CnnLoop* Scheduler::MakeParetoLoop(size_t i) const
+{
+  CHECK(pareto_base_loop_ != nullptr) << "Pareto frontier is not searched.";
+  CHECK(i < pareto_frontier_.size()) << "Invalid Pareto point: " << i;
+  return MakeFinalLoop(*pareto_base_loop_, pareto_frontier_[i].result);
+}
+
+const vector<double>& Scheduler::GetThreadBusyTime(void) const
+{
+  static const vector<double> kNoBusyTime;
+  return search_engine_ ? search_engine_->GetBusyTime() : kNoBusyTime;
+}
+
+SearchContext Scheduler::MakeSearchContext( const VariableSet& varset,
+                                            const Architecture& arch) const
+{
+  SearchContext ctx;
+  const Variables& off_vars = varset.GetOffLoopVariables();
+
+  ctx.dim[DataDimension::None] = 1;
+  ctx.dim[DataDimension::KW] = off_vars.GetKw();
+  ctx.dim[DataDimension::KH] = off_vars.GetKh();
+  ctx.dim[DataDimension::IC] = off_vars.GetIc();
+  ctx.dim[DataDimension::OW] = off_vars.GetOw();
+  ctx.dim[DataDimension::OH] = off_vars.GetOh();
+  ctx.dim[DataDimension::OC] = off_vars.GetOc();
+  ctx.dim[DataDimension::IW] = off_vars.GetIw();
+  ctx.dim[DataDimension::IH] = off_vars.GetIh();
+  ctx.dim[DataDimension::N]  = off_vars.GetN();
+  ctx.stride      = off_vars.GetStride();
+  ctx.pad_width   = off_vars.GetPw();
+  ctx.pad_height  = off_vars.GetPh();
+  // A level tile may cover only some groups of the layer.
+  ctx.group_oc    = varset.GetGroupOc();
+  ctx.groups      = CalcGroupSpan(ctx.dim[DataDimension::OC], ctx.group_oc,
+                                  varset.GetGroups());
+
+  ctx.input_mem_size  = arch.GetInputMemSize();
+  ctx.weight_mem_size = arch.GetWeightMemSize();
+  ctx.output_mem_size = arch.GetOutputMemSize();
+  ctx.frequency = arch.GetFrequency();
+  ctx.bandwidth = arch.GetBandwidth();
+
+  vector<vector<int>> pe_dim = arch.GetPeDim();
+  const vector<vector<vector<int>>>& pe_factors = arch.GetPeFactors();
+  vector<vector<DataDimension>> pe_strt = arch.GetPeStructure();
+  CHECK(pe_dim.size() >= 1 && pe_dim.size() <= (size_t)kMaxPeArrayCnt)
+    << "The number of PE arrays is non-valid: " << pe_dim.size();
+  ctx.pe_array_cnt = pe_dim.size();
+  ctx.num_pe = 0;
+  for (int a = 0 ; a < ctx.pe_array_cnt ; a++) {
+    for (int r_c = 0 ; r_c < 2 ; r_c++) {
+      ctx.pe_len[a][r_c] = pe_dim[a][r_c];
+      // PE length is fixed for the architecture, which factorizes it once.
+      const vector<int>& factors = pe_factors[a][r_c];
+      ctx.pe_factor_cnt[a][r_c] = factors.size();
+      std::copy(factors.begin(), factors.end(), ctx.pe_factors[a][r_c]);
+    }
+    ctx.num_pe += (long int)ctx.pe_len[a][0] * ctx.pe_len[a][1];
+  }
+  for (int d = 0 ; d < kDimensionCnt ; d++)
+    ctx.pe_mapped_len[d] = 0;
+  for (int r_c = 0 ; r_c < 2 ; r_c++) { // r_c = 0: row, r_c = 1: column
+    CHECK(pe_strt[r_c].size() <= (size_t)kMaxPeStructureLen)
+      << "Too many dimensions are mapped on PE: " << pe_strt[r_c].size();
+    ctx.pe_strt_len[r_c] = pe_strt[r_c].size();
+    for (size_t i = 0 ; i < pe_strt[r_c].size() ; i++) {
+      ctx.pe_strt[r_c][i] = pe_strt[r_c][i];
+      int& mapped_len = ctx.pe_mapped_len[pe_strt[r_c][i]];
+      mapped_len = (mapped_len == 0) ? ctx.pe_len[0][r_c] :
+                                       mapped_len * ctx.pe_len[0][r_c];
+    }
+  }
+  return ctx;
+}
+
+TilingCandidate Scheduler::MakeTilingCandidate(const VariableSet& varset) const
+{
+  TilingCandidate cand;
+
+  cand.tile[DataDimension::None] = 1;
+  cand.tile[DataDimension::KW] = varset.GetTkw();
+  cand.tile[DataDimension::KH] = varset.GetTkh();
+  cand.tile[DataDimension::IC] = varset.GetTic();
+  cand.tile[DataDimension::OW] = varset.GetTow();
+  cand.tile[DataDimension::OH] = varset.GetToh();
+  cand.tile[DataDimension::OC] = varset.GetToc();
+  cand.tile[DataDimension::IW] = varset.GetTiw();
+  cand.tile[DataDimension::IH] = varset.GetTih();
+  cand.tile[DataDimension::N]  = varset.GetTn();
+
+  cand.parl[DataDimension::None] = 1;
+  cand.parl[DataDimension::KW] = varset.GetPkw();
+  cand.parl[DataDimension::KH] = varset.GetPkh();
+  cand.parl[DataDimension::IC] = varset.GetPic();
+  cand.parl[DataDimension::OW] = varset.GetPow();
+  cand.parl[DataDimension::OH] = varset.GetPoh();
+  cand.parl[DataDimension::OC] = varset.GetPoc();
+  cand.parl[DataDimension::IW] = varset.GetPiw();
+  cand.parl[DataDimension::IH] = varset.GetPih();
+  cand.parl[DataDimension::N]  = varset.GetPn();
+  return cand;
+}
+
+VariableSet* Scheduler::MakeVariableSet(const VariableSet& varset,
+                                        const TilingCandidate& cand) const
+{
+  VariableSet* new_varset = new VariableSet(varset);
+
+  new_varset->SetTkw(cand.tile[DataDimension::KW]);
+  new_varset->SetTkh(cand.tile[DataDimension::KH]);
+  new_varset->SetTic(cand.tile[DataDimension::IC]);
+  new_varset->SetTow(cand.tile[DataDimension::OW]);
+  new_varset->SetToh(cand.tile[DataDimension::OH]);
+  new_varset->SetToc(cand.tile[DataDimension::OC]);
+  new_varset->SetTiw(cand.tile[DataDimension::IW]);
+  new_varset->SetTih(cand.tile[DataDimension::IH]);
+  new_varset->SetTn(cand.tile[DataDimension::N]);
+
+  Variables parl_vars;
+  parl_vars.SetStride(varset.GetStride());
+  parl_vars.SetPw(varset.GetPw());
+  parl_vars.SetPh(varset.GetPh());
+  parl_vars.SetKw(cand.parl[DataDimension::KW]);
+  parl_vars.SetKh(cand.parl[DataDimension::KH]);
+  parl_vars.SetIc(cand.parl[DataDimension::IC]);
+  parl_vars.SetOw(cand.parl[DataDimension::OW]);
+  parl_vars.SetOh(cand.parl[DataDimension::OH]);
+  parl_vars.SetOc(cand.parl[DataDimension::OC]);
+  parl_vars.SetIw(cand.parl[DataDimension::IW]);
+  parl_vars.SetIh(cand.parl[DataDimension::IH]);
+  parl_vars.SetN(cand.parl[DataDimension::N]);
+  new_varset->SetParlLoopVariables(parl_vars);
+
+  return new_varset;
+}
+
+void Scheduler::DecodeTilingCandidate(const TilingCandidate& seed,
+                                      const SearchContext& ctx,
+                                      EncodedItr it, TilingCandidate* cand) const
+{
+  EncodedItr encoded_it = it-1;
+
+  *cand = seed;
+  // Decoding iterations
+  for (DataDimension d : kEncodingOrder) {
+    EncodedItr itr_cnt = tile_space_[d].size();
+    SetCandidateTile(ctx, seed, d, tile_space_[d][encoded_it%itr_cnt], cand);
+    encoded_it /= itr_cnt;
+  }
+}
+
+void Scheduler::SeekTilingCursor( const SearchContext& ctx,
+                                  const TilingCandidate& seed, EncodedItr rank,
+                                  TilingCursor* cursor) const
+{
+  // Reflected mixed-radix Gray code: a digit runs backward while the number
+  // formed by the higher digits of the rank is odd.
+  EncodedItr prefix = rank;
+  cursor->cand = seed;
+  cursor->itr = 1;
+  for (int i = 0 ; i < kTileDimensionCnt ; i++) {
+    DataDimension d = kEncodingOrder[i];
+    int itr_cnt = GetItrCnt(d);
+    int digit = prefix % itr_cnt;
+    prefix /= itr_cnt;
+    cursor->dir[i] = (prefix % 2 == 0) ? 1 : -1;
+    cursor->digit[i] = (cursor->dir[i] > 0) ? digit : itr_cnt-1-digit;
+    cursor->itr += cursor->digit[i] * GetItrRadix(d);
+    SetCandidateTile(ctx, seed, d, tile_space_[d][cursor->digit[i]],
+                     &cursor->cand);
+  }
+  GetTileQuotients(ctx, cursor->cand, cursor->quot);
+  cursor->pe_util = 0.0;
+  cursor->is_parl_valid = false;
+}
+
+void Scheduler::StepTilingCursor( const SearchContext& ctx,
+                                  const TilingCandidate& seed,
+                                  TilingCursor* cursor) const
+{
+  // Move the lowest digit which can move. Lower digits are at their end,
+  // so they turn around.
+  for (int i = 0 ; i < kTileDimensionCnt ; i++) {
+    DataDimension d = kEncodingOrder[i];
+    int next = cursor->digit[i] + cursor->dir[i];
+    if (next < 0 || next >= (int)tile_space_[d].size()) {
+      cursor->dir[i] = -cursor->dir[i];
+      continue;
     }
-    IncreaseProgress();
+    cursor->digit[i] = next;
+    if (cursor->dir[i] > 0) cursor->itr += itr_radix_[i];
+    else                    cursor->itr -= itr_radix_[i];
+    SetCandidateTile(ctx, seed, d, tile_space_[d][next], &cursor->cand);
+    cursor->quot[d] = quot_space_[d][next];
+    if (IsUnrollDimension(ctx, d)) cursor->is_parl_valid = false;
+    return;
   }
-  if (best_loop != nullptr) {
-    delete loop;
-    loop = new CnnLoop(*best_loop);
-    *edp = best_edp;
+  LOG(ERROR) << "Stepped over the last Gray code rank";
+}
+
+bool Scheduler::IsUnrollDimension(const SearchContext& ctx,
+                                  DataDimension d) const
+{
+  // Input width/height tiles follow output width/height tiles.
+  return  ctx.pe_mapped_len[d] > 0 ||
+          (d == DataDimension::OW && ctx.pe_mapped_len[DataDimension::IW] > 0) ||
+          (d == DataDimension::OH && ctx.pe_mapped_len[DataDimension::IH] > 0);
+}
+
+void Scheduler::BuildTileSpace( const SearchContext& ctx,
+                                const TilingCandidate& seed)
+{
+  for (int d = 0 ; d < kDimensionCnt ; d++) {
+    tile_space_[d].clear();
+    quot_space_[d].clear();
+  }
+  for (DataDimension d : kEncodingOrder) {
+    if (tile_enum_ == TileEnumeration::CLASS_TILES)
+      BuildTileClasses(ctx, d, seed.tile[d], &tile_space_[d]);
+    else
+      for (int tile = seed.tile[d] ; tile <= ctx.dim[d] ; tile++)
+        tile_space_[d].push_back(tile);
+    for (int tile : tile_space_[d])
+      quot_space_[d].push_back(CeilDiv(ctx.dim[d], tile));
   }
+  kw_itr_cnt_ = GetItrCnt(DataDimension::KW);
+  kh_itr_cnt_ = GetItrCnt(DataDimension::KH);
+  ow_itr_cnt_ = GetItrCnt(DataDimension::OW);
+  oh_itr_cnt_ = GetItrCnt(DataDimension::OH);
+  ic_itr_cnt_ = GetItrCnt(DataDimension::IC);
+  oc_itr_cnt_ = GetItrCnt(DataDimension::OC);
+  n_itr_cnt_  = GetItrCnt(DataDimension::N);
+  total_itr_ = 1;
+  for (DataDimension d : kEncodingOrder)
+    CHECK(!__builtin_mul_overflow(total_itr_, GetItrCnt(d), &total_itr_))
+      << "Tiling space does not fit in 64-bit encoded iterations";
+  for (int i = 0 ; i < kTileDimensionCnt ; i++)
+    itr_radix_[i] = GetItrRadix(kEncodingOrder[i]);
 }
 
-double Scheduler::GetEdp( const CnnLoop& loop, 
-                          const Architecture& arch, Stationary s) const
+void Scheduler::BuildTileClasses( const SearchContext& ctx, DataDimension d,
+                                  int min_tile, vector<int>* tiles) const
+{
+  const int len = ctx.dim[d];
+  // Tiles of a dimension unrolled on PE differ in PE utilization even in
+  // the same class, so every one of them is kept.
+  if (IsUnrollDimension(ctx, d)) {
+    for (int tile = min_tile ; tile <= len ; tile++) tiles->push_back(tile);
+    return;
+  }
+  // Tiles in the class [first, last] share the reload count ceil(len/tile).
+  // The smallest tile dominates the class with the smallest footprint.
+  for (int quot = (len + min_tile - 1) / min_tile ; quot >= 1 ; quot--) {
+    int first = max(min_tile, (len + quot - 1) / quot);
+    int last  = (quot == 1) ? len : (len - 1) / (quot - 1);
+    if (first > last) continue; // No tile gives this quotient.
+    tiles->push_back(first);
+  }
+}
+
+double Scheduler::GetEdp( const SearchContext& ctx,
+                          const TilingCandidate& cand, Stationary s) const
+{
+  return CalcEdp(ctx, GetDramAccesses(ctx, cand, s), GetPeUtil(ctx, cand));
+}
+
+double Scheduler::GetEdpLowerBound( const SearchContext& ctx,
+                                    const TilingCandidate& max_cand,
+                                    Stationary s) const
+{
+  // Unroll factors are only known for complete tilings,
+  // so PE utilization is bounded by 1.
+  return CalcEdp(ctx, GetDramAccesses(ctx, max_cand, s), 1.0);
+}
+
+double Scheduler::CalcEdp(const SearchContext& ctx,
+                          long int dram_accesses, double pe_util) const
 {
   const double correction_constant = 1000.0;
   // PE utilization number is much smaller than DRAM accesses size.
   // So, I make a correction constant to scale up the PE utilization number.
 
-  const VariableSet& varset = loop.GetVariableSet();
-  long int num_ops =  varset.GetKw() * varset.GetKh() * varset.GetIc() *
-                      varset.GetOw() * varset.GetOh() * varset.GetOc();
-  double pe_util = GetPeUtil(varset, arch);
-  long int dram_accesses = GetDramAccesses(varset, s);
-  int num_pe = arch.GetPeDim()[0][0] * arch.GetPeDim()[0][1];
-  double performance = min(
-    arch.GetFrequency() * num_pe * pe_util,
-    num_ops * arch.GetBandwidth() / dram_accesses
-  );
+  double performance = CalcPerformance(ctx, dram_accesses, pe_util);
   return dram_accesses / performance / correction_constant;
 }
 
-long int Scheduler::GetDramAccesses(const VariableSet& varset,Stationary s)const
+double Scheduler::CalcPerformance(const SearchContext& ctx,
+                                  long int dram_accesses, double pe_util) const
+{
+  // Roofline: bounded by either PE arrays or DRAM bandwidth (ops/ns).
+  return min(
+    ctx.frequency * ctx.num_pe * pe_util,
+    GetNumOps(ctx) * ctx.bandwidth / dram_accesses
+  );
+}
+
+long int Scheduler::GetNumOps(const SearchContext& ctx) const
+{
+  return  (long int)ctx.dim[DataDimension::KW] *
+          ctx.dim[DataDimension::KH] * ctx.dim[DataDimension::IC] *
+          ctx.dim[DataDimension::OW] * ctx.dim[DataDimension::OH] *
+          ctx.dim[DataDimension::OC] * ctx.dim[DataDimension::N];
+}
+
+long int Scheduler::GetOnChipBytes( const SearchContext& ctx,
+                                    const TilingCandidate& cand) const
+{
+  // Not fully tiled data is double buffered like IsMemorySizeOverflow.
+  long int input_size  = GetInputSize(ctx, cand.tile);
+  long int weight_size = GetWeightSize(cand.tile);
+  long int output_size = GetOutputSize(cand.tile);
+  if (input_size  < GetInputSize(ctx, ctx.dim))  input_size  *= 2;
+  if (weight_size < GetWeightSize(ctx.dim)) weight_size *= 2;
+  if (output_size < GetOutputSize(ctx.dim)) output_size *= 2;
+  return (input_size + weight_size + output_size) * sizeof(DataType);
+}
+
+double Scheduler::GetSearchEdp(const SearchContext& ctx,
+                                const TilingCandidate& cand,
+                                Stationary s, int* order) const
+{
+  if (loop_order_ == LoopOrderSearch::ALL_ORDERS) {
+    int quot[kDimensionCnt];
+    GetTileQuotients(ctx, cand, quot);
+    return GetBestOrderEdp(ctx, quot, GetPeUtil(ctx, cand), order);
+  }
+  *order = -1;
+  return GetEdp(ctx, cand, s);
+}
+
+double Scheduler::GetBestOrderEdp(const SearchContext& ctx, const int* quot,
+                                  double pe_util, int* order) const
+{
+  bool fully_tiled[kLoopCnt];
+  GetFullyTiled(quot, fully_tiled);
+  // Loop orders only differ by their stationary flags. Cost each flag set
+  // once and keep the first order reaching the minimum.
+  double flags_edp[1 << 3];
+  for (int f = 0 ; f < (1 << 3) ; f++)
+    flags_edp[f] = -1.0;
+  double best_edp = DBL_MAX;
+  for (int o = 0 ; o < kLoopOrderCnt ; o++) {
+    int flags = GetStationaryFlags(loop_orders_[o], fully_tiled, fully_tiled);
+    if (flags_edp[flags] < 0.0)
+      flags_edp[flags] = CalcEdp(ctx, GetOrderDramAccesses(ctx, quot, flags),
+                                 pe_util);
+    if (flags_edp[flags] < best_edp) {
+      best_edp = flags_edp[flags];
+      *order = o;
+    }
+  }
+  return best_edp;
+}
+
+double Scheduler::GetBestOrderEdpLowerBound(const SearchContext& ctx,
+                                            const TilingCandidate& min_cand,
+                                            const TilingCandidate& max_cand)
+                                            const
 {
-  long int input_accesses  =  GetInputDataReload(varset, s) *
-                              varset.GetOffLoopVariables().GetInputSize() *
-                              sizeof(DataType);
-  long int weight_accesses =  GetWeightDataReload(varset, s) *
-                              varset.GetOffLoopVariables().GetWeightSize() *
-                              sizeof(DataType);
-  long int output_accesses =  GetOutputDataReload(varset, s) *
-                              varset.GetOffLoopVariables().GetOutputSize() *
-                              sizeof(DataType);
-  long int total_accesses  =  input_accesses+weight_accesses+output_accesses;
+  // A loop may be fully tiled if it is with the largest tiles, and must be
+  // fully tiled if it is even with the smallest tiles. The flags of every
+  // completion of the subtree are a subset of the bounding flags.
+  int max_quot[kDimensionCnt], min_quot[kDimensionCnt];
+  bool may_full[kLoopCnt], must_full[kLoopCnt];
+  GetTileQuotients(ctx, max_cand, max_quot);
+  GetTileQuotients(ctx, min_cand, min_quot);
+  GetFullyTiled(max_quot, may_full);
+  GetFullyTiled(min_quot, must_full);
+  double bound = DBL_MAX;
+  for (int o = 0 ; o < kLoopOrderCnt ; o++) {
+    int flags = GetStationaryFlags(loop_orders_[o], may_full, must_full);
+    bound = min(bound,
+                CalcEdp(ctx, GetOrderDramAccesses(ctx, max_quot, flags), 1.0));
+  }
+  return bound;
+}
 
-  return total_accesses;
+void Scheduler::GetTileQuotients( const SearchContext& ctx,
+                                  const TilingCandidate& cand,
+                                  int* quot) const
+{
+  for (int d = 0 ; d < kDimensionCnt ; d++)
+    quot[d] = 1;
+  for (DataDimension d : kEncodingOrder)
+    quot[d] = CeilDiv(ctx.dim[d], cand.tile[d]);
 }
 
-int Scheduler::GetInputDataReload(const VariableSet& varset, Stationary s) const
+void Scheduler::GetFullyTiled(const int* quot, bool* fully_tiled) const
 {
-  return (s == Stationary::INPUT) ? 
-          1 : ceil((double)varset.GetKw() / varset.GetTkw()) *
-              ceil((double)varset.GetKh() / varset.GetTkh()) *
-              ceil((double)varset.GetOc() / varset.GetToc());
+  // A tile is never longer than its dimension, so a single off-chip
+  // iteration means fully tiled.
+  fully_tiled[Type::KERNEL_MAP] =
+    quot[DataDimension::KW] == 1 && quot[DataDimension::KH] == 1;
+  fully_tiled[Type::INPUT_CHANNEL] = quot[DataDimension::IC] == 1;
+  // Batch runs in the output map loop.
+  fully_tiled[Type::OUTPUT_MAP] =
+    quot[DataDimension::OW] == 1 && quot[DataDimension::OH] == 1 &&
+    quot[DataDimension::N] == 1;
+  fully_tiled[Type::OUTPUT_CHANNEL] = quot[DataDimension::OC] == 1;
 }
 
-int Scheduler::GetWeightDataReload(const VariableSet& varset,Stationary s) const
+int Scheduler::GetStationaryFlags(const Type* order, const bool* may_full,
+                                  const bool* must_full) const
 {
-  return (s == Stationary::WEIGHT) ?
-          1 : ceil((double)varset.GetOw() / varset.GetTow()) *
-              ceil((double)varset.GetOh() / varset.GetToh());
+  // Same rules as Structure::TagStationary.
+  const int input = 1 << Stationary::INPUT;
+  const int weight = 1 << Stationary::WEIGHT;
+  const int output = 1 << Stationary::OUTPUT;
+  int flags = 0;
+  if (may_full[Type::KERNEL_MAP] && may_full[Type::OUTPUT_CHANNEL])
+    flags |= input;
+  if (may_full[Type::OUTPUT_MAP])
+    flags |= weight;
+  if (may_full[Type::KERNEL_MAP] && may_full[Type::INPUT_CHANNEL])
+    flags |= output;
+  // Visit every loop which can be the innermost non fully tiled one.
+  // The outermost loop is taken even if it is fully tiled.
+  for (int loc = Location::INNER_MOST ; loc <= Location::OUTER_MOST ; loc++) {
+    Type type = order[loc];
+    if (loc < Location::OUTER_MOST && must_full[type]) continue;
+    switch (type) {
+      case Type::OUTPUT_CHANNEL: flags |= input;  break;
+      case Type::OUTPUT_MAP:     flags |= weight; break;
+      case Type::KERNEL_MAP:
+        if (may_full[Type::INPUT_CHANNEL] ||
+            (loc < Location::OUTER_MOST && order[loc+1]==Type::INPUT_CHANNEL))
+          flags |= output;
+        break;
+      case Type::INPUT_CHANNEL:
+        if (may_full[Type::KERNEL_MAP] ||
+            (loc < Location::OUTER_MOST && order[loc+1] == Type::KERNEL_MAP))
+          flags |= output;
+        break;
+      default:
+        LOG(ERROR) << "Invalid loop type: " << type;
+    }
+    if (!may_full[type]) break;
+  }
+  return flags;
 }
 
-int Scheduler::GetOutputDataReload(const VariableSet& varset,Stationary s) const
+long int Scheduler::GetOrderDramAccesses( const SearchContext& ctx,
+                                          const int* quot, int flags,
+                                          long int* data_bytes) const
 {
-  return (s == Stationary::OUTPUT) ?
-          1 : GetPsumReload(varset, s) + GetPsumStore(varset, s);
+  // Reload model of OffChipAccessAnalyzer.
+  long int km_itr = (long int)quot[DataDimension::KW] * quot[DataDimension::KH];
+  // Output channel tiles of other groups read other inputs, not reloads.
+  long int input_reload  = (flags & (1 << Stationary::INPUT)) ? 1 :
+    km_itr * CeilDiv(quot[DataDimension::OC], ctx.groups);
+  long int weight_reload = (flags & (1 << Stationary::WEIGHT)) ? 1 :
+    (long int)quot[DataDimension::OW] * quot[DataDimension::OH] *
+    quot[DataDimension::N];
+  long int psum_reload   = (flags & (1 << Stationary::OUTPUT)) ? 0 :
+    km_itr * quot[DataDimension::IC] - 1;
+
+  if (data_bytes != nullptr) {
+    data_bytes[Stationary::INPUT] =
+      input_reload * GetInputSize(ctx, ctx.dim) * sizeof(DataType);
+    data_bytes[Stationary::WEIGHT] =
+      weight_reload * GetWeightSize(ctx.dim) * sizeof(DataType);
+    data_bytes[Stationary::OUTPUT] =
+      (2*psum_reload + 1) * GetOutputSize(ctx.dim) * sizeof(DataType);
+  }
+  return (input_reload  * GetInputSize(ctx, ctx.dim)  +
+          weight_reload * GetWeightSize(ctx.dim) +
+          (2*psum_reload + 1) * GetOutputSize(ctx.dim)) * sizeof(DataType);
 }
 
-int Scheduler::GetPsumReload(const VariableSet& varset, Stationary s) const
+Structure* Scheduler::MakeLoopOrder(int order) const
 {
-  return (s == Stationary::OUTPUT) ?
-          0 : ceil((double)varset.GetKw() / varset.GetTkw()) *
-              ceil((double)varset.GetKh() / varset.GetTkh()) *
-              ceil((double)varset.GetIc() / varset.GetTic()) - 1;
+  Structure* strt = new Structure();
+  for (int loc = Location::INNER_MOST ; loc <= Location::OUTER_MOST ; loc++)
+    strt->Bind(loop_orders_[order][loc], (Location)loc);
+  return strt;
 }
 
-int Scheduler::GetPsumStore(const VariableSet& varset, Stationary s) const
+long int Scheduler::GetDramAccesses(const SearchContext& ctx,
+                                    const TilingCandidate& cand,
+                                    Stationary s, long int* data_bytes) const
 {
-  return (s == Stationary::OUTPUT) ?
-          0 : ceil((double)varset.GetKw() / varset.GetTkw()) *
-              ceil((double)varset.GetKh() / varset.GetTkh()) *
-              ceil((double)varset.GetIc() / varset.GetTic()) - 1;
+  // A fixed stationary is the flag set of itself in the loop order model,
+  // so both modes count DRAM accesses the same way.
+  int quot[kDimensionCnt];
+  GetTileQuotients(ctx, cand, quot);
+  return GetOrderDramAccesses(ctx, quot, 1 << s, data_bytes);
 }
 
-double Scheduler::GetPeUtil(const VariableSet& varset, const Architecture& arch)
-  const
+double Scheduler::GetPeUtil(const SearchContext& ctx,
+                            const TilingCandidate& cand) const
 {
+  if (ctx.pe_array_cnt > 1) return GetArraysPeUtil(ctx, cand, nullptr);
   double util = 1.0;
   const int row = 0, col = 1;
   for (int r_c = row ; r_c <= col ; r_c++) {
-    vector<DataDimension> dim_vec = arch.GetPeStructure()[r_c];
-    for (DataDimension dim : dim_vec) {
-      switch (dim) {
-        case DataDimension::KW:
-          util *= GetParamUtil(varset.GetTkw(), varset.GetPkw()); break;
-        case DataDimension::KH:
-          util *= GetParamUtil(varset.GetTkh(), varset.GetPkh()); break;
-        case DataDimension::IC:
-          util *= GetParamUtil(varset.GetTic(), varset.GetPic()); break;
-        case DataDimension::OW:
-          util *= GetParamUtil(varset.GetTow(), varset.GetPow()); break;
-        case DataDimension::OH:
-          util *= GetParamUtil(varset.GetToh(), varset.GetPoh()); break;
-        case DataDimension::OC:
-          util *= GetParamUtil(varset.GetToc(), varset.GetPoc()); break;
-        case DataDimension::IW:
-          util *= GetParamUtil(varset.GetTiw(), varset.GetPiw()); break;
-        case DataDimension::IH:
-          util *= GetParamUtil(varset.GetTih(), varset.GetPih()); break;
-        default:
-          LOG(ERROR) << "Invalid DataDimension: " << dim;
-      }
+    for (int i = 0 ; i < ctx.pe_strt_len[r_c] ; i++) {
+      DataDimension dim = ctx.pe_strt[r_c][i];
+      util *= GetParamUtil(cand.tile[dim], cand.parl[dim]);
     }
   }
   return util;
@@ -633,154 +1786,203 @@ double Scheduler::GetParamUtil(const int tile, const int unroll) const
   return (double)tile / (ceil((double)tile/unroll) * unroll);
 }
 
+double Scheduler::GetArraysPeUtil(const SearchContext& ctx,
+                                  const TilingCandidate& cand,
+                                  ArrayPartition* part) const
+{
+  static const DataDimension kComputeDims[] = {
+    DataDimension::KW, DataDimension::KH, DataDimension::IC,
+    DataDimension::OW, DataDimension::OH, DataDimension::OC, DataDimension::N
+  };
+  static const DataDimension kSplitDims[] = {
+    DataDimension::OC, DataDimension::OH
+  };
+  // Unrolling of each array for the whole tile. A share keeps the unrolling,
+  // so its cycles only step with ceil(share/unroll) along the split one.
+  int parl[kMaxPeArrayCnt][kDimensionCnt];
+  for (int a = 0 ; a < ctx.pe_array_cnt ; a++) {
+    TilingCandidate array_cand = cand;
+    if (a > 0) MakeParlLoopVariables(ctx, a, &array_cand);
+    for (int d = 0 ; d < kDimensionCnt ; d++)
+      parl[a][d] = array_cand.parl[d];
+  }
+  long int tile_ops = 1;
+  for (DataDimension d : kComputeDims)
+    tile_ops *= cand.tile[d];
+
+  ArrayPartition best;
+  best.cycles = LONG_MAX;
+  for (DataDimension split : kSplitDims) {
+    // Output rows are only split if channels cannot feed every array.
+    if (split == DataDimension::OH &&
+        cand.tile[DataDimension::OC] >= ctx.pe_array_cnt) break;
+    const int len = cand.tile[split];
+    long int rest[kMaxPeArrayCnt];
+    long int hi = LONG_MAX;
+    for (int a = 0 ; a < ctx.pe_array_cnt ; a++) {
+      rest[a] = 1;
+      for (DataDimension d : kComputeDims) {
+        if (d == split) continue;
+        rest[a] *= (cand.tile[d] + parl[a][d] - 1) / parl[a][d];
+      }
+      hi = min(hi, rest[a] * ((len + parl[a][split] - 1) / parl[a][split]));
+    }
+    // The smallest finish time in which the arrays cover the whole length.
+    long int lo = 1;
+    while (lo < hi) {
+      long int mid = lo + (hi - lo) / 2;
+      long int covered = 0;
+      for (int a = 0 ; a < ctx.pe_array_cnt && covered < len ; a++)
+        covered += mid / rest[a] * parl[a][split];
+      if (covered >= len) hi = mid;
+      else                lo = mid + 1;
+    }
+    if (lo >= best.cycles) continue;
+    best.dim = split;
+    best.cycles = lo;
+    // Any share within the capacity finishes in time. Spread the length by
+    // capacity in whole unrolled steps, and the remainder in order.
+    long int cap[kMaxPeArrayCnt];
+    long int total_cap = 0;
+    for (int a = 0 ; a < ctx.pe_array_cnt ; a++) {
+      cap[a] = min((long int)len, lo / rest[a] * parl[a][split]);
+      total_cap += cap[a];
+    }
+    int remain = len;
+    for (int a = 0 ; a < ctx.pe_array_cnt ; a++) {
+      long int even = len * cap[a] / total_cap;
+      best.share[a] = (int)(even / parl[a][split] * parl[a][split]);
+      remain -= best.share[a];
+    }
+    for (int a = 0 ; a < ctx.pe_array_cnt && remain > 0 ; a++) {
+      int add = (int)min((long int)remain, cap[a] - best.share[a]);
+      best.share[a] += add;
+      remain -= add;
+    }
+  }
+  double util = (double)tile_ops / ((double)ctx.num_pe * best.cycles);
+  // The other arrays may also stay idle. The tile then runs as on the first
+  // array alone and is costed as such, so adding arrays never costs more.
+  double first_util = 1.0;
+  long int first_cycles = 1;
+  for (int r_c = 0 ; r_c < 2 ; r_c++) {
+    for (int i = 0 ; i < ctx.pe_strt_len[r_c] ; i++) {
+      DataDimension dim = ctx.pe_strt[r_c][i];
+      first_util *= GetParamUtil(cand.tile[dim], parl[0][dim]);
+    }
+  }
+  for (DataDimension d : kComputeDims)
+    first_cycles *= (cand.tile[d] + parl[0][d] - 1) / parl[0][d];
+  first_util *= (double)ctx.pe_len[0][0] * ctx.pe_len[0][1] / ctx.num_pe;
+  if (first_util >= util) {
+    util = first_util;
+    best.dim = DataDimension::OC;
+    best.cycles = first_cycles;
+    best.share[0] = cand.tile[DataDimension::OC];
+    for (int a = 1 ; a < ctx.pe_array_cnt ; a++)
+      best.share[a] = 0;
+  }
+  if (part != nullptr) *part = best;
+  return util;
+}
+
 Variables Scheduler::MakeParlLoopVariables( const Variables& on_vars, 
                                             const Architecture& arch)
 {
+  VariableSet varset;
+  varset.SetOffLoopVariables(on_vars);
+  varset.SetOnLoopVariables(on_vars);
+
+  TilingCandidate cand = MakeTilingCandidate(varset);
+  MakeParlLoopVariables(MakeSearchContext(varset, arch), 0, &cand);
+  unique_ptr<VariableSet> parl_varset(MakeVariableSet(varset, cand));
+  return parl_varset->GetParlLoopVariables();
+}
+
+void Scheduler::MakeParlLoopVariables(const SearchContext& ctx, int array,
+                                      TilingCandidate* cand) const
+{
+  const int* on_vars = cand->tile;
+  int* parl_vars = cand->parl;
   // Initialize unroll loop variables
-  Variables parl_vars;
-  parl_vars.SetStride(on_vars.GetStride());
-  parl_vars.SetKw(1);
-  parl_vars.SetKh(1);
-  parl_vars.SetIc(1);
-  parl_vars.SetOw(1);
-  parl_vars.SetOh(1);
-  parl_vars.SetOc(1);
-  parl_vars.SetIw(1);
-  parl_vars.SetIh(1);
-  parl_vars.SetPw(on_vars.GetPw());
-  parl_vars.SetPh(on_vars.GetPh());
+  for (int d = 0 ; d < kDimensionCnt ; d++)
+    parl_vars[d] = 1;
   // Iterate from PE row to PE column
   for (int r_c = 0 ; r_c < 2 ; r_c++) { // r_c = 0: row, r_c = 1: column
-    int pe_len = arch.GetPeDim()[0][r_c];
+    int pe_len = ctx.pe_len[array][r_c];
+    const DataDimension* pe_strt = ctx.pe_strt[r_c];
     // Allocate based on Greatest Common Divisor first.
-    vector<vector<DataDimension>> pe_strt = arch.GetPeStructure();
-    for (DataDimension d : pe_strt[r_c]) {
-      int gcd = 1; // greatest common divisor
-      switch (d) {
-        case DataDimension::KW:
-          gcd = GreatestCommonDivisor(on_vars.GetKw(), pe_len);
-          parl_vars.SetKw(gcd);
-          break;
-        case DataDimension::KH:
-          gcd = GreatestCommonDivisor(on_vars.GetKh(), pe_len);
-          parl_vars.SetKh(gcd);
-          break;
-        case DataDimension::OC:
-          gcd = GreatestCommonDivisor(on_vars.GetOc(), pe_len);
-          parl_vars.SetOc(gcd);
-          break;
-        case DataDimension::IC:
-          gcd = GreatestCommonDivisor(on_vars.GetIc(), pe_len);
-          parl_vars.SetIc(gcd);
-          break;
-        case DataDimension::OW:
-          gcd = GreatestCommonDivisor(on_vars.GetOw(), pe_len);
-          parl_vars.SetOw(gcd);
-          break;
-        case DataDimension::OH:
-          gcd = GreatestCommonDivisor(on_vars.GetOh(), pe_len);
-          parl_vars.SetOh(gcd);
-          break;
-        case DataDimension::IW:
-          gcd = GreatestCommonDivisor(on_vars.GetIw(), pe_len);
-          parl_vars.SetIw(gcd);
-          break;
-        case DataDimension::IH:
-          gcd = GreatestCommonDivisor(on_vars.GetIh(), pe_len);
-          parl_vars.SetIh(gcd);
-          break;
-        default:
-          LOG(ERROR) << "Invalid data dimension: " << d;
-      }
+    for (int i = 0 ; i < ctx.pe_strt_len[r_c] ; i++) {
+      DataDimension d = pe_strt[i];
+      int gcd = GreatestCommonDivisor(on_vars[d], pe_len);
+      parl_vars[d] = gcd;
       pe_len /= gcd;
     }
     // Distribute remain factors.
-    for (DataDimension d : pe_strt[r_c]) {
-      vector<int> factors = PrimeFactorization(pe_len);
-      for (int factor : factors) {
-        switch (d) {
-          case DataDimension::KW:
-            if (on_vars.GetKw()/parl_vars.GetKw() >= factor) {
-              parl_vars.SetKw(parl_vars.GetKw() * factor);
-              pe_len /= factor;
-            }
-            break;
-          case DataDimension::KH:
-            if (on_vars.GetKh()/parl_vars.GetKh() >= factor) {
-              parl_vars.SetKh(parl_vars.GetKh() * factor);
-              pe_len /= factor;
-            }
-            break;
-          case DataDimension::OC:
-            if (on_vars.GetOc()/parl_vars.GetOc() >= factor) {
-              parl_vars.SetOc(parl_vars.GetOc() * factor);
-              pe_len /= factor;
-            }
-            break;
-          case DataDimension::IC:
-            if (on_vars.GetIc()/parl_vars.GetIc() >= factor) {
-              parl_vars.SetIc(parl_vars.GetIc() * factor);
-              pe_len /= factor;
-            }
-            break;
-          case DataDimension::OW:
-            if (on_vars.GetOw()/parl_vars.GetOw() >= factor) {
-              parl_vars.SetOw(parl_vars.GetOw() * factor);
-              pe_len /= factor;
-            }
-            break;
-          case DataDimension::OH:
-            if (on_vars.GetOh()/parl_vars.GetOh() >= factor) {
-              parl_vars.SetOh(parl_vars.GetOh() * factor);
-              pe_len /= factor;
-            }
-            break;
-          case DataDimension::IW:
-            if (on_vars.GetIw()/parl_vars.GetIw() >= factor) {
-              parl_vars.SetIw(parl_vars.GetIw() * factor);
-              pe_len /= factor;
-            }
-            break;
-          case DataDimension::IH:
-            if (on_vars.GetIh()/parl_vars.GetIh() >= factor) {
-              parl_vars.SetIh(parl_vars.GetIh() * factor);
-              pe_len /= factor;
-            }
-            break;
-          default:
-            LOG(ERROR) << "Invalid data dimension: " << d;
+    for (int i = 0 ; i < ctx.pe_strt_len[r_c] ; i++) {
+      DataDimension d = pe_strt[i];
+      int factors[kMaxPrimeFactorCnt];
+      int factor_cnt = GetRemainFactors(ctx, array, r_c, pe_len, factors);
+      for (int f = 0 ; f < factor_cnt ; f++) {
+        if (on_vars[d]/parl_vars[d] >= factors[f]) {
+          parl_vars[d] *= factors[f];
+          pe_len /= factors[f];
         }
       }
     }
   }
   // Following input and output width/height each other.
-  parl_vars.SetIw(max(parl_vars.GetKw(), parl_vars.GetIw()));
-  parl_vars.SetIh(max(parl_vars.GetKh(), parl_vars.GetIh()));
-  if (parl_vars.GetOw() == 1)
-    parl_vars.SetOw(CalcOutputLength(parl_vars.GetIw()));
-  if (parl_vars.GetOh() == 1)
-    parl_vars.SetOh(CalcOutputLength(parl_vars.GetIh()));
+  parl_vars[DataDimension::IW] = max( parl_vars[DataDimension::KW],
+                                      parl_vars[DataDimension::IW]);
+  parl_vars[DataDimension::IH] = max( parl_vars[DataDimension::KH],
+                                      parl_vars[DataDimension::IH]);
+  if (parl_vars[DataDimension::OW] == 1)
+    parl_vars[DataDimension::OW]=CalcOutputLength(parl_vars[DataDimension::IW]);
+  if (parl_vars[DataDimension::OH] == 1)
+    parl_vars[DataDimension::OH]=CalcOutputLength(parl_vars[DataDimension::IH]);
+}
 
-  return parl_vars;
+int Scheduler::GetRemainFactors(const SearchContext& ctx, int array, int r_c,
+                                int pe_len, int* factors) const
+{
+  // pe_len divides the PE length, so its prime factors are a subset of the
+  // precomputed ones and come out in the same ascending order.
+  int factor_cnt = 0;
+  const int* pe_factors = ctx.pe_factors[array][r_c];
+  for (int f = 0 ; f < ctx.pe_factor_cnt[array][r_c] && pe_len != 1 ; f++) {
+    if (pe_len % pe_factors[f] == 0) {
+      factors[factor_cnt++] = pe_factors[f];
+      pe_len /= pe_factors[f];
+    }
+  }
+  return factor_cnt;
 }
 
 bool Scheduler::IsMemorySizeOverflow( const VariableSet& varset, 
                                       const Architecture& arch) const
 {
-  const Variables& on_vars  = varset.GetOnLoopVariables();
-  const Variables& off_vars = varset.GetOffLoopVariables();
+  return IsMemorySizeOverflow(MakeSearchContext(varset, arch),
+                              MakeTilingCandidate(varset));
+}
 
-  int input_size  = on_vars.GetInputSize()  * sizeof(DataType); // Bytes
-  int weight_size = on_vars.GetWeightSize() * sizeof(DataType); // Bytes
-  int output_size = on_vars.GetOutputSize() * sizeof(DataType); // Bytes
+bool Scheduler::IsMemorySizeOverflow( const SearchContext& ctx,
+                                      const TilingCandidate& cand) const
+{
+  long int on_input_size  = GetInputSize(ctx, cand.tile);
+  long int on_weight_size = GetWeightSize(cand.tile);
+  long int on_output_size = GetOutputSize(cand.tile);
+
+  long int input_size  = on_input_size  * sizeof(DataType); // Bytes
+  long int weight_size = on_weight_size * sizeof(DataType); // Bytes
+  long int output_size = on_output_size * sizeof(DataType); // Bytes
 
   // If data is not fully tiled, it is double buffered. Or it is single buffered.
-  int input_mem_size  = (on_vars.GetInputSize() < off_vars.GetInputSize())   ?
-                        arch.GetInputMemSize() / 2 : arch.GetInputMemSize();
-  int weight_mem_size = (on_vars.GetWeightSize() < off_vars.GetWeightSize()) ?
-                        arch.GetWeightMemSize() / 2 : arch.GetWeightMemSize();
-  int output_mem_size = (on_vars.GetOutputSize() < off_vars.GetOutputSize()) ?
-                        arch.GetOutputMemSize() / 2 : arch.GetOutputMemSize();
+  long int input_mem_size  = (on_input_size < GetInputSize(ctx, ctx.dim))   ?
+                              ctx.input_mem_size / 2 : ctx.input_mem_size;
+  long int weight_mem_size = (on_weight_size < GetWeightSize(ctx.dim)) ?
+                              ctx.weight_mem_size / 2 : ctx.weight_mem_size;
+  long int output_mem_size = (on_output_size < GetOutputSize(ctx.dim)) ?
+                              ctx.output_mem_size / 2 : ctx.output_mem_size;
   
   // Overflow check
   return  input_size  > input_mem_size  ||
@@ -788,6 +1990,40 @@ bool Scheduler::IsMemorySizeOverflow( const VariableSet& varset,
           output_size > output_mem_size;
 }
 
+bool Scheduler::IsMemorySizeOverflowBound(const SearchContext& ctx,
+                                          const TilingCandidate& min_cand) const
+{
+  // Even a single buffered (fully tiled) memory cannot hold the smallest tile.
+  return  GetInputSize(ctx, min_cand.tile)  * (long int)sizeof(DataType) >
+            ctx.input_mem_size  ||
+          GetWeightSize(min_cand.tile) * (long int)sizeof(DataType) >
+            ctx.weight_mem_size ||
+          GetOutputSize(min_cand.tile) * (long int)sizeof(DataType) >
+            ctx.output_mem_size;
+}
+
+long int Scheduler::GetInputSize(const SearchContext& ctx,
+                                 const int* vars) const
+{
+  // Output channels of a tile read the input channels of each group spanned.
+  return (long int)vars[DataDimension::IW] * vars[DataDimension::IH] *
+                   vars[DataDimension::IC] * vars[DataDimension::N] *
+                   CalcGroupSpan(vars[DataDimension::OC], ctx.group_oc,
+                                 ctx.groups);
+}
+
+long int Scheduler::GetWeightSize(const int* vars) const
+{
+  return (long int)vars[DataDimension::KW] * vars[DataDimension::KH] *
+                   vars[DataDimension::IC] * vars[DataDimension::OC];
+}
+
+long int Scheduler::GetOutputSize(const int* vars) const
+{
+  return (long int)vars[DataDimension::OW] * vars[DataDimension::OH] *
+                   vars[DataDimension::OC] * vars[DataDimension::N];
+}
+
 int Scheduler::GreatestCommonDivisor(int a, int b) const
 {
   if (a < b) {
@@ -803,26 +2039,174 @@ int Scheduler::GreatestCommonDivisor(int a, int b) const
   return a;
 }
 
-vector<int> Scheduler::PrimeFactorization(int a)
+Structure* Scheduler::DecideOnLoopStructure(const VariableSet& varset,
+                                              const Architecture& arch) const
 {
-  vector<int> factors;
-  int prime_num = 2;
+  Structure* on_strt = new Structure();
+  on_strt->SetOutputStationary();
+  if (intra_order_ == IntraOrderSearch::FIXED_INTRA_ORDER) return on_strt;
 
-  while (a != 1) {
-    if (a % prime_num == 0) {
-      factors.push_back(prime_num);
-      a /= prime_num;
+  // Output stationary wins ties, so it is kept unless an order is cheaper.
+  Type fixed_order[kLoopCnt];
+  for (int loc = Location::INNER_MOST ; loc <= Location::OUTER_MOST ; loc++)
+    fixed_order[loc] = on_strt->Get((Location)loc);
+  int best_order = -1;
+  double best_energy = GetOnChipAccessEnergy(varset, arch, fixed_order);
+  for (int o = 0 ; o < kLoopOrderCnt ; o++) {
+    double energy = GetOnChipAccessEnergy(varset, arch, loop_orders_[o]);
+    if (energy < best_energy) {
+      best_energy = energy;
+      best_order = o;
+    }
+  }
+  if (best_order >= 0) {
+    delete on_strt;
+    on_strt = MakeLoopOrder(best_order);
+  }
+  /* #region Logging */
+  LOG(INFO) << "Intra loop order is decided.";
+  LOG(INFO) << "  On-chip access energy: " << best_energy;
+  LOG(INFO) << "  Inner most: " << on_strt->GetInnerMost();
+  LOG(INFO) << "  Outer most: " << on_strt->GetOuterMost();
+  /* #endregion */
+  return on_strt;
+}
+
+VariableSet* Scheduler::PartitionPeArrays( const VariableSet& varset,
+                                          const Architecture& arch) const
+{
+  VariableSet* new_varset = new VariableSet(varset);
+  if (arch.GetPeDim().size() <= 1) return new_varset;
+
+  SearchContext ctx = MakeSearchContext(varset, arch);
+  TilingCandidate cand = MakeTilingCandidate(varset);
+  ArrayPartition part;
+  double pe_util = GetArraysPeUtil(ctx, cand, &part);
+  vector<Variables> array_vars, array_parl_vars;
+  for (int a = 0 ; a < ctx.pe_array_cnt ; a++) {
+    // Each array keeps its unrolling of the whole tile as GetArraysPeUtil
+    // costs it. Unrolling a share on its own may take more steps.
+    TilingCandidate array_cand = cand;
+    if (a > 0) MakeParlLoopVariables(ctx, a, &array_cand);
+    SetCandidateTile(ctx, cand, part.dim, part.share[a], &array_cand);
+    if (part.share[a] > 0) {
+      int& split_parl = array_cand.parl[part.dim];
+      split_parl = min(split_parl, part.share[a]);
+      if (part.dim == DataDimension::OH)
+        array_cand.parl[DataDimension::IH] = min(
+          array_cand.parl[DataDimension::IH],
+          array_cand.tile[DataDimension::IH]);
     } else {
-      prime_num++;
+      // Idle array. Its share and unrolling are empty along the split.
+      array_cand.tile[part.dim] = array_cand.parl[part.dim] = 0;
+      if (part.dim == DataDimension::OH)
+        array_cand.tile[DataDimension::IH] =
+          array_cand.parl[DataDimension::IH] = 0;
     }
+    unique_ptr<VariableSet> array_varset(MakeVariableSet(varset, array_cand));
+    array_vars.push_back(array_varset->GetOnLoopVariables());
+    array_parl_vars.push_back(array_varset->GetParlLoopVariables());
+    /* #region Logging */
+    LOG(INFO) << "PE array " << a << " computes " << part.share[a]
+              << " of " << cand.tile[part.dim] << " "
+              << ((part.dim == DataDimension::OC) ? "output channels" :
+                                                    "output rows");
+    /* #endregion */
+  }
+  new_varset->SetArrayLoopVariables(array_vars, array_parl_vars);
+  /* #region Logging */
+  LOG(INFO) << "PE arrays are partitioned.";
+  LOG(INFO) << "  Cycles per tile: " << part.cycles;
+  LOG(INFO) << "  PE utilization: " << pe_util;
+  /* #endregion */
+  return new_varset;
+}
+
+long int Scheduler::GetLoopDramAccesses(const CnnLoop& loop,
+                                        const Architecture& arch,
+                                        long int* data_bytes) const
+{
+  // With memory levels, the outermost level tile crosses the chip boundary.
+  VariableSet varset(loop.GetVariableSet());
+  const Structure* off_strt = &loop.GetOffStructure();
+  if (!varset.GetLevelLoopVariables().empty()) {
+    varset.SetOnLoopVariables(varset.GetLevelLoopVariables()[0]);
+    off_strt = &loop.GetLevelStructures()[0];
   }
-  return factors;
+  SearchContext ctx = MakeSearchContext(varset, arch);
+  int quot[kDimensionCnt];
+  bool fully_tiled[kLoopCnt];
+  GetTileQuotients(ctx, MakeTilingCandidate(varset), quot);
+  GetFullyTiled(quot, fully_tiled);
+  Type order[kLoopCnt];
+  for (int loc = Location::INNER_MOST ; loc <= Location::OUTER_MOST ; loc++)
+    order[loc] = off_strt->Get((Location)loc);
+  int flags = GetStationaryFlags(order, fully_tiled, fully_tiled);
+  return GetOrderDramAccesses(ctx, quot, flags, data_bytes);
 }
 
-//TODO (MinsuKim): Make algorithm to decide on-chip loop structure.
-Structure* Scheduler::FixOnLoopStructure(void)
+double Scheduler::GetOnChipAccessEnergy(const VariableSet& varset,
+                                        const Architecture& arch,
+                                        const Type* order) const
 {
-  Structure* fix_strt = new Structure();
-  fix_strt->SetOutputStationary();
-  return fix_strt;
+  // Intra loop iterations of each loop type.
+  long int trip[kLoopCnt];
+  trip[Type::KERNEL_MAP] =
+    (long int)CeilDiv(varset.GetTkw(), varset.GetPkw()) *
+    CeilDiv(varset.GetTkh(), varset.GetPkh());
+  trip[Type::INPUT_CHANNEL] = CeilDiv(varset.GetTic(), varset.GetPic());
+  trip[Type::OUTPUT_MAP] =
+    (long int)CeilDiv(varset.GetTow(), varset.GetPow()) *
+    CeilDiv(varset.GetToh(), varset.GetPoh()) *
+    CeilDiv(varset.GetTn(), varset.GetPn());
+  trip[Type::OUTPUT_CHANNEL] = CeilDiv(varset.GetToc(), varset.GetPoc());
+  // Words each PE array step reads for input and weight, and reads and
+  // writes back for partial sums.
+  const int group_oc = varset.GetGroupOc();
+  const int groups = varset.GetGroups();
+  long int input_words  = (long int)varset.GetPic() * varset.GetPih() *
+                          varset.GetPiw() *
+                          CalcGroupSpan(varset.GetPoc(), group_oc, groups);
+  long int weight_words = (long int)varset.GetPoc() * varset.GetPic() *
+                          varset.GetPkh() * varset.GetPkw();
+  long int psum_words   = 2L * varset.GetPoc() * varset.GetPoh() *
+                          varset.GetPow();
+  // A loop does not index input (OC), weight (OM) or partial sums (KM, IC).
+  // Output channels index input once they step over groups.
+  const int kInputFree  = (CalcGroupSpan(varset.GetToc(), group_oc, groups) ==
+                           1) ? 1 << Type::OUTPUT_CHANNEL : 0;
+  const int kWeightFree = 1 << Type::OUTPUT_MAP;
+  const int kPsumFree   = (1 << Type::KERNEL_MAP) | (1 << Type::INPUT_CHANNEL);
+
+  long int steps = 1;
+  for (int t = 0 ; t < kLoopCnt ; t++)
+    steps *= trip[t];
+  // Loops of one iteration are skipped like fully tiled loops in
+  // Structure::TagStationary, so they do not break the register reuse.
+  auto reuse = [&trip, order](int free_mask) {
+    long int r = 1;
+    for (int loc = Location::INNER_MOST ; loc <= Location::OUTER_MOST ;
+         loc++) {
+      Type t = order[loc];
+      if (trip[t] == 1) continue;
+      if (!(free_mask & (1 << t))) break;
+      r *= trip[t];
+    }
+    return r;
+  };
+  double words =  (double)input_words  * (steps / reuse(kInputFree)) +
+                  (double)weight_words * (steps / reuse(kWeightFree)) +
+                  (double)psum_words   * (steps / reuse(kPsumFree));
+  // Every off-chip iteration runs the same intra loop. Without on-chip
+  // energy (compiler) the energy is counted in 32-bit words.
+  double off_itrs = (double)CeilDiv(varset.GetKw(), varset.GetTkw()) *
+                    CeilDiv(varset.GetKh(), varset.GetTkh()) *
+                    CeilDiv(varset.GetIc(), varset.GetTic()) *
+                    CeilDiv(varset.GetOw(), varset.GetTow()) *
+                    CeilDiv(varset.GetOh(), varset.GetToh()) *
+                    CeilDiv(varset.GetOc(), varset.GetToc()) *
+                    CeilDiv(varset.GetN(), varset.GetTn());
+  double energy_32 = (arch.GetOnChipEnergy() > 0) ?
+                      arch.GetOnChipEnergy() : 1.0;
+  return words * off_itrs * energy_32;
 }
@@ -0,0 +1,120 @@
+#include "loop/search_engine.h"
+
+#include <float.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+using std::atomic;
+using std::thread;
+using std::vector;
+
+using loop::SearchEngine;
+using loop::TilingSpace;
+using loop::SearchResult;
+using loop::EncodedItr;
+
+void SearchEngine::ResetStats(unsigned int num_threads)
+{
+  busy_time_.assign(num_threads, 0.0);
+  steal_cnt_.assign(num_threads, 0);
+  prune_cnt_.assign(num_threads, 0);
+}
+
+void SearchEngine::RunJobs( unsigned int num_threads, int job_cnt,
+                            const function<void(unsigned int, int)>& job)
+{
+  ResetStats(num_threads);
+  atomic<int> next_job(0);
+  unsigned int thread_cnt = std::min(num_threads, (unsigned int)job_cnt);
+  vector<thread> workers;
+  for (unsigned int thr = 0 ; thr < thread_cnt ; thr++) {
+    workers.push_back(thread([this, &next_job, &job, job_cnt, thr]() {
+      for (int j = next_job++ ; j < job_cnt ; j = next_job++) {
+        auto job_start = std::chrono::steady_clock::now();
+        job(thr, j);
+        std::chrono::duration<double, std::milli> job_time =
+          std::chrono::steady_clock::now() - job_start;
+        busy_time_[thr] += job_time.count();
+      }
+    }));
+  }
+  for (thread& worker : workers)
+    worker.join();
+}
+
+EncodedItr SearchEngine::CountTilings(const TilingSpace& space)
+{
+  return GetDigitWeight(space, kTileDimensionCnt);
+}
+
+EncodedItr SearchEngine::GetDigitWeight(const TilingSpace& space, int digit)
+{
+  EncodedItr weight = 1;
+  for (int i = 0 ; i < digit ; i++)
+    weight *= space.GetRadix(i);
+  return weight;
+}
+
+uint64_t SearchEngine::GetJobSeed(int job) const
+{
+  uint64_t state = seed_ + 0x9E3779B97F4A7C15ULL*(uint64_t)(job+1);
+  return NextRandom(&state);
+}
+
+void SearchEngine::MergeResult(const SearchResult& from, SearchResult* to)
+{
+  if (to->edp > from.edp || (to->edp == from.edp && to->itr < from.itr))
+    *to = from;
+}
+
+void SearchEngine::RandomizeDigits( const TilingSpace& space,
+                                    uint64_t* rng_state, int* digit)
+{
+  for (int i = 0 ; i < kTileDimensionCnt ; i++)
+    digit[i] = NextRandomInt(rng_state, space.GetRadix(i));
+}
+
+bool SearchEngine::RepairDigits(TilingSpace* space, unsigned int thr,
+                                uint64_t* rng_state, int max_try, int* digit,
+                                SearchResult* result, EncodedItr* eval_cnt)
+{
+  // Smaller tiles never need more memory, so shrinking random digits
+  // approaches the all-smallest tiling, which fits if anything does.
+  for (int t = 0 ; t < max_try ; t++) {
+    (*eval_cnt)++;
+    if (space->Evaluate(thr, digit, result)) return true;
+    int nonzero_cnt = 0;
+    for (int i = 0 ; i < kTileDimensionCnt ; i++)
+      nonzero_cnt += (digit[i] > 0);
+    if (nonzero_cnt == 0) return false;
+    int pick = NextRandomInt(rng_state, nonzero_cnt);
+    for (int i = 0 ; i < kTileDimensionCnt ; i++) {
+      if (digit[i] > 0 && pick-- == 0) {
+        digit[i] = NextRandomInt(rng_state, digit[i]);
+        break;
+      }
+    }
+  }
+  return false;
+}
+
+uint64_t SearchEngine::NextRandom(uint64_t* rng_state)
+{
+  uint64_t z = (*rng_state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+int SearchEngine::NextRandomInt(uint64_t* rng_state, int n)
+{
+  return (int)(NextRandom(rng_state) % (uint64_t)n);
+}
+
+double SearchEngine::NextRandomDouble(uint64_t* rng_state)
+{
+  return (NextRandom(rng_state) >> 11) * (1.0 / 9007199254740992.0);
+}
@@ -0,0 +1,44 @@
+#include "loop/search_queue.h"
+
+using loop::SearchQueue;
+using loop::SearchChunk;
+
+void SearchQueue::Push(const SearchChunk& chunk)
+{
+  mtx_lock_.lock();
+  chunks_.push_back(chunk);
+  mtx_lock_.unlock();
+}
+
+bool SearchQueue::Pop(SearchChunk* chunk)
+{
+  bool is_popped = false;
+  mtx_lock_.lock();
+  if (!chunks_.empty()) {
+    *chunk = chunks_.front();
+    chunks_.pop_front();
+    is_popped = true;
+  }
+  mtx_lock_.unlock();
+  return is_popped;
+}
+
+bool SearchQueue::Steal(SearchChunk* chunk)
+{
+  bool is_stolen = false;
+  mtx_lock_.lock();
+  if (!chunks_.empty()) {
+    *chunk = chunks_.back();
+    chunks_.pop_back();
+    is_stolen = true;
+  }
+  mtx_lock_.unlock();
+  return is_stolen;
+}
+
+void SearchQueue::Clear(void)
+{
+  mtx_lock_.lock();
+  chunks_.clear();
+  mtx_lock_.unlock();
+}
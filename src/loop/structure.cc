@@ -261,7 +261,8 @@ void Structure::TagStationary(const loop::Variables& upper,
     km_fully_tiled_ = true;
   if (upper.GetIc() == lower.GetIc())
     ic_fully_tiled_ = true;
-  if (upper.GetOw() == lower.GetOw() && upper.GetOh() == lower.GetOh())
+  if (upper.GetOw() == lower.GetOw() && upper.GetOh() == lower.GetOh() &&
+      upper.GetN() == lower.GetN()) // Batch runs in the output map loop.
     om_fully_tiled_ = true;
   if (upper.GetOc() == lower.GetOc())
     oc_fully_tiled_ = true;
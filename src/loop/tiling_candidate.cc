@@ -0,0 +1,41 @@
+#include "loop/tiling_candidate.h"
+
+#include <string>
+#include <iomanip>
+
+using std::string;
+
+using loop::ShardResult;
+using loop::kDimensionCnt;
+
+ostream& loop::operator<<(ostream& os, const ShardResult& shard)
+{
+  std::streamsize precision = os.precision(17);
+  os << "shard " << shard.begin << " " << shard.end << " " << shard.total
+     << " " << shard.result.edp << " " << shard.result.itr
+     << " " << shard.result.order;
+  for (int d = 0 ; d < kDimensionCnt ; d++)
+    os << " " << shard.result.cand.tile[d];
+  for (int d = 0 ; d < kDimensionCnt ; d++)
+    os << " " << shard.result.cand.parl[d];
+  os << "\n";
+  os.precision(precision);
+  return os;
+}
+
+istream& loop::operator>>(istream& is, ShardResult& shard)
+{
+  string tag;
+  if (!(is >> tag)) return is;
+  if (tag != "shard") {
+    is.setstate(std::ios::failbit);
+    return is;
+  }
+  is >> shard.begin >> shard.end >> shard.total
+     >> shard.result.edp >> shard.result.itr >> shard.result.order;
+  for (int d = 0 ; d < kDimensionCnt ; d++)
+    is >> shard.result.cand.tile[d];
+  for (int d = 0 ; d < kDimensionCnt ; d++)
+    is >> shard.result.cand.parl[d];
+  return is;
+}
@@ -15,7 +15,7 @@ VariableSet::VariableSet(const Parameter& param)
     
   SetIw(param.GetIw());
   SetIh(param.GetIh());
-  SetIc(param.GetIc());
+  SetIc(param.GetIc() / param.GetGroups());
 
   SetPw(param.GetPw());
   SetPh(param.GetPh());
@@ -26,6 +26,8 @@ VariableSet::VariableSet(const Parameter& param)
   SetOw(CalcOutputLength(param.GetIw()));
   SetOh(CalcOutputLength(param.GetIh()));
   SetOc(param.GetOc());
+  SetN(param.GetBatch());
+  SetGroups(param.GetGroups());
 }
 
 void VariableSet::SetStride(const int stride)
@@ -89,6 +91,17 @@ void VariableSet::SetOc(const int output_channel)
   off_loop_vars_.SetOc(output_channel);
 }
 
+void VariableSet::SetN(const int batch)
+{
+  off_loop_vars_.SetN(batch);
+}
+
+void VariableSet::SetGroups(const int groups)
+{
+  groups_ = groups;
+  group_oc_ = off_loop_vars_.GetOc() / groups;
+}
+
 void VariableSet::SetTiw(const int tile_input_width)
 {
   on_loop_vars_.SetIw(tile_input_width);
@@ -129,6 +142,11 @@ void VariableSet::SetToc(const int tile_output_channel)
   on_loop_vars_.SetOc(tile_output_channel);
 }
 
+void VariableSet::SetTn(const int tile_batch)
+{
+  on_loop_vars_.SetN(tile_batch);
+}
+
 void VariableSet::SetPiw(const int parallel_input_width)
 {
   parl_loop_vars_.SetIw(parallel_input_width);
@@ -169,6 +187,11 @@ void VariableSet::SetPoc(const int parallel_output_channel)
   parl_loop_vars_.SetOc(parallel_output_channel);
 }
 
+void VariableSet::SetPn(const int parallel_batch)
+{
+  parl_loop_vars_.SetN(parallel_batch);
+}
+
 void VariableSet::SetOffLoopVariables(loop::Variables off_loop_vars)
 {
   off_loop_vars_ = off_loop_vars;
@@ -184,6 +207,23 @@ void VariableSet::SetParlLoopVariables(loop::Variables parl_loop_vars)
   parl_loop_vars_ = parl_loop_vars;
 }
 
+void VariableSet::SetLevelLoopVariables(
+  const vector<loop::Variables>& level_loop_vars)
+{
+  level_loop_vars_ = level_loop_vars;
+}
+
+void VariableSet::SetArrayLoopVariables(
+  const vector<loop::Variables>& array_loop_vars,
+  const vector<loop::Variables>& array_parl_vars)
+{
+  CHECK(array_loop_vars.size() == array_parl_vars.size())
+    << "Share and unrolling of PE arrays are different in number: "
+    << array_loop_vars.size() << ", " << array_parl_vars.size();
+  array_loop_vars_ = array_loop_vars;
+  array_parl_vars_ = array_parl_vars;
+}
+
 int VariableSet::GetStride(void) const
 {
   CHECK(off_loop_vars_.GetStride() == on_loop_vars_.GetStride())
@@ -247,6 +287,21 @@ int VariableSet::GetOc(void) const
   return off_loop_vars_.GetOc();
 }
 
+int VariableSet::GetN(void) const
+{
+  return off_loop_vars_.GetN();
+}
+
+int VariableSet::GetGroups(void) const
+{
+  return groups_;
+}
+
+int VariableSet::GetGroupOc(void) const
+{
+  return group_oc_;
+}
+
 int VariableSet::GetTiw(void) const
 {
   return on_loop_vars_.GetIw();
@@ -287,6 +342,11 @@ int VariableSet::GetToc(void) const
   return on_loop_vars_.GetOc();
 }
 
+int VariableSet::GetTn(void) const
+{
+  return on_loop_vars_.GetN();
+}
+
 int VariableSet::GetPiw(void) const
 {
   return parl_loop_vars_.GetIw();
@@ -326,6 +386,11 @@ int VariableSet::GetPoc(void) const
   return parl_loop_vars_.GetOc();
 }
 
+int VariableSet::GetPn(void) const
+{
+  return parl_loop_vars_.GetN();
+}
+
 const loop::Variables& VariableSet::GetOffLoopVariables(void) const
 {
   return off_loop_vars_;
@@ -342,14 +407,48 @@ const loop::Variables& VariableSet::GetParlLoopVariables(void)
   return parl_loop_vars_;
 }
 
+const vector<loop::Variables>& VariableSet::GetLevelLoopVariables(void) const
+{
+  return level_loop_vars_;
+}
+
+const vector<loop::Variables>& VariableSet::GetArrayLoopVariables(void) const
+{
+  return array_loop_vars_;
+}
+
+const vector<loop::Variables>& VariableSet::GetArrayParlLoopVariables(void)
+  const
+{
+  return array_parl_vars_;
+}
+
+long int VariableSet::GetInputSize(const loop::Variables& vars) const
+{
+  return vars.GetInputSize() *
+         CalcGroupSpan(vars.GetOc(), group_oc_, groups_);
+}
+
 void VariableSet::CheckValid(void) const
 {
   off_loop_vars_.CheckValid();
   on_loop_vars_.CheckValid();
   parl_loop_vars_.CheckValid();
   
-  CheckVariablesRange(off_loop_vars_, on_loop_vars_);
+  const loop::Variables* upper = &off_loop_vars_;
+  for (const loop::Variables& level_vars : level_loop_vars_) {
+    level_vars.CheckValid();
+    CheckVariablesRange(*upper, level_vars);
+    upper = &level_vars;
+  }
+  CheckVariablesRange(*upper, on_loop_vars_);
   CheckVariablesRange(on_loop_vars_, parl_loop_vars_);
+  for (size_t a = 0 ; a < array_loop_vars_.size() ; a++) {
+    array_loop_vars_[a].CheckValid();
+    array_parl_vars_[a].CheckValid();
+    CheckVariablesRange(on_loop_vars_, array_loop_vars_[a]);
+    CheckVariablesRange(array_loop_vars_[a], array_parl_vars_[a]);
+  }
 }
 
 void VariableSet::CheckVariablesRange(const loop::Variables& upper, 
@@ -387,6 +486,10 @@ void VariableSet::CheckVariablesRange(const loop::Variables& upper,
     << "Upper output channel is smaller than lower output channel: "
     << "upper(" << upper.GetOc() << ") "
     << "lower(" << lower.GetOc() << ")";
+  CHECK(upper.GetN() >= lower.GetN())
+    << "Upper batch is smaller than lower batch: "
+    << "upper(" << upper.GetN() << ") "
+    << "lower(" << lower.GetN() << ")";
 }
 
 ostream& loop::operator<<(ostream& out, const loop::VariableSet& varset)
@@ -397,5 +500,15 @@ ostream& loop::operator<<(ostream& out, const loop::VariableSet& varset)
       << varset.GetOnLoopVariables()      << endl
       << "Parallelization Loop Variables."<< endl 
       << varset.GetParlLoopVariables()    << endl;
+  for (size_t l = 0 ; l < varset.GetLevelLoopVariables().size() ; l++) {
+    out << "Memory Level " << l << " Loop Variables." << endl
+        << varset.GetLevelLoopVariables()[l]          << endl;
+  }
+  for (size_t a = 0 ; a < varset.GetArrayLoopVariables().size() ; a++) {
+    out << "PE Array " << a << " Loop Variables."                 << endl
+        << varset.GetArrayLoopVariables()[a]                      << endl
+        << "PE Array " << a << " Parallelization Loop Variables." << endl
+        << varset.GetArrayParlLoopVariables()[a]                  << endl;
+  }
   return out;
 }
@@ -63,6 +63,11 @@ void Variables::SetOc(const int output_channel)
   output_channel_ = output_channel;
 }
 
+void Variables::SetN(const int batch)
+{
+  batch_ = batch;
+}
+
 void Variables::SetStride(const int stride)
 {
   stride_ = stride;
@@ -118,6 +123,11 @@ int Variables::GetOc(void) const
   return output_channel_;
 }
 
+int Variables::GetN(void) const
+{
+  return batch_;
+}
+
 int Variables::GetStride(void) const
 {
   return stride_;
@@ -125,7 +135,7 @@ int Variables::GetStride(void) const
 
 long int Variables::GetInputSize(void) const
 {
-  return input_width_ * input_height_ * input_channel_;
+  return (long int)batch_ * input_width_ * input_height_ * input_channel_;
 }
 
 long int Variables::GetWeightSize(void) const
@@ -135,7 +145,7 @@ long int Variables::GetWeightSize(void) const
 
 long int Variables::GetOutputSize(void) const
 {
-  return output_width_ * output_height_ * output_channel_;
+  return (long int)batch_ * output_width_ * output_height_ * output_channel_;
 }
 
 void Variables::CheckValid(void) const
@@ -151,6 +161,8 @@ void Variables::CheckValid(void) const
   CHECK(output_height_ > NON_VALID) << "output height is NON_VALID";
   CHECK(output_channel_ > NON_VALID) << "output channel is NON_VALID";
 
+  CHECK(batch_ > 0) << "batch is non-valid";
+
   CHECK(stride_ > NON_VALID) << "Stride is NON_VALID";
 }
 
@@ -166,7 +178,8 @@ ostream& loop::operator<<(ostream& out, const loop::Variables& var)
       << "Kernel_height: " << var.GetKh() << endl
       << "Output_width: " << var.GetOw() << endl
       << "Output_height: " << var.GetOh() << endl
-      << "Output_channel: " << var.GetOc() << endl;
+      << "Output_channel: " << var.GetOc() << endl
+      << "Batch: " << var.GetN() << endl;
   return out;
 }
 
@@ -174,6 +187,7 @@ istream& loop::operator>>(istream& in, loop::Variables& var)
 {
   std::string dummy; // get rid of dummy string in front of value.
   int stride=NON_VALID, 
+      batch=1,
       input_width=NON_VALID, 
       input_height=NON_VALID, 
       input_channel=NON_VALID,
@@ -196,8 +210,12 @@ istream& loop::operator>>(istream& in, loop::Variables& var)
       >> dummy >> output_width
       >> dummy >> output_height
       >> dummy >> output_channel;
+  // Batch comes last, and dumps written before it existed stop here.
+  if ((in >> std::ws).peek() == 'B')
+    in >> dummy >> batch;
   /* #region Error Check */
   CHECK(stride>NON_VALID)<<"Non-valid stride: "<<stride;
+  CHECK(batch>0)<<"Non-valid batch: "<<batch;
   CHECK(input_width>NON_VALID)<<"Non-valid input width: "<<input_width;
   CHECK(input_height>NON_VALID)<<"Non-valid input height: "<<input_height;
   CHECK(input_channel>NON_VALID)<<"Non-valid input channel: "<<input_channel;
@@ -210,6 +228,7 @@ istream& loop::operator>>(istream& in, loop::Variables& var)
   CHECK(output_channel>NON_VALID)<<"Non-valid output channel: "<<output_channel;
   /* #endregion */
   var.SetStride(stride);
+  var.SetN(batch);
   var.SetIw(input_width);
   var.SetIh(input_height);
   var.SetIc(input_channel);
@@ -0,0 +1,84 @@
+#include <glog/logging.h>
+#include <iostream>
+#include <memory>
+#include <fstream>
+
+#include "general/data_type.h"
+#include "parameter/network_parser.h"
+#include "parameter/network_parameter.h"
+#include "arch/architecture.h"
+#include "graph/layer_parser.h"
+#include "loop/network_scheduler.h"
+
+using std::cout;
+using std::endl;
+using std::unique_ptr;
+using std::ofstream;
+
+using parameter::NetworkParser;
+using arch::Architecture;
+using graph::Network;
+using loop::NetworkScheduler;
+using loop::NetworkPlan;
+using loop::LayerPlan;
+
+// Initialize global variables.
+int kStride     = NON_VALID;
+int kFilter_len = NON_VALID;
+int kPadding    = NON_VALID;
+
+int main(int argc, char** argv)
+{
+  google::InitGoogleLogging(argv[0]);
+  google::SetLogDestination(google::GLOG_INFO, "log/log.");
+
+  cout << "[Back-end][Network] Build network planner parameter..." << endl;
+  unique_ptr<NetworkParser> parser(new NetworkParser());
+  unique_ptr<NetworkParameter> param(parser->BuildParameter(argc, argv));
+  cout << "[Back-end][Network] Success to build parameter!" << endl;
+
+  unique_ptr<Architecture> arch(new Architecture(*param));
+  unique_ptr<Network> network(graph::ParseNetwork(param->GetNetworkFile()));
+
+  cout << "[Back-end][Network] Search schedules of each layer..." << endl;
+  NetworkScheduler sched(*network, *arch, param->GetSearchMode());
+  sched.SetObjective(param->GetObjective());
+  cout << "[Back-end][Network] Search the network plan..." << endl;
+  NetworkPlan plan = sched.SearchNetworkPlan();
+
+  cout  << "---------------------------------------------------------" <<endl
+        << "                     Network plan"                          <<endl
+        << "---------------------------------------------------------" <<endl;
+  for (const LayerPlan& layer : plan.layers) {
+    cout << "  " << layer.name << ": point " << layer.point
+         << ", input " << (layer.is_input_resident ? "on-chip" : "DRAM")
+         << ", output " << (layer.is_output_resident ? "on-chip" : "DRAM")
+         << ", " << layer.dram_bytes << " Bytes, " << layer.latency
+         << " ns, " << layer.energy << " nJ" << endl;
+  }
+  cout << "  Network plan: " << plan.dram_bytes << " Bytes, "
+       << plan.latency << " ns, " << plan.energy << " nJ" << endl;
+  cout << "  Layer by layer: " << plan.layerwise_dram_bytes << " Bytes, "
+       << plan.layerwise_latency << " ns, " << plan.layerwise_energy
+       << " nJ" << endl;
+
+  ofstream report(param->GetReportFile());
+  CHECK(report.is_open()) << "Cannot open report: " << param->GetReportFile();
+  report << "layer,point,input_resident,output_resident,dram_bytes,"
+         << "latency_ns,energy_nJ" << endl;
+  for (const LayerPlan& layer : plan.layers) {
+    report << layer.name << "," << layer.point << ","
+           << (layer.is_input_resident ? "TRUE" : "FALSE") << ","
+           << (layer.is_output_resident ? "TRUE" : "FALSE") << ","
+           << layer.dram_bytes << "," << layer.latency << ","
+           << layer.energy << endl;
+  }
+  report << "network,,,," << plan.dram_bytes << "," << plan.latency << ","
+         << plan.energy << endl;
+  report << "layer_by_layer,,,," << plan.layerwise_dram_bytes << ","
+         << plan.layerwise_latency << "," << plan.layerwise_energy << endl;
+  cout << "[Back-end][Network] Write report to " << param->GetReportFile()
+       << endl;
+
+  return 0;
+}
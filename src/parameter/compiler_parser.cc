@@ -2,8 +2,10 @@
 
 #include <glog/logging.h>
 #include <stdlib.h>
+#include <stdio.h>
 #include <string.h>
 #include <iostream>
+#include <algorithm>
 
 #include "general/utils.h"
 #include "general/data_type.h"
@@ -12,6 +14,7 @@ using parameter::CompilerParser;
 
 using std::cout;
 using std::endl;
+using std::vector;
 
 CompilerParameter* CompilerParser::BuildParameter(int argc, char** argv)
 {
@@ -87,6 +90,12 @@ void CompilerParser::ParseLongOptions(int opt_index, char* exe_cmd,
   if (strcmp(c_options[opt_index].name, "oc") == 0) {
     param->SetOc(atoi(optarg));
   } else 
+  if (strcmp(c_options[opt_index].name, "batch") == 0) {
+    param->SetBatch(atoi(optarg));
+  } else 
+  if (strcmp(c_options[opt_index].name, "groups") == 0) {
+    param->SetGroups(atoi(optarg));
+  } else 
   if (strcmp(c_options[opt_index].name, "mac-cycles") == 0) {
     param->SetMacCycles(atoi(optarg));
   } else 
@@ -111,6 +120,13 @@ void CompilerParser::ParseLongOptions(int opt_index, char* exe_cmd,
   if (strcmp(c_options[opt_index].name, "pe-structure") == 0) {
     param->SetPeStructure(Matrix(optarg, strlen(optarg)));
   } else 
+  if (strcmp(c_options[opt_index].name, "mem-levels") == 0) {
+    RealMatrix mem_levels(optarg, strlen(optarg));
+    for (vector<double>& level : mem_levels)
+      for (size_t i = 0 ; i < 3 && i < level.size() ; i++)
+        level[i] *= 1024.0;
+    param->SetMemLevels(mem_levels);
+  } else 
   if (strcmp(c_options[opt_index].name, "code-path") == 0) {
     param->SetCodeFile(optarg);
   } else 
@@ -132,13 +148,71 @@ void CompilerParser::ParseLongOptions(int opt_index, char* exe_cmd,
   if (strcmp(c_options[opt_index].name, "layer") == 0) {
     param->SetLayerName(optarg);
   } else 
+  if (strcmp(c_options[opt_index].name, "search-mode") == 0) {
+    param->SetSearchMode(optarg);
+  } else 
+  if (strcmp(c_options[opt_index].name, "tile-enum") == 0) {
+    param->SetTileEnumeration(optarg);
+  } else 
+  if (strcmp(c_options[opt_index].name, "loop-order") == 0) {
+    param->SetLoopOrder(optarg);
+  } else 
+  if (strcmp(c_options[opt_index].name, "intra-loop-order") == 0) {
+    param->SetIntraLoopOrder(optarg);
+  } else 
+  if (strcmp(c_options[opt_index].name, "tile-traversal") == 0) {
+    param->SetTileTraversal(optarg);
+  } else 
+  if (strcmp(c_options[opt_index].name, "pareto-dump") == 0) {
+    param->SetParetoDumpFile(optarg);
+  } else 
+  if (strcmp(c_options[opt_index].name, "search-shard") == 0) {
+    param->SetSearchShard(optarg);
+  } else 
+  if (strcmp(c_options[opt_index].name, "shard-dump") == 0) {
+    param->SetShardDumpFile(optarg);
+  } else 
+  if (strcmp(c_options[opt_index].name, "shard-merge") == 0) {
+    param->SetShardMergeFile(optarg);
+  } else 
+  if (strcmp(c_options[opt_index].name, "schedule-cache") == 0) {
+    param->SetScheduleCacheFile(optarg);
+  } else 
+  if (strcmp(c_options[opt_index].name, "search-budget-ms") == 0) {
+    param->SetSearchBudget(atof(optarg));
+  } else 
+  if (strcmp(c_options[opt_index].name, "search-seed") == 0) {
+    param->SetSearchSeed(atol(optarg));
+  } else 
+  if (strcmp(c_options[opt_index].name, "search-evals") == 0) {
+    param->SetSearchEvaluations(atol(optarg));
+  } else 
+  if (strcmp(c_options[opt_index].name, "fuse") == 0) {
+    param->SetFusedLayers(optarg);
+  } else 
+  if (strcmp(c_options[opt_index].name, "sim-layout") == 0) {
+    param->SetSimLayout(optarg);
+  } else 
+  if (strcmp(c_options[opt_index].name, "timing-only") == 0) {
+    param->SetTimingOnly(true);
+  } else 
+  if (strcmp(c_options[opt_index].name, "native-sim") == 0) {
+    param->SetNativeSim(true);
+  } else 
+  if (strcmp(c_options[opt_index].name, "sim-openmp") == 0) {
+    param->SetSimOpenmp(true);
+  } else 
+  if (strcmp(c_options[opt_index].name, "sim-args-path") == 0) {
+    param->SetSimArgsFile(optarg);
+  } else 
   if (strcmp(c_options[opt_index].name, "help") == 0) {
     PrintHelp(exe_cmd);
     exit(EXIT_SUCCESS);
   } else {
     LOG(ERROR) << "Invalid argument: " << optarg;
   }
-  LOG(INFO) << "Parse --" << c_options[opt_index].name << " : " << optarg;
+  LOG(INFO) << "Parse --" << c_options[opt_index].name << " : "
+            << (optarg ? optarg : "");
 }
 
 void CompilerParser::CheckParameterValid(const CompilerParameter& param) const
@@ -155,6 +229,12 @@ void CompilerParser::CheckParameterValid(const CompilerParameter& param) const
   CHECK(kFilter_len  == param.GetKw() && kFilter_len == param.GetKh())
     << "KFilter_len is not valid: " << kFilter_len;
   CHECK(param.GetOc() > 0) << "Output channel is non-valid: " << param.GetOc();
+  CHECK(param.GetBatch() > 0) << "Batch size is non-valid: " 
+                              << param.GetBatch();
+  CHECK(param.GetGroups() > 0 && param.GetIc() % param.GetGroups() == 0 &&
+        param.GetOc() % param.GetGroups() == 0)
+    << "Groups do not divide input and output channels: "
+    << param.GetGroups();
   CHECK(param.GetMacCycles() > 0) << "MAC cycles is non-valid: " 
                                   << param.GetMacCycles();
   CHECK(param.GetFrequency() > 0) << "Frequency is non-valid: "
@@ -167,6 +247,12 @@ void CompilerParser::CheckParameterValid(const CompilerParameter& param) const
                                       << param.GetWeightMemSize();
   CHECK(param.GetOutputMemSize() > 0) << "Output memory size is non-valid: "
                                       << param.GetOutputMemSize();
+  for (const vector<double>& level : param.GetMemLevels()) {
+    CHECK(level.size() == 5 &&
+          *std::min_element(level.begin(), level.end()) > 0)
+      << "Memory level is non-valid: it needs positive input, weight and "
+      << "output sizes, bandwidth and energy";
+  }
   CHECK(strcmp(param.GetCodeFile(), "") != 0) << "Code file is empty.";
   CHECK(strcmp(param.GetGaiaFile(), "") != 0) << "Gaia IR file path is empty.";
   CHECK(strcmp(param.GetLatencyFile(), "") != 0) <<"Latency file is empty.";
@@ -175,6 +261,54 @@ void CompilerParser::CheckParameterValid(const CompilerParameter& param) const
   CHECK(strcmp(param.GetLoopSequenceDumpFile(), "")!=0)
     << "Loop sequence dump file is empty.";
   CHECK(strcmp(param.GetLayerName(), "") != 0) << "Layer name is empty.";
+  CHECK(strcmp(param.GetSearchMode(), "exhaustive") == 0 ||
+        strcmp(param.GetSearchMode(), "bnb") == 0 ||
+        strcmp(param.GetSearchMode(), "anneal") == 0 ||
+        strcmp(param.GetSearchMode(), "genetic") == 0)
+    << "Search mode is non-valid: " << param.GetSearchMode();
+  CHECK(strcmp(param.GetTileEnumeration(), "full") == 0 ||
+        strcmp(param.GetTileEnumeration(), "class") == 0)
+    << "Tile enumeration is non-valid: " << param.GetTileEnumeration();
+  CHECK(strcmp(param.GetLoopOrder(), "heuristic") == 0 ||
+        strcmp(param.GetLoopOrder(), "all") == 0)
+    << "Loop order search is non-valid: " << param.GetLoopOrder();
+  CHECK(strcmp(param.GetIntraLoopOrder(), "fixed") == 0 ||
+        strcmp(param.GetIntraLoopOrder(), "all") == 0)
+    << "Intra loop order search is non-valid: " << param.GetIntraLoopOrder();
+  CHECK(strcmp(param.GetTileTraversal(), "gray") == 0 ||
+        strcmp(param.GetTileTraversal(), "decode") == 0)
+    << "Tile traversal is non-valid: " << param.GetTileTraversal();
+  CHECK(strcmp(param.GetSimLayout(), "nchw") == 0 ||
+        strcmp(param.GetSimLayout(), "blocked") == 0)
+    << "Simulation layout is non-valid: " << param.GetSimLayout();
+  if (strcmp(param.GetSearchShard(), "") != 0) {
+    int shard_id, shard_cnt;
+    CHECK(sscanf(param.GetSearchShard(), "%d/%d", &shard_id, &shard_cnt) == 2
+          && shard_id >= 0 && shard_id < shard_cnt)
+      << "Search shard is non-valid: " << param.GetSearchShard();
+    CHECK(strcmp(param.GetShardDumpFile(), "") != 0)
+      << "Shard dump file is empty.";
+  }
+  CHECK(strcmp(param.GetSearchShard(), "") == 0 ||
+        strcmp(param.GetShardMergeFile(), "") == 0)
+    << "Searching and merging shards are exclusive.";
+  CHECK((strcmp(param.GetSearchShard(), "") == 0 &&
+         strcmp(param.GetShardMergeFile(), "") == 0) ||
+        strcmp(param.GetParetoDumpFile(), "") == 0)
+    << "Pareto frontier is not kept by shards.";
+  CHECK(param.GetSearchBudget() >= 0) << "Search budget is non-valid: "
+                                      << param.GetSearchBudget();
+  CHECK(param.GetSearchEvaluations() > 0)
+    << "Search evaluations are non-valid: " << param.GetSearchEvaluations();
+  CHECK(param.GetSearchBudget() == 0 ||
+        (strcmp(param.GetSearchShard(), "") == 0 &&
+         strcmp(param.GetParetoDumpFile(), "") == 0))
+    << "Budgeted search does not keep shards or Pareto frontier.";
+  CHECK(param.GetMemLevels().empty() ||
+        (strcmp(param.GetSearchShard(), "") == 0 &&
+         strcmp(param.GetShardMergeFile(), "") == 0 &&
+         strcmp(param.GetParetoDumpFile(), "") == 0))
+    << "Memory levels are not searched by shards or Pareto frontier.";
 }
 
 void CompilerParser::PrintHelp(char* exe_cmd) const
@@ -193,6 +327,8 @@ void CompilerParser::PrintHelp(char* exe_cmd) const
   << endl << "--kw=<integer>          Kernel width"
   << endl << "--kh=<integer>          Kernel height"
   << endl << "--oc=<integer>          Output channel"
+  << endl << "--batch=<integer>       Batch size (default: 1)"
+  << endl << "--groups=<integer>      Convolution groups (default: 1)"
   << endl << "--mac-cycles=<integer>  Parallelization loop hardware cycles"
   << endl << "--frequency=<float>     Hardware frequency"
   << endl << "--bandwidth=<float>     DRAM bandwidth"
@@ -201,6 +337,10 @@ void CompilerParser::PrintHelp(char* exe_cmd) const
   << endl << "--output-mem-size=<float> Output on-chip memory size (KB)"
   << endl << "--pe-dim=<2D array str>         Physical PE dimension (2D)"
   << endl << "--pe-structure=<2D array str>   PE calculation mapping (2D)"
+  << endl << "--mem-levels=<2D array str>     On-chip memory levels above PE-local"
+  << endl << "                        memory, outermost first. Each level is"
+  << endl << "                        [input KB, weight KB, output KB,"
+  << endl << "                        bandwidth, 32-bit access energy]"
   << endl << "--code-path=<path>      Generated code path"
   << endl << "--gaia-path=<path>      Generated Gaia IR path"
   << endl << "--latency-path=<path>   Latency file path"
@@ -208,5 +348,39 @@ void CompilerParser::PrintHelp(char* exe_cmd) const
   << endl << "--tiling-dump=<path>    Tiling factor dump file path"
   << endl << "--loop-seq-dump=<path>  Off-chip loop sequence dump file path"
   << endl << "--layer=<string>    CNN layer name"
+  << endl << "--search-mode=<string>  Tiling search mode (exhaustive, bnb,"
+  << endl << "                        anneal, genetic)"
+  << endl << "--tile-enum=<string>    Tile size enumeration (full, class)"
+  << endl << "--loop-order=<string>   Off-chip loop order search (heuristic, all)"
+  << endl << "--intra-loop-order=<string> Intra loop order search by on-chip"
+  << endl << "                        access energy (fixed, all)"
+  << endl << "--tile-traversal=<string> Tiling space order (gray, decode)"
+  << endl << "--pareto-dump=<path>    Pareto frontier CSV path. Each point is"
+  << endl << "                        dumped to <path>.<i>.tiling/.seq for -p"
+  << endl << "--search-shard=<i>/<n>  Search the i-th of n tiling space shards"
+  << endl << "                        and exit after --shard-dump"
+  << endl << "--shard-dump=<path>     Shard result file path"
+  << endl << "--shard-merge=<path>    Merge concatenated shard results instead"
+  << endl << "                        of searching"
+  << endl << "--schedule-cache=<path> Persistent schedule cache file shared by"
+  << endl << "                        compiler runs"
+  << endl << "--search-budget-ms=<float> Return the best tiling found within"
+  << endl << "                        the budget (msec). 0 for no limit"
+  << endl << "--search-seed=<integer> Random seed of anneal and genetic search"
+  << endl << "--search-evals=<integer> Evaluations of anneal and genetic search"
+  << endl << "--fuse=<string>         Layers fused after this layer, e.g."
+  << endl << "                        relu,pool:<k>:<s>:<p>,conv:<k>:<oc>:<s>:<p>"
+  << endl << "                        (relu, leaky, bn, pool, conv)"
+  << endl << "--sim-layout=<string>   Tensor layout of simulation code"
+  << endl << "                        (nchw, blocked)"
+  << endl << "--timing-only           Simulation code only models timing,"
+  << endl << "                        without test data and MAC computation"
+  << endl << "--native-sim            Simulate the schedule in the compiler and"
+  << endl << "                        write latency and timestamp files"
+  << endl << "--sim-openmp            Simulation code computes output channel"
+  << endl << "                        tiles in parallel with OpenMP"
+  << endl << "--sim-args-path=<path>  Tile constants and output paths become"
+  << endl << "                        arguments of the simulation binary,"
+  << endl << "                        written to <path>"
   << endl;
 }
\ No newline at end of file
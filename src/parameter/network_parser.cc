@@ -0,0 +1,162 @@
+#include "parameter/network_parser.h"
+
+#include <glog/logging.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+
+#include "general/data_type.h"
+
+using parameter::NetworkParser;
+
+using std::cout;
+using std::endl;
+
+NetworkParameter* NetworkParser::BuildParameter(int argc, char** argv)
+{
+  NetworkParameter* param = Parsing(argc, argv);
+  CheckParameterValid(*param);
+  LOG(INFO) << "Success to build network planner parameter.";
+  return param;
+}
+
+NetworkParameter* NetworkParser::Parsing(int argc, char** argv)
+{
+  NetworkParameter* param = new NetworkParameter();
+  int opt = 0;
+  int opt_index;
+  const char* short_opt = "hg";
+
+  opt = getopt_long(argc, argv, short_opt, n_options, &opt_index);
+  while (opt != -1) {
+    switch (opt) {
+      case 0: // parse long arguments
+        ParseLongOptions(opt_index, argv[0], param);
+        break;
+      case 'h':
+        LOG(INFO) << "Parse -h option";
+        PrintHelp(argv[0]);
+        exit(EXIT_SUCCESS);
+      case 'g':
+        LOG(INFO) << "Parse -g option";
+        FLAGS_logtostderr = true;
+        break;
+      default: break;
+    }
+    opt = getopt_long(argc, argv, short_opt, n_options, &opt_index);
+  }
+  return param;
+}
+
+void NetworkParser::ParseLongOptions(int opt_index, char* exe_cmd,
+                                     NetworkParameter* param)
+{
+  if (strcmp(n_options[opt_index].name, "mac-cycles") == 0) {
+    param->SetMacCycles(atoi(optarg));
+  } else 
+  if (strcmp(n_options[opt_index].name, "frequency") == 0) {
+    param->SetFrequency(atof(optarg));
+  } else 
+  if (strcmp(n_options[opt_index].name, "bandwidth") == 0) {
+    param->SetBandwidth(atof(optarg));
+  } else 
+  if (strcmp(n_options[opt_index].name, "mac-energy") == 0) {
+    param->SetMacEnergy(atof(optarg));
+  } else
+  if (strcmp(n_options[opt_index].name, "on-chip-32-energy") == 0) {
+    param->SetOnChip32Energy(atof(optarg));
+  } else 
+  if (strcmp(n_options[opt_index].name, "off-chip-32-energy") == 0) {
+    param->SetOffChip32Energy(atof(optarg));
+  } else 
+  if (strcmp(n_options[opt_index].name, "input-mem-size") == 0) {
+    param->SetInputMemSize(atof(optarg) * 1024.0);
+  } else 
+  if (strcmp(n_options[opt_index].name ,"weight-mem-size") == 0) {
+    param->SetWeightMemSize(atof(optarg) * 1024.0);
+  } else 
+  if (strcmp(n_options[opt_index].name, "output-mem-size") == 0) {
+    param->SetOutputMemSize(atof(optarg) * 1024.0);
+  } else 
+  if (strcmp(n_options[opt_index].name, "pe-dim") == 0) {
+    param->SetPeDim(Matrix(optarg, strlen(optarg)));
+  } else 
+  if (strcmp(n_options[opt_index].name, "pe-structure") == 0) {
+    param->SetPeStructure(Matrix(optarg, strlen(optarg)));
+  } else 
+  if (strcmp(n_options[opt_index].name, "network") == 0) {
+    param->SetNetworkFile(optarg);
+  } else 
+  if (strcmp(n_options[opt_index].name, "search-mode") == 0) {
+    param->SetSearchMode(optarg);
+  } else 
+  if (strcmp(n_options[opt_index].name, "objective") == 0) {
+    param->SetObjective(optarg);
+  } else 
+  if (strcmp(n_options[opt_index].name, "report-path") == 0) {
+    param->SetReportFile(optarg);
+  } else 
+  if (strcmp(n_options[opt_index].name, "help") == 0) {
+    PrintHelp(exe_cmd);
+    exit(EXIT_SUCCESS);
+  }
+}
+
+void NetworkParser::CheckParameterValid(const NetworkParameter& param) const
+{
+  CHECK(param.GetMacCycles() > 0) << "MAC cycles is non-valid: " 
+                                  << param.GetMacCycles();
+  CHECK(param.GetFrequency() > 0) << "Frequency is non-valid: "
+                                  << param.GetFrequency();
+  CHECK(param.GetBandwidth() > 0) << "Bandwidth is non-valid: "
+                                  << param.GetBandwidth();
+  CHECK(param.GetMacEnergy() > 0) << "MAC energy is non-valid: "
+                                  << param.GetMacEnergy();
+  CHECK(param.GetOnChip32Energy() > 0)  << "On-chip energy is non-valid: "
+                                        << param.GetOnChip32Energy();
+  CHECK(param.GetOffChip32Energy() > 0) << "Off-chip energy is non-valid: "
+                                        << param.GetOffChip32Energy();
+  CHECK(param.GetInputMemSize() > 0)  << "Input memory size is non-valid: "
+                                      << param.GetInputMemSize();
+  CHECK(param.GetWeightMemSize() > 0) << "Weight memory size is non-valid: "
+                                      << param.GetWeightMemSize();
+  CHECK(param.GetOutputMemSize() > 0) << "Output memory size is non-valid: "
+                                      << param.GetOutputMemSize();
+  CHECK(strcmp(param.GetNetworkFile(), "") != 0) << "Network file is empty.";
+  CHECK(strcmp(param.GetSearchMode(), "exhaustive") == 0 ||
+        strcmp(param.GetSearchMode(), "bnb") == 0)
+    << "Search mode is non-valid: " << param.GetSearchMode();
+  CHECK(strcmp(param.GetObjective(), "latency") == 0 ||
+        strcmp(param.GetObjective(), "energy") == 0)
+    << "Objective is non-valid: " << param.GetObjective();
+  CHECK(strcmp(param.GetReportFile(), "") != 0) << "Report file is empty.";
+}
+
+void NetworkParser::PrintHelp(char* exe_cmd) const
+{  
+  cout    << "e-PlaNNer Network Planner."
+  << endl << "Usage: " << exe_cmd << " <options>"
+  << endl << "where <options> are"
+  << endl << "-g                      Debug mode. Show all logs. (not stable)"
+  << endl << "-h / --help             Show this help screen."
+  << endl << "--mac-cycles=<integer>  Parallelization loop hardware cycles"
+  << endl << "--frequency=<float>     Hardware frequency"
+  << endl << "--bandwidth=<float>     DRAM bandwidth"
+  << endl << "--mac-energy=<float>    32-bit MAC computation energy (nJ)"
+  << endl << "--on-chip-32-energy=<float>   32-bit data access to on-chip memory (nJ)"
+  << endl << "--off-chip-32-energy=<float>  32-bit data access to off-chip memory (nJ)"
+  << endl << "--input-mem-size=<float>  Input on-chip memory size (KB)"
+  << endl << "--weight-mem-size=<float> Weight on-chip memory size (KB)"
+  << endl << "--output-mem-size=<float> Output on-chip memory size (KB)"
+  << endl << "--pe-dim=<2D array str>         Physical PE dimension (2D)"
+  << endl << "--pe-structure=<2D array str>   PE calculation mapping (2D)"
+  << endl << "--network=<path>        Network file. The first line is"
+  << endl << "                        input:<n>:<c>:<h>:<w> and each next line"
+  << endl << "                        is a layer (relu, leaky, bn,"
+  << endl << "                        pool:<k>:<s>:<p>, conv:<k>:<oc>:<s>:<p>)"
+  << endl << "--search-mode=<string>  Tiling search mode of each layer"
+  << endl << "                        (exhaustive, bnb)"
+  << endl << "--objective=<string>    Network objective (latency, energy)"
+  << endl << "--report-path=<path>    CSV report file path"
+  << endl; 
+}
@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <iostream>
+#include <algorithm>
 
 #include "general/utils.h"
 #include "general/data_type.h"
@@ -12,6 +13,7 @@ using parameter::ProfilerParser;
 
 using std::cout;
 using std::endl;
+using std::vector;
 
 ProfilerParameter* ProfilerParser::BuildParameter(int argc, char** argv)
 {
@@ -87,6 +89,12 @@ void ProfilerParser::ParseLongOptions(int opt_index, char* exe_cmd,
   if (strcmp(p_options[opt_index].name, "oc") == 0) {
     param->SetOc(atoi(optarg));
   } else 
+  if (strcmp(p_options[opt_index].name, "batch") == 0) {
+    param->SetBatch(atoi(optarg));
+  } else 
+  if (strcmp(p_options[opt_index].name, "groups") == 0) {
+    param->SetGroups(atoi(optarg));
+  } else 
   if (strcmp(p_options[opt_index].name, "mac-cycles") == 0) {
     param->SetMacCycles(atoi(optarg));
   } else 
@@ -120,6 +128,13 @@ void ProfilerParser::ParseLongOptions(int opt_index, char* exe_cmd,
   if (strcmp(p_options[opt_index].name, "pe-structure") == 0) {
     param->SetPeStructure(Matrix(optarg, strlen(optarg)));
   } else 
+  if (strcmp(p_options[opt_index].name, "mem-levels") == 0) {
+    RealMatrix mem_levels(optarg, strlen(optarg));
+    for (vector<double>& level : mem_levels)
+      for (size_t i = 0 ; i < 3 && i < level.size() ; i++)
+        level[i] *= 1024.0;
+    param->SetMemLevels(mem_levels);
+  } else 
   if (strcmp(p_options[opt_index].name, "latency-path") == 0) {
     param->SetLatencyFile(optarg);
   } else 
@@ -155,6 +170,12 @@ void ProfilerParser::CheckParameterValid(const ProfilerParameter& param) const
   CHECK(kFilter_len  == param.GetKw() && kFilter_len == param.GetKh())
     << "KFilter_len is not valid: " << kFilter_len;
   CHECK(param.GetOc() > 0) << "Output channel is non-valid: " << param.GetOc();
+  CHECK(param.GetBatch() > 0) << "Batch size is non-valid: " 
+                              << param.GetBatch();
+  CHECK(param.GetGroups() > 0 && param.GetIc() % param.GetGroups() == 0 &&
+        param.GetOc() % param.GetGroups() == 0)
+    << "Groups do not divide input and output channels: "
+    << param.GetGroups();
   CHECK(param.GetMacCycles() > 0) << "MAC cycles is non-valid: " 
                                   << param.GetMacCycles();
   CHECK(param.GetFrequency() > 0) << "Frequency is non-valid: "
@@ -173,6 +194,12 @@ void ProfilerParser::CheckParameterValid(const ProfilerParameter& param) const
                                       << param.GetWeightMemSize();
   CHECK(param.GetOutputMemSize() > 0) << "Output memory size is non-valid: "
                                       << param.GetOutputMemSize();
+  for (const vector<double>& level : param.GetMemLevels()) {
+    CHECK(level.size() == 5 &&
+          *std::min_element(level.begin(), level.end()) > 0)
+      << "Memory level is non-valid: it needs positive input, weight and "
+      << "output sizes, bandwidth and energy";
+  }
   CHECK(strcmp(param.GetLatencyFile(), "") != 0) <<"Latency file is empty.";
   CHECK(strcmp(param.GetTilingDumpFile(), "")!=0)<<"Tiling dump file is empty.";
   CHECK(strcmp(param.GetLoopSequenceDumpFile(), "")!=0)
@@ -197,6 +224,8 @@ void ProfilerParser::PrintHelp(char* exe_cmd) const
   << endl << "--kw=<integer>          Kernel width"
   << endl << "--kh=<integer>          Kernel height"
   << endl << "--oc=<integer>          Output channel"
+  << endl << "--batch=<integer>       Batch size (default: 1)"
+  << endl << "--groups=<integer>      Convolution groups (default: 1)"
   << endl << "--mac-cycles=<integer>  Parallelization loop hardware cycles"
   << endl << "--frequency=<float>     Hardware frequency"
   << endl << "--bandwidth=<float>     DRAM bandwidth"
@@ -208,6 +237,10 @@ void ProfilerParser::PrintHelp(char* exe_cmd) const
   << endl << "--output-mem-size=<float> Output on-chip memory size (KB)"
   << endl << "--pe-dim=<2D array str>         Physical PE dimension (2D)"
   << endl << "--pe-structure=<2D array str>   PE calculation mapping (2D)"
+  << endl << "--mem-levels=<2D array str>     On-chip memory levels above PE-local"
+  << endl << "                        memory, outermost first. Each level is"
+  << endl << "                        [input KB, weight KB, output KB,"
+  << endl << "                        bandwidth, 32-bit access energy]"
   << endl << "--latency-path=<path>   Latency file path"
   << endl << "--tiling-dump=<path>    Tiling factor dump file path"
   << endl << "--loop-seq-dump=<path>  Off-chip loop sequence dump file path"
@@ -15,6 +15,7 @@ using std::cout;
 using std::endl;
 using std::unique_ptr;
 using std::ifstream;
+using std::vector;
 
 using parameter::ProfilerParser;
 using arch::Architecture;
@@ -52,14 +53,35 @@ int main(int argc, char** argv)
   ifstream strt_dump(param->GetLoopSequenceDumpFile());
   varset_dump >> on_loop >> parl_loop;
   strt_dump >> *off_strt >> *on_strt;
+  vector<Variables> level_vars(arch->GetMemLevels().size());
+  vector<Structure> level_strts(arch->GetMemLevels().size());
+  for (size_t l = 0 ; l < level_vars.size() ; l++)
+    varset_dump >> level_vars[l];
+  for (size_t l = 0 ; l < level_strts.size() ; l++) {
+    strt_dump >> level_strts[l];
+    level_strts[l].TagStationary(
+      (l == 0) ? loop->GetVariableSet().GetOffLoopVariables() :
+                 level_vars[l-1],
+      level_vars[l]);
+  }
   VariableSet* varset = new VariableSet(loop->GetVariableSet());
   varset->SetOnLoopVariables(on_loop);
   varset->SetParlLoopVariables(parl_loop);
+  varset->SetLevelLoopVariables(level_vars);
+  // Shares of PE arrays follow the memory levels in the tiling dump.
+  if (arch->GetPeDim().size() > 1) {
+    vector<Variables> array_vars(arch->GetPeDim().size());
+    vector<Variables> array_parl_vars(arch->GetPeDim().size());
+    for (size_t a = 0 ; a < array_vars.size() ; a++)
+      varset_dump >> array_vars[a] >> array_parl_vars[a];
+    varset->SetArrayLoopVariables(array_vars, array_parl_vars);
+  }
   off_strt->TagStationary(varset->GetOffLoopVariables(), 
                           varset->GetOnLoopVariables());
   loop->SetVariableSet(varset);
   loop->SetOffStructure(off_strt);
   loop->SetOnStructure(on_strt);
+  loop->SetLevelStructures(level_strts);
   varset_dump.close();
   strt_dump.close();
   /* #region Logging */
@@ -72,6 +94,7 @@ int main(int argc, char** argv)
   LOG(INFO) << "  TOW: " << loop->GetVariableSet().GetTow();
   LOG(INFO) << "  TOH: " << loop->GetVariableSet().GetToh();
   LOG(INFO) << "  TOC: " << loop->GetVariableSet().GetToc();
+  LOG(INFO) << "  TN: "  << loop->GetVariableSet().GetTn();
   /* #endregion */
   cout << "[Back-end][Profiler] Analyzing..." << endl;
   unique_ptr<AnalysisReport> report(new AnalysisReport());
@@ -79,6 +102,12 @@ int main(int argc, char** argv)
                       loop->GetOffStructure(),
                       loop->GetOnStructure(),
                       *arch);
+  if (!arch->GetMemLevels().empty()) {
+    report->AnalyzeMemoryLevels(loop->GetVariableSet(),
+                                loop->GetLevelStructures(),
+                                loop->GetOffStructure(),
+                                *arch);
+  }
   long int latency;
   ifstream latency_file(param->GetLatencyFile());
   latency_file >> latency;
@@ -124,6 +153,10 @@ int main(int argc, char** argv)
   cout  << "---------------------------------------------------------" <<endl;
   report->PrintEnergyAnalysisReport(cout);
   cout  << "---------------------------------------------------------" <<endl;
+  if (!arch->GetMemLevels().empty()) {
+    report->PrintMemoryLevelAnalysisReport(cout);
+    cout<< "---------------------------------------------------------" <<endl;
+  }
 
   cout  << "[Back-end][Profiler] Dump report file to " << param->GetReportFile()
         << endl;
@@ -4,13 +4,16 @@
 #include <iostream>
 
 #include "general/data_type.h"
+#include "general/utils.h"
 
 using codegen::simulation::SimulationCodeGenerator;
 
 using std::endl;
+using std::max;
 
 using codegen::simulation::InstructionSlot;
 using loop::Location;
+using loop::Variables;
 
 void SimulationCodeGenerator::GenCode(const CnnLoop& loop, 
                                       const Architecture& arch)
@@ -20,44 +23,79 @@ void SimulationCodeGenerator::GenCode(const CnnLoop& loop,
   const Structure&   on_strt  = loop.GetOnStructure();
 
   ofstream code(code_path_);
+  arg_values_.clear();
+  arg_inits_.clear();
+  pe_array_cnt_ = max((size_t)1, varset.GetArrayLoopVariables().size());
+  split_oc_ = IsArraySplitOc(varset);
 
   GenPreProcess(code, arch);
   //GenFunctionPrototype(sim_file);
-  GenGlobalVariables(code, varset, arch.GetMacCycles());
+  GenGlobalVariables(code, varset, GetInputLoadGroups(varset, off_strt),
+                     arch.GetMacCycles());
+  if (!timing_only_) GenDataLayout(code);
+  if (IsRuntimeArgs()) GenArgumentsInit(code);
   GenFunctionDefine(code, off_strt);
 
-  code  << R"(int main(void))" << endl
-        << "{" << endl;
+  if (IsRuntimeArgs()) {
+    code  << R"(int main(int argc, char** argv))" << endl
+          << "{" << endl
+          << "\t" << R"(init_arguments(argc, argv);)" << endl
+          << endl;
+  } else {
+    code  << R"(int main(void))" << endl
+          << "{" << endl;
+  }
 
-  GenSampleDataDeclare(code);
+  if (!timing_only_) GenSampleDataDeclare(code);
   GenTsStreamOpen(code);
 
-  code  << "\t" << R"(srand(time(NULL));)" << endl
-        << endl;
+  if (!timing_only_) {
+    code  << "\t" << R"(srand(time(NULL));)" << endl
+          << endl;
 
-  GenSampleDataInitialization(code);
-  GenCalculateBaseline(code);
+    GenSampleDataInitialization(code);
+    GenCalculateBaseline(code);
+    if (parallel_compute_) GenParallelCompute(code, off_strt, on_strt);
+  }
 
   GenLocalVariables(code, off_strt);
 
   GenInterLoop(code, off_strt);
   code
-    << "\t\t\t\t\t\t\t" << R"(IsNotFirstIteration = true;)" << endl
+    << "\t\t\t\t\t\t\t\t" << R"(IsNotFirstIteration = true;)" << endl
     << endl;
-  GenIntraLoop(code, on_strt); code << endl;
-  GenUnrollLoop(code);
-  GenIntraLoopClose(code);
+  if (timing_only_ || parallel_compute_) {
+    GenTileExecution(code);
+  } else {
+    GenIntraLoop(code, on_strt); code << endl;
+    GenUnrollLoop(code);
+    GenIntraLoopClose(code);
+  }
   GenInterLoopClose(code, off_strt);
   GenTsStreamClose(code);
 
-  GenResultCheck(code);
+  if (!timing_only_) GenResultCheck(code);
   GenLatencyValueWrite(code);
-  GenDelete(code);
+  if (!timing_only_) GenDelete(code);
   code
     << R"(})" << endl
     << endl;
   // GenFunctionDefine(sim_file, inter_loop_structure);
   code.close();
+  if (IsRuntimeArgs()) WriteArgsFile();
+}
+
+void SimulationCodeGenerator::SetDataLayout(const char* layout)
+{
+  if      (strcmp(layout, S_NCHW_LAYOUT) == 0)
+    layout_ = DataLayout::NCHW_LAYOUT;
+  else if (strcmp(layout, S_BLOCKED_LAYOUT) == 0)
+    layout_ = DataLayout::BLOCKED_LAYOUT;
+  else
+    LOG(FATAL) << "Invalid data layout: " << layout;
+  /* #region Logging */
+  LOG(INFO) << "Data layout is set as " << layout;
+  /* #endregion */
 }
 
 void SimulationCodeGenerator::GenPreProcess(ofstream& code, 
@@ -73,6 +111,7 @@ void SimulationCodeGenerator::GenPreProcess(ofstream& code,
     << R"(#include <ctime>)" << endl
     << R"(#include <cmath>)" << endl
     << R"(#include <cassert>)" << endl
+    << R"(#include <cstring>)" << endl
     << endl;
   if (sizeof(DataType) == 1) {
     /* #region Logging */
@@ -104,7 +143,12 @@ void SimulationCodeGenerator::GenPreProcess(ofstream& code,
     << endl
     << R"(#define BANDWIDTH)" << "\t" << arch.GetBandwidth() << endl
     << R"(#define FREQUENCY)" << "\t" << arch.GetFrequency() << endl
-    << R"(#define TS_STREAM ")" << ts_file_path_ << R"(")" << endl
+    << R"(#define ALIGNMENT)" << "\t" << 64 << endl;
+  if (!IsRuntimeArgs()) {
+    code
+      << R"(#define TS_STREAM ")" << ts_file_path_ << R"(")" << endl;
+  }
+  code
     << endl
     << R"(using std::cout;)" << endl
     << R"(using std::endl;)" << endl
@@ -137,61 +181,215 @@ void SimulationCodeGenerator::GenFunctionDefine(ofstream& code,
   GenWeightLoadFunctionDefine( code, off_strt);
   GenOutputStoreFunctionDefine(code, off_strt);
   GenExecuteFunctionDefine(code);
+  if (IsArraySplit()) GenTileCyclesFunctionDefine(code);
 }
 
 void SimulationCodeGenerator::GenGlobalVariables( ofstream& code, 
                                                   const VariableSet& varset, 
+                                                  int load_groups,
                                                   int mac_cycles)
 {
   /* #region Logging */
   LOG(INFO) << "Generate global variables." << endl;
   /* #endregion */
+  GenArgument(code, "S", varset.GetStride());
+  code << endl;
+  GenArgument(code, "Iw", varset.GetIw() + 2*varset.GetPw());
+  GenArgument(code, "Ih", varset.GetIh() + 2*varset.GetPh());
+  GenArgument(code, "Ic", varset.GetIc());
+  GenArgument(code, "Kw", varset.GetKw());
+  GenArgument(code, "Kh", varset.GetKh());
+  GenArgument(code, "Ow", varset.GetOw());
+  GenArgument(code, "Oh", varset.GetOh());
+  GenArgument(code, "Oc", varset.GetOc());
+  GenArgument(code, "N",  varset.GetN());
+  GenArgument(code, "G",  varset.GetGroups());
+  GenDerived(code, "int", "Goc", "Oc / G");
+  code << endl;
+  GenArgument(code, "Tiw", varset.GetTiw()+2*varset.GetPw());
+  GenArgument(code, "Tih", varset.GetTih()+2*varset.GetPh());
+  GenArgument(code, "Tic", varset.GetTic());
+  GenArgument(code, "Tkw", varset.GetTkw());
+  GenArgument(code, "Tkh", varset.GetTkh());
+  GenArgument(code, "Tow", varset.GetTow());
+  GenArgument(code, "Toh", varset.GetToh());
+  GenArgument(code, "Toc", varset.GetToc());
+  GenArgument(code, "Tn",  varset.GetTn());
+  GenArgument(code, "Tg",  load_groups);
+  code << endl;
+  GenArgument(code, "Piw", varset.GetPiw()+2*varset.GetPw());
+  GenArgument(code, "Pih", varset.GetPih()+2*varset.GetPh());
+  GenArgument(code, "Pic", varset.GetPic());
+  GenArgument(code, "Pkw", varset.GetPkw());
+  GenArgument(code, "Pkh", varset.GetPkh());
+  GenArgument(code, "Pow", varset.GetPow());
+  GenArgument(code, "Poh", varset.GetPoh());
+  GenArgument(code, "Poc", varset.GetPoc());
+  GenArgument(code, "Pn",  varset.GetPn());
+  code << endl;
+  if (IsArraySplit()) GenArrayVariables(code, varset);
+  GenArgument(code, "MacCycles", mac_cycles);
   code
-    << R"(const int S = )" << varset.GetStride() << ";" << endl
-    << endl
-    << R"(const int Iw = )" << varset.GetIw() + 2*varset.GetPw() << ";" << endl
-    << R"(const int Ih = )" << varset.GetIh() + 2*varset.GetPh() << ";" << endl
-    << R"(const int Ic = )" << varset.GetIc() << ";" << endl
-    << R"(const int Kw = )" << varset.GetKw() << ";" << endl
-    << R"(const int Kh = )" << varset.GetKh() << ";" << endl
-    << R"(const int Ow = )" << varset.GetOw() << ";" << endl
-    << R"(const int Oh = )" << varset.GetOh() << ";" << endl
-    << R"(const int Oc = )" << varset.GetOc() << ";" << endl
-    << endl
-    << R"(const int Tiw = )" << varset.GetTiw()+2*varset.GetPw() << ";" << endl
-    << R"(const int Tih = )" << varset.GetTih()+2*varset.GetPh() << ";" << endl
-    << R"(const int Tic = )" << varset.GetTic() << ";" << endl
-    << R"(const int Tkw = )" << varset.GetTkw() << ";" << endl
-    << R"(const int Tkh = )" << varset.GetTkh() << ";" << endl
-    << R"(const int Tow = )" << varset.GetTow() << ";" << endl
-    << R"(const int Toh = )" << varset.GetToh() << ";" << endl
-    << R"(const int Toc = )" << varset.GetToc() << ";" << endl
-    << endl
-    << R"(const int Piw = )" << varset.GetPiw()+2*varset.GetPw() << ";" << endl
-    << R"(const int Pih = )" << varset.GetPih()+2*varset.GetPh() << ";" << endl
-    << R"(const int Pic = )" << varset.GetPic() << ";" << endl
-    << R"(const int Pkw = )" << varset.GetPkw() << ";" << endl
-    << R"(const int Pkh = )" << varset.GetPkh() << ";" << endl
-    << R"(const int Pow = )" << varset.GetPow() << ";" << endl
-    << R"(const int Poh = )" << varset.GetPoh() << ";" << endl
-    << R"(const int Poc = )" << varset.GetPoc() << ";" << endl
-    << endl
-    << R"(const int MacCycles = )" << mac_cycles << ";" << endl
     << endl
     << R"(bool store_flag = false;)" << endl
     << endl;
 }
 
+void SimulationCodeGenerator::GenArrayVariables( ofstream& code,
+                                                  const VariableSet& varset)
+{
+  /* #region Logging */
+  LOG(INFO) << "Generate PE array variables." << endl;
+  /* #endregion */
+  const vector<Variables>& array_vars = varset.GetArrayLoopVariables();
+  const vector<Variables>& array_parl_vars = varset.GetArrayParlLoopVariables();
+  for (size_t a = 0 ; a < pe_array_cnt_ ; a++) {
+    const Variables& share = array_vars[a];
+    const Variables& parl = array_parl_vars[a];
+    string id = std::to_string(a);
+    GenArgument(code, ("Share" + id).c_str(),
+                split_oc_ ? share.GetOc() : share.GetOh());
+    // An idle array has no unrolling along the split, and its cycles are
+    // never computed. 1 keeps the emitted division defined.
+    GenArgument(code, ("Pic" + id).c_str(), parl.GetIc());
+    GenArgument(code, ("Pkw" + id).c_str(), parl.GetKw());
+    GenArgument(code, ("Pkh" + id).c_str(), parl.GetKh());
+    GenArgument(code, ("Pow" + id).c_str(), parl.GetOw());
+    GenArgument(code, ("Poh" + id).c_str(), max(1, parl.GetOh()));
+    GenArgument(code, ("Poc" + id).c_str(), max(1, parl.GetOc()));
+    GenArgument(code, ("Pn"  + id).c_str(), parl.GetN());
+    code << endl;
+  }
+}
+
+void SimulationCodeGenerator::GenArgument(ofstream& code, const char* name,
+                                          long int value)
+{
+  if (!IsRuntimeArgs()) {
+    code << "const int " << name << " = " << value << ";" << endl;
+    return;
+  }
+  // Paths of timestamp and latency files take argv[1] and argv[2].
+  code << "int " << name << ";" << endl;
+  arg_inits_.push_back(string(name) + " = atoi(argv["
+                       + std::to_string(arg_values_.size() + 3) + "]);");
+  arg_values_.push_back(std::to_string(value));
+}
+
+void SimulationCodeGenerator::GenDerived( ofstream& code, const char* type,
+                                          const char* name, const char* expr)
+{
+  if (!IsRuntimeArgs()) {
+    code << "const " << type << " " << name << " = " << expr << ";" << endl;
+    return;
+  }
+  code << type << " " << name << ";" << endl;
+  arg_inits_.push_back(string(name) + " = " + expr + ";");
+}
+
+void SimulationCodeGenerator::GenArgumentsInit(ofstream& code)
+{
+  /* #region Logging */
+  LOG(INFO) << "Generate runtime arguments initialization." << endl;
+  /* #endregion */
+  code
+    << R"(void init_arguments(int argc, char** argv))" << endl
+    << R"({)" << endl
+    << "\t" << R"(assert(argc == )" << arg_values_.size() + 3 << ");" << endl;
+  for (const string& init : arg_inits_) code << "\t" << init << endl;
+  code
+    << R"(})" << endl
+    << endl;
+}
+
+void SimulationCodeGenerator::WriteArgsFile(void)
+{
+  /* #region Logging */
+  LOG(INFO) << "Write simulation arguments: " << args_file_path_ << endl;
+  /* #endregion */
+  // One argument per line, in argv order.
+  ofstream args_file(args_file_path_);
+  args_file << ts_file_path_ << endl << latency_file_path_ << endl;
+  for (const string& value : arg_values_) args_file << value << endl;
+  args_file.close();
+}
+
+void SimulationCodeGenerator::GenDataLayout(ofstream& code)
+{
+  /* #region Logging */
+  LOG(INFO) << "Generate data layout." << endl;
+  /* #endregion */
+  if (layout_ == DataLayout::NCHW_LAYOUT) {
+    GenDerived(code, "long int", "InputSize", "(long int)N * G*Ic * Ih * Iw");
+    GenDerived(code, "long int", "WeightSize", "(long int)Oc * Ic * Kh * Kw");
+    GenDerived(code, "long int", "OutputSize", "(long int)N * Oc * Oh * Ow");
+    code
+      << endl
+      << R"(inline long int input_index(int n, int c, int h, int w))" << endl
+      << R"({)" << endl
+      << "\t" << R"(return (((long int)n * G*Ic + c) * Ih + h) * Iw + w;)" << endl
+      << R"(})" << endl
+      << endl
+      << R"(inline long int weight_index(int oc, int ic, int kh, int kw))" << endl
+      << R"({)" << endl
+      << "\t" << R"(return (((long int)oc * Ic + ic) * Kh + kh) * Kw + kw;)" << endl
+      << R"(})" << endl
+      << endl
+      << R"(inline long int output_index(int n, int c, int h, int w))" << endl
+      << R"({)" << endl
+      << "\t" << R"(return (((long int)n * Oc + c) * Oh + h) * Ow + w;)" << endl
+      << R"(})" << endl
+      << endl;
+  } else {
+    // Channels of a block are innermost, padded up to a whole block.
+    GenDerived(code, "int", "Bi", "Pic");
+    GenDerived(code, "int", "Bo", "Poc");
+    GenDerived(code, "int", "Ib", "(G*Ic + Bi - 1) / Bi");
+    GenDerived(code, "int", "Ob", "(Oc + Bo - 1) / Bo");
+    code << endl;
+    GenDerived(code, "long int", "InputSize", "(long int)N * Ib * Ih * Iw * Bi");
+    GenDerived(code, "long int", "WeightSize", "(long int)Ob * Ic * Kh * Kw * Bo");
+    GenDerived(code, "long int", "OutputSize", "(long int)N * Ob * Oh * Ow * Bo");
+    code
+      << endl
+      << R"(inline long int input_index(int n, int c, int h, int w))" << endl
+      << R"({)" << endl
+      << "\t" << R"(return ((((long int)n * Ib + c/Bi) * Ih + h) * Iw + w) * Bi + c%Bi;)" << endl
+      << R"(})" << endl
+      << endl
+      << R"(inline long int weight_index(int oc, int ic, int kh, int kw))" << endl
+      << R"({)" << endl
+      << "\t" << R"(return ((((long int)(oc/Bo) * Ic + ic) * Kh + kh) * Kw + kw) * Bo + oc%Bo;)" << endl
+      << R"(})" << endl
+      << endl
+      << R"(inline long int output_index(int n, int c, int h, int w))" << endl
+      << R"({)" << endl
+      << "\t" << R"(return ((((long int)n * Ob + c/Bo) * Oh + h) * Ow + w) * Bo + c%Bo;)" << endl
+      << R"(})" << endl
+      << endl;
+  }
+  code
+    << R"(DataType* alloc_data(long int size))" << endl
+    << R"({)" << endl
+    << "\t" << R"(size_t bytes = (size * sizeof(DataType) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;)" << endl
+    << "\t" << R"(DataType* data = (DataType*)aligned_alloc(ALIGNMENT, bytes);)" << endl
+    << "\t" << R"(assert(data != NULL);)" << endl
+    << "\t" << R"(memset(data, 0, bytes);)" << endl
+    << "\t" << R"(return data;)" << endl
+    << R"(})" << endl
+    << endl;
+}
+
 void SimulationCodeGenerator::GenSampleDataDeclare(ofstream& code)
 {
   /* #region Logging */
   LOG(INFO) << "Generate test dataset." << endl;
   /* #endregion */
   code 
-    << "\t" << R"(DataType*** input = new DataType**[Ic];)" << endl
-    << "\t" << R"(DataType**** weight = new DataType***[Oc];)" << endl
-    << "\t" << R"(DataType*** output = new DataType**[Oc];)" << endl
-    << "\t" << R"(DataType*** baseline = new DataType**[Oc];)" << endl
+    << "\t" << R"(DataType* input = alloc_data(InputSize);)" << endl
+    << "\t" << R"(DataType* weight = alloc_data(WeightSize);)" << endl
+    << "\t" << R"(DataType* output = alloc_data(OutputSize);)" << endl
+    << "\t" << R"(DataType* baseline = alloc_data(OutputSize);)" << endl
     << endl;
 }
 
@@ -201,7 +399,8 @@ void SimulationCodeGenerator::GenTsStreamOpen(ofstream& code)
   LOG(INFO) << "Generate timestamp JSON file: " << ts_file_path_ << endl;
   /* #endregion */
   code
-    << "\t" << R"(ofstream ts_stream(TS_STREAM);)" << endl
+    << "\t" << (IsRuntimeArgs() ? R"(ofstream ts_stream(argv[1]);)"
+                                 : R"(ofstream ts_stream(TS_STREAM);)") << endl
     << "\t" << R"(ts_stream << "[" << endl;)" << endl;
 }
 
@@ -210,42 +409,27 @@ void SimulationCodeGenerator::GenSampleDataInitialization(ofstream& code)
   /* #region Logging */
   LOG(INFO) << "Generate test dataset initializing code." << endl;
   /* #endregion */
+  // Output and baseline are zeroed by alloc_data.
   code 
-    << "\t" << R"(for ( int ic = 0 ; ic < Ic ; ic++ ) {)" << endl
-    << "\t\t" << R"(input[ic] = new DataType*[Ih];)" << endl
-    << "\t\t" << R"(for ( int ih = 0 ; ih < Ih ; ih++ ) {)" << endl
-    << "\t\t\t" << R"(input[ic][ih] = new DataType[Iw];)" << endl
-    << "\t\t\t" << R"(for ( int iw = 0 ; iw < Iw ; iw++ ) {)" << endl
-    << "\t\t\t\t" << R"(input[ic][ih][iw] = (DataType)rand() % MAX_RAND_DATA;)" << endl
+    << "\t" << R"(for ( int n = 0 ; n < N ; n++ ) {)" << endl
+    << "\t\t" << R"(for ( int ic = 0 ; ic < G*Ic ; ic++ ) {)" << endl
+    << "\t\t\t" << R"(for ( int ih = 0 ; ih < Ih ; ih++ ) {)" << endl
+    << "\t\t\t\t" << R"(for ( int iw = 0 ; iw < Iw ; iw++ ) {)" << endl
+    << "\t\t\t\t\t" << R"(input[input_index(n, ic, ih, iw)] = (DataType)rand() % MAX_RAND_DATA;)" << endl
+    << "\t\t\t\t" << "}" << endl
     << "\t\t\t" << "}" << endl
     << "\t\t" << "}" << endl
     << "\t" << "}" << endl
     << endl
     << "\t" << R"(for ( int oc = 0 ; oc < Oc ; oc++ ) {)" << endl
-    << "\t\t" << R"(weight[oc] = new DataType**[Ic];)" << endl
     << "\t\t" << R"(for ( int ic = 0 ; ic < Ic ; ic++ ) {)" << endl
-    << "\t\t\t" << R"(weight[oc][ic] = new DataType*[Kh];)" << endl
     << "\t\t\t" << R"(for ( int kh = 0 ; kh < Kh ; kh++ ) {)" << endl
-    << "\t\t\t\t" << R"(weight[oc][ic][kh] = new DataType[Kw];)" << endl
     << "\t\t\t\t" << R"(for ( int kw = 0 ; kw < Kw ; kw++ ) {)" << endl
-    << "\t\t\t\t\t" << R"(weight[oc][ic][kh][kw] = (DataType)rand() % MAX_RAND_DATA;)" << endl
+    << "\t\t\t\t\t" << R"(weight[weight_index(oc, ic, kh, kw)] = (DataType)rand() % MAX_RAND_DATA;)" << endl
     << "\t\t\t\t" << "}" << endl
     << "\t\t\t" << "}" << endl
     << "\t\t" << "}" << endl
     << "\t" << "}" << endl
-    << endl
-    << "\t" << R"(for ( int oc = 0 ; oc < Oc ; oc++ ) {)" << endl
-    << "\t\t" << R"(output[oc] = new DataType*[Oh];)" << endl
-    << "\t\t" << R"(baseline[oc] = new DataType*[Oh];)" << endl
-    << "\t\t" << R"(for ( int oh = 0 ; oh < Oh ; oh++ ) {)" << endl
-    << "\t\t\t" << R"(output[oc][oh] = new DataType[Ow];)" << endl
-    << "\t\t\t" << R"(baseline[oc][oh] = new DataType[Ow];)" << endl
-    << "\t\t\t" << R"(for ( int ow = 0 ; ow < Ow ; ow++ ) {)" << endl
-    << "\t\t\t\t" << R"(output[oc][oh][ow] = 0;)" << endl
-    << "\t\t\t\t" << R"(baseline[oc][oh][ow] = 0;)" << endl
-    << "\t\t\t" << "}" << endl
-    << "\t\t" << "}" << endl
-    << "\t" << "}" << endl
     << endl;
 }
 
@@ -254,14 +438,20 @@ void SimulationCodeGenerator::GenCalculateBaseline(ofstream& code)
   /* #region Logging */
   LOG(INFO) << "Generate baseline calculating code." << endl;
   /* #endregion */
+  if (parallel_compute_) {
+    code
+      << "\t" << R"(#pragma omp parallel for collapse(2))" << endl;
+  }
   code 
-    << "\t" << R"(for ( int oc = 0 ; oc < Oc ; oc++ ) {)" << endl
-    << "\t\t" << R"(for ( int ic = 0 ; ic < Ic ; ic++ ) {)" << endl
-    << "\t\t\t" << R"(for ( int oh = 0 ; oh < Oh ; oh++ ) {)" << endl
-    << "\t\t\t\t" << R"(for ( int ow = 0 ; ow < Ow ; ow++ ) {)" << endl
-    << "\t\t\t\t\t" << R"(for ( int kh = 0 ; kh < Kh ; kh++ ) {)" << endl
-    << "\t\t\t\t\t\t" << R"(for ( int kw = 0 ; kw < Kw ; kw++ ) {)" << endl
-    << "\t\t\t\t\t\t\t" << R"(baseline[oc][oh][ow] += input[ic][oh*S+kh][ow*S+kw] * weight[oc][ic][kh][kw];)" << endl
+    << "\t" << R"(for ( int n = 0 ; n < N ; n++ ) {)" << endl
+    << "\t\t" << R"(for ( int oc = 0 ; oc < Oc ; oc++ ) {)" << endl
+    << "\t\t\t" << R"(for ( int ic = 0 ; ic < Ic ; ic++ ) {)" << endl
+    << "\t\t\t\t" << R"(for ( int oh = 0 ; oh < Oh ; oh++ ) {)" << endl
+    << "\t\t\t\t\t" << R"(for ( int ow = 0 ; ow < Ow ; ow++ ) {)" << endl
+    << "\t\t\t\t\t\t" << R"(for ( int kh = 0 ; kh < Kh ; kh++ ) {)" << endl
+    << "\t\t\t\t\t\t\t" << R"(for ( int kw = 0 ; kw < Kw ; kw++ ) {)" << endl
+    << "\t\t\t\t\t\t\t\t" << R"(baseline[output_index(n, oc, oh, ow)] += input[input_index(n, oc/Goc*Ic+ic, oh*S+kh, ow*S+kw)] * weight[weight_index(oc, ic, kh, kw)];)" << endl
+    << "\t\t\t\t\t\t\t" << "}" << endl
     << "\t\t\t\t\t\t" << "}" << endl
     << "\t\t\t\t\t" << "}" << endl
     << "\t\t\t\t" << "}" << endl
@@ -271,6 +461,60 @@ void SimulationCodeGenerator::GenCalculateBaseline(ofstream& code)
     << endl;
 }
 
+void SimulationCodeGenerator::GenParallelCompute(ofstream& code,
+                                                const Structure& off_strt,
+                                                const Structure& on_strt)
+{
+  /* #region Logging */
+  LOG(INFO) << "Generate parallel computation code." << endl;
+  /* #endregion */
+  // Output channel tiles write disjoint outputs, so they run in parallel.
+  // The other tiles keep the off-chip loop order inside of them.
+  string indent = "\t";
+  vector<Type> loop_seq = GetLoopSequence(off_strt);
+
+  code
+    << indent << R"(#pragma omp parallel for schedule(dynamic))" << endl;
+  GenInterOcLoop(code, indent);
+  for ( int i = (int)Location::OUTER_MOST ; 
+      i >= Location::INNER_MOST ; i-- ) {
+    switch (loop_seq[i]) {
+      case Type::KERNEL_MAP:
+        indent += "\t";
+        GenInterKhLoop(code, indent);
+        indent += "\t";
+        GenInterKwLoop(code, indent);
+        break;
+      case Type::OUTPUT_MAP:
+        indent += "\t";
+        GenInterNLoop(code, indent);
+        indent += "\t";
+        GenInterOhLoop(code, indent);
+        indent += "\t";
+        GenInterOwLoop(code, indent);
+        break;
+      case Type::INPUT_CHANNEL:
+        indent += "\t";
+        GenInterIcLoop(code, indent);
+        break;
+      case Type::OUTPUT_CHANNEL:
+        break;
+      default:
+        /* #region Logging */
+        LOG(FATAL) << "Invalid loop type." << endl;
+        /* #endregion */
+    }
+  }
+  GenIntraLoop(code, on_strt);
+  GenUnrollLoop(code);
+  GenIntraLoopClose(code);
+  while (!indent.empty()) {
+    code << indent << R"(})" << endl;
+    indent = indent.substr(1, indent.length()-1);
+  }
+  code << endl;
+}
+
 void SimulationCodeGenerator::GenLocalVariables(ofstream& code, 
                                                 const Structure& off_strt)
 {
@@ -293,6 +537,7 @@ void SimulationCodeGenerator::GenLocalVariables(ofstream& code,
     /* #endregion */
     code
       << "\t" << R"(int last_oc = 0;)" << endl
+      << "\t" << R"(int last_n = 0;)" << endl
       << "\t" << R"(int last_oh = 0;)" << endl
       << "\t" << R"(int last_ow = 0;)" << endl
       << endl;
@@ -308,6 +553,7 @@ void SimulationCodeGenerator::GenLocalVariables(ofstream& code,
     LOG(INFO) << "Output store slot under Om." << endl;
     /* #endregion */
     code
+      << "\t" << R"(int last_n = 0;)" << endl
       << "\t" << R"(int last_oh = 0;)" << endl
       << "\t" << R"(int last_ow = 0;)" << endl
       << endl;
@@ -338,6 +584,20 @@ vector<Type> SimulationCodeGenerator::GetLoopSequence(const Structure& strt)
   };
 }
 
+int SimulationCodeGenerator::GetInputLoadGroups(const VariableSet& varset,
+                                                const Structure& off_strt)
+{
+  // An input load under the output channel loop reads the groups of one
+  // output channel tile, and otherwise the groups of every tile.
+  vector<Type> loop_seq = GetLoopSequence(off_strt);
+  InstructionSlot slot = GetInputLoadSlot(off_strt);
+  for (int loc = 0 ; loc < (int)slot ; loc++) {
+    if (loop_seq[loc] == Type::OUTPUT_CHANNEL) return varset.GetGroups();
+  }
+  return CalcGroupSpan(varset.GetToc(), varset.GetGroupOc(),
+                       varset.GetGroups());
+}
+
 InstructionSlot SimulationCodeGenerator::GetInputLoadSlot(const Structure& strt)
 {
   bool pass_input_channel = false;
@@ -551,6 +811,8 @@ void SimulationCodeGenerator::GenInterLoop( ofstream& code,
             (InstructionSlot)i);
         break;
       case Type::OUTPUT_MAP:
+        GenInterNLoop(code, indent);
+        indent += "\t";
         GenInterOhLoop(code, indent);
         indent += "\t";
         GenInterOwLoop(code, indent);
@@ -620,7 +882,7 @@ void SimulationCodeGenerator::GenInputLoadSlot( ofstream& code,
     LOG(INFO) << "Input load needs output map arguments." << endl;
     /* #endregion */
     code
-      << indent << "\t" << R"(memory_ts = input_load(oh, ow, memory_ts, prev_compute_ts, &ts_stream);)" << endl;
+      << indent << "\t" << R"(memory_ts = input_load(n, oh, ow, memory_ts, prev_compute_ts, &ts_stream);)" << endl;
   } else if ( off_strt.IsFullyTiled(Type::OUTPUT_MAP) && 
       off_strt.IsFullyTiled(Type::KERNEL_MAP) ) {
     /* #region Logging */
@@ -634,7 +896,7 @@ void SimulationCodeGenerator::GenInputLoadSlot( ofstream& code,
       << "Input load needs output map and kernel map arguments." << endl;
     /* #endregion */
     code
-      << indent << "\t" << R"(memory_ts = input_load(oh, ow, kh, kw, memory_ts, prev_compute_ts, &ts_stream);)" << endl;
+      << indent << "\t" << R"(memory_ts = input_load(n, oh, ow, kh, kw, memory_ts, prev_compute_ts, &ts_stream);)" << endl;
   } else if ( off_strt.IsFullyTiled(Type::OUTPUT_MAP) ) {
     /* #region Logging */
     LOG(INFO) 
@@ -648,13 +910,13 @@ void SimulationCodeGenerator::GenInputLoadSlot( ofstream& code,
       << "Input load needs input channel and output map arguments." << endl;
     /* #endregion */
     code
-      << indent << "\t" << R"(memory_ts = input_load(ic, oh, ow, memory_ts, prev_compute_ts, &ts_stream);)" << endl;
+      << indent << "\t" << R"(memory_ts = input_load(ic, n, oh, ow, memory_ts, prev_compute_ts, &ts_stream);)" << endl;
   } else {
     /* #region Logging */
     LOG(INFO) << "Input load needs all arguments." << endl;
     /* #endregion */
     code
-      << indent << "\t" << R"(memory_ts = input_load(ic, oh, ow, kh, kw, memory_ts, prev_compute_ts, &ts_stream);)" << endl;
+      << indent << "\t" << R"(memory_ts = input_load(ic, n, oh, ow, kh, kw, memory_ts, prev_compute_ts, &ts_stream);)" << endl;
   }
 }
 
@@ -827,6 +1089,15 @@ void SimulationCodeGenerator::GenInterIcLoop(ofstream& code, string indent)
     << indent << R"(for ( int ic = 0 ; ic < Ic ; ic += Tic ) {)" << endl;
 }
 
+void SimulationCodeGenerator::GenInterNLoop(ofstream& code, string indent)
+{
+  /* #region Logging */
+  LOG(INFO) << "Generate inter batch loop." << endl;
+  /* #endregion */
+  code
+    << indent << R"(for ( int n = 0 ; n < N ; n += Tn ) {)" << endl;
+}
+
 void SimulationCodeGenerator::GenInterOhLoop(ofstream& code, string indent)
 {
   /* #region Logging */
@@ -869,11 +1140,14 @@ void SimulationCodeGenerator::GenIntraLoop( ofstream& code,
   /* #region Logging */
   LOG(INFO) << "Generate intra loop." << endl;
   /* #endregion */
-  string indent = "\t\t\t\t\t\t\t";
+  string indent = "\t\t\t\t\t\t\t\t";
   vector<Type> loop_seq = GetLoopSequence(on_strt);
 
-  code
-    << indent << R"(int exe_cycles = 0;)" << endl;
+  // Parallel computation and PE arrays count cycles in closed form instead.
+  if (!parallel_compute_ && !IsArraySplit()) {
+    code
+      << indent << R"(int exe_cycles = 0;)" << endl;
+  }
 
   for ( int i = (int)Location::OUTER_MOST ; i >= Location::INNER_MOST ; i-- ) {
     switch ( loop_seq[i] ) {
@@ -883,6 +1157,8 @@ void SimulationCodeGenerator::GenIntraLoop( ofstream& code,
         GenIntraKwLoop(code, indent);
         break;
       case Type::OUTPUT_MAP:
+        GenIntraNLoop(code, indent);
+        indent += "\t";
         GenIntraOhLoop(code, indent);
         indent += "\t";
         GenIntraOwLoop(code, indent);
@@ -920,6 +1196,15 @@ void SimulationCodeGenerator::GenIntraIcLoop(ofstream& code, string indent)
     << indent << R"(for ( int tic = ic ; tic < min(ic+Tic, Ic) ; tic += Pic ) {)" << endl;
 }
 
+void SimulationCodeGenerator::GenIntraNLoop(ofstream& code, string indent)
+{
+  /* #region Logging */
+  LOG(INFO) << "Generate intra batch loop." << endl;
+  /* #endregion */
+  code
+    << indent << R"(for ( int tn = n ; tn < min(n+Tn, N) ; tn += Pn ) {)" << endl;
+}
+
 void SimulationCodeGenerator::GenIntraOhLoop(ofstream& code, string indent)
 {
   /* #region Logging */
@@ -962,15 +1247,25 @@ void SimulationCodeGenerator::GenIntraLoopClose(ofstream& code)
   LOG(INFO) << "Generate intra loop closing." << endl;
   /* #endregion */
   code
+    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(})" << endl
+    << "\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(})" << endl
     << "\t\t\t\t\t\t\t\t\t\t\t\t" << R"(})" << endl
     << "\t\t\t\t\t\t\t\t\t\t\t" << R"(})" << endl
     << "\t\t\t\t\t\t\t\t\t\t" << R"(})" << endl
     << "\t\t\t\t\t\t\t\t\t" << R"(})" << endl
-    << "\t\t\t\t\t\t\t\t" << R"(})" << endl
-    << "\t\t\t\t\t\t\t" << R"(})" << endl
-    << "\t\t\t\t\t\t\t" << R"(prev_compute_ts = compute_ts;)" << endl
-    << "\t\t\t\t\t\t\t" << R"(compute_ts = execute(exe_cycles, compute_ts, memory_ts, &ts_stream);)" << endl
-    << endl;
+    << "\t\t\t\t\t\t\t\t" << R"(})" << endl;
+  // Parallel computation only computes outputs here. Its tiles are timed
+  // by GenTileExecution.
+  if (IsArraySplit() && !parallel_compute_) {
+    code
+      << "\t\t\t\t\t\t\t\t" << R"(int exe_cycles = tile_cycles(n, oc, ic, oh, ow, kh, kw);)" << endl;
+  }
+  if (!parallel_compute_) {
+    code
+      << "\t\t\t\t\t\t\t\t" << R"(prev_compute_ts = compute_ts;)" << endl
+      << "\t\t\t\t\t\t\t\t" << R"(compute_ts = execute(exe_cycles, compute_ts, memory_ts, &ts_stream);)" << endl
+      << endl;
+  }
 }
 
 void SimulationCodeGenerator::GenUnrollLoop(ofstream& code)
@@ -979,21 +1274,56 @@ void SimulationCodeGenerator::GenUnrollLoop(ofstream& code)
   LOG(INFO) << "Generate unroll loop." << endl;
   /* #endregion */
   code
-    << "\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(for ( int poc = toc ; poc < min(toc+Poc, min(oc+Toc, Oc)) ; poc++ ) {)" << endl
-    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(for ( int pic = tic ; pic < min(tic+Pic, min(ic+Tic, Ic)) ; pic++ ) {)" << endl
-    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(for ( int poh = toh ; poh < min(toh+Poh, min(oh+Toh, Oh)) ; poh++ ) {)" << endl
-    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(for ( int pow = tow ; pow < min(tow+Pow, min(ow+Tow, Ow)) ; pow++ ) {)" << endl
-    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(for ( int pkh = tkh ; pkh < min(tkh+Pkh, min(kh+Tkh, Kh)) ; pkh++ ) {)" << endl
-    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(for ( int pkw = tkw ; pkw < min(tkw+Pkw, min(kw+Tkw, Kw)) ; pkw++ ) {)" << endl
-    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(output[poc][poh][pow] += input[pic][poh*S+pkh][pow*S+pkw] * weight[poc][pic][pkh][pkw];)" << endl
-    //<< "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(cout << "\r" << ++progress << " / " << Oc * Oh * Ow * Ic * Kh * Kw;)" << endl
+    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(for ( int pn = tn ; pn < min(tn+Pn, min(n+Tn, N)) ; pn++ ) {)" << endl
+    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(for ( int poc = toc ; poc < min(toc+Poc, min(oc+Toc, Oc)) ; poc++ ) {)" << endl
+    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(for ( int pic = tic ; pic < min(tic+Pic, min(ic+Tic, Ic)) ; pic++ ) {)" << endl
+    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(for ( int poh = toh ; poh < min(toh+Poh, min(oh+Toh, Oh)) ; poh++ ) {)" << endl
+    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(for ( int pow = tow ; pow < min(tow+Pow, min(ow+Tow, Ow)) ; pow++ ) {)" << endl
+    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(for ( int pkh = tkh ; pkh < min(tkh+Pkh, min(kh+Tkh, Kh)) ; pkh++ ) {)" << endl
+    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(for ( int pkw = tkw ; pkw < min(tkw+Pkw, min(kw+Tkw, Kw)) ; pkw++ ) {)" << endl
+    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(output[output_index(pn, poc, poh, pow)] += input[input_index(pn, poc/Goc*Ic+pic, poh*S+pkh, pow*S+pkw)] * weight[weight_index(poc, pic, pkh, pkw)];)" << endl
+    //<< "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(cout << "\r" << ++progress << " / " << N * Oc * Oh * Ow * Ic * Kh * Kw;)" << endl
+    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(})" << endl
+    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(})" << endl
+    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(})" << endl
     << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(})" << endl
     << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(})" << endl
     << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(})" << endl
-    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(})" << endl
-    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(})" << endl
-    << "\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(})" << endl
-    << "\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(exe_cycles += MacCycles;)" << endl
+    << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(})" << endl;
+  if (!parallel_compute_ && !IsArraySplit()) {
+    code
+      << "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" << R"(exe_cycles += MacCycles;)" << endl
+      << endl;
+  }
+}
+
+void SimulationCodeGenerator::GenTileExecution(ofstream& code)
+{
+  /* #region Logging */
+  LOG(INFO) << "Generate closed form tile execution." << endl;
+  /* #endregion */
+  // The intra loops step each dimension independently, so a tile takes
+  // MacCycles for every combination of their trip counts.
+  string indent = "\t\t\t\t\t\t\t\t";
+  if (IsArraySplit()) {
+    code
+      << indent << R"(int exe_cycles = tile_cycles(n, oc, ic, oh, ow, kh, kw);)" << endl
+      << indent << R"(prev_compute_ts = compute_ts;)" << endl
+      << indent << R"(compute_ts = execute(exe_cycles, compute_ts, memory_ts, &ts_stream);)" << endl
+      << endl;
+    return;
+  }
+  code
+    << indent << R"(int exe_cycles = MacCycles)" << endl
+    << indent << "\t" << R"(* ((min(n+Tn, N) - n + Pn-1) / Pn))" << endl
+    << indent << "\t" << R"(* ((min(oc+Toc, Oc) - oc + Poc-1) / Poc))" << endl
+    << indent << "\t" << R"(* ((min(ic+Tic, Ic) - ic + Pic-1) / Pic))" << endl
+    << indent << "\t" << R"(* ((min(oh+Toh, Oh) - oh + Poh-1) / Poh))" << endl
+    << indent << "\t" << R"(* ((min(ow+Tow, Ow) - ow + Pow-1) / Pow))" << endl
+    << indent << "\t" << R"(* ((min(kh+Tkh, Kh) - kh + Pkh-1) / Pkh))" << endl
+    << indent << "\t" << R"(* ((min(kw+Tkw, Kw) - kw + Pkw-1) / Pkw);)" << endl
+    << indent << R"(prev_compute_ts = compute_ts;)" << endl
+    << indent << R"(compute_ts = execute(exe_cycles, compute_ts, memory_ts, &ts_stream);)" << endl
     << endl;
 }
 
@@ -1003,7 +1333,7 @@ void SimulationCodeGenerator::GenInterLoopClose(ofstream& code,
   /* #region Logging */
   LOG(INFO) << "Generate inter loop closing." << endl;
   /* #endregion */
-  string indent = "\t\t\t\t\t\t\t";
+  string indent = "\t\t\t\t\t\t\t\t";
   vector<Type> loop_seq = GetLoopSequence(off_strt);
 
   for (int i = (int)Location::INNER_MOST ; 
@@ -1026,6 +1356,8 @@ void SimulationCodeGenerator::GenInterLoopClose(ofstream& code,
         code << indent << R"(})" << endl;
         indent = indent.substr(1, indent.length()-1);
         code << indent << R"(})" << endl;
+        indent = indent.substr(1, indent.length()-1);
+        code << indent << R"(})" << endl;
         break;
       case Type::INPUT_CHANNEL:
         if (GetOutputStoreSlot(off_strt) == (InstructionSlot)i) {
@@ -1053,7 +1385,7 @@ void SimulationCodeGenerator::GenInterLoopClose(ofstream& code,
     LOG(INFO) << "Output store needs all arguments." << endl;
     /* #endregion */
     code
-      << indent << R"(memory_ts = output_store(last_oc, last_oh, last_ow, memory_ts, compute_ts, &ts_stream);)" << endl;
+      << indent << R"(memory_ts = output_store(last_oc, last_n, last_oh, last_ow, memory_ts, compute_ts, &ts_stream);)" << endl;
   } else if (IsOutputStoreSlotUnderOc(loop_seq)) {
     /* #region Logging */
     LOG(INFO) << "Output store needs output channel argument." << endl;
@@ -1065,7 +1397,7 @@ void SimulationCodeGenerator::GenInterLoopClose(ofstream& code,
     LOG(INFO) << "Output store needs output map arguments." << endl;
     /* #endregion */
     code
-      << indent << R"(memory_ts = output_store(last_oh, last_ow, memory_ts, compute_ts, &ts_stream);)" << endl;
+      << indent << R"(memory_ts = output_store(last_n, last_oh, last_ow, memory_ts, compute_ts, &ts_stream);)" << endl;
   } else if (IsOutputStoreSlotOverOcAndOm(loop_seq)) {
     /* #region Logging */
     LOG(INFO) << "Output store needs no argument." << endl;
@@ -1095,10 +1427,11 @@ void SimulationCodeGenerator::GenOutputStoreSlot( ofstream& code,
     LOG(INFO) << "Output store needs all arguments." << endl;
     /* #endregion */
     code
-      << indent << "\t" << R"(memory_ts = output_store(last_oc, last_oh, last_ow, memory_ts, prev_compute_ts, &ts_stream);)" << endl
+      << indent << "\t" << R"(memory_ts = output_store(last_oc, last_n, last_oh, last_ow, memory_ts, prev_compute_ts, &ts_stream);)" << endl
       << indent << "\t" << R"(store_flag = false;)" << endl
       << indent << R"(})" << endl
       << indent << R"(last_oc = oc;)" << endl
+      << indent << R"(last_n = n;)" << endl
       << indent << R"(last_oh = oh;)" << endl
       << indent << R"(last_ow = ow;)" << endl;
   } else if (IsOutputStoreSlotUnderOc(loop_seq)) {
@@ -1115,9 +1448,10 @@ void SimulationCodeGenerator::GenOutputStoreSlot( ofstream& code,
     LOG(INFO) << "OUtput store needs output map arguments." << endl;
     /* #endregion */
     code
-      << indent << "\t" << R"(memory_ts = output_store(last_oh, last_ow, memory_ts, prev_compute_ts, &ts_stream);)" << endl
+      << indent << "\t" << R"(memory_ts = output_store(last_n, last_oh, last_ow, memory_ts, prev_compute_ts, &ts_stream);)" << endl
       << indent << "\t" << R"(store_flag = false;)" << endl
       << indent << R"(})" << endl
+      << indent << R"(last_n = n;)" << endl
       << indent << R"(last_oh = oh;)" << endl
       << indent << R"(last_ow = ow;)" << endl;
   } else if (IsOutputStoreSlotOverOcAndOm(loop_seq)) {
@@ -1153,10 +1487,12 @@ void SimulationCodeGenerator::GenResultCheck(ofstream& code)
   LOG(INFO) << "Generate result check." << endl;
   /* #endregion */
   code
-    << "\t" << R"(for ( int oc = 0 ; oc < Oc ; oc++ ) {)" << endl
-    << "\t\t" << R"(for ( int oh = 0 ; oh < Oh ; oh++ ) {)" << endl
-    << "\t\t\t" << R"(for ( int ow = 0 ; ow < Ow ; ow++ ) {)" << endl
-    << "\t\t\t\t" << R"(assert(baseline[oc][oh][ow] == output[oc][oh][ow]);)" << endl
+    << "\t" << R"(for ( int n = 0 ; n < N ; n++ ) {)" << endl
+    << "\t\t" << R"(for ( int oc = 0 ; oc < Oc ; oc++ ) {)" << endl
+    << "\t\t\t" << R"(for ( int oh = 0 ; oh < Oh ; oh++ ) {)" << endl
+    << "\t\t\t\t" << R"(for ( int ow = 0 ; ow < Ow ; ow++ ) {)" << endl
+    << "\t\t\t\t\t" << R"(assert(baseline[output_index(n, oc, oh, ow)] == output[output_index(n, oc, oh, ow)]);)" << endl
+    << "\t\t\t\t" << R"(})" << endl
     << "\t\t\t" << R"(})" << endl
     << "\t\t" << R"(})" << endl
     << "\t" << R"(})" << endl
@@ -1168,8 +1504,12 @@ void SimulationCodeGenerator::GenLatencyValueWrite(ofstream& code)
   /* #region Logging */
   LOG(INFO) << "Generate latency value write." << endl;
   /* #endregion */
-  code  << "\t" << R"(ofstream latency_file(")" <<latency_file_path_ << R"(");)"
-        << endl << "\t" << R"(latency_file << memory_ts << endl;)"
+  if (IsRuntimeArgs()) {
+    code  << "\t" << R"(ofstream latency_file(argv[2]);)";
+  } else {
+    code  << "\t" << R"(ofstream latency_file(")" <<latency_file_path_ << R"(");)";
+  }
+  code  << endl << "\t" << R"(latency_file << memory_ts << endl;)"
         << endl << "\t" << R"(latency_file.close();)"
         << endl << endl;
 }
@@ -1189,7 +1529,7 @@ void SimulationCodeGenerator::GenInputLoadFunctionDefine(ofstream& code,
     code
       << R"(long int input_load(long int memory_ts, long int prev_compute_ts, ofstream* ts_stream))" << endl
       << R"({)" << endl
-      << "\t" << R"(int load_size = Tic * Tih * Tiw * sizeof(DataType);)" << endl;
+      << "\t" << R"(int load_size = Tn * Tic * Tih * Tiw * sizeof(DataType);)" << endl;
   } else if (off_strt.IsFullyTiled(Type::INPUT_CHANNEL) && 
       off_strt.IsFullyTiled(Type::OUTPUT_MAP)) {
     /* #region Logging */
@@ -1200,9 +1540,9 @@ void SimulationCodeGenerator::GenInputLoadFunctionDefine(ofstream& code,
       << R"({)" << endl
       << "\t" << R"(int load_size = 0;)" << endl
       << "\t" << R"(if (kw == 0) {)" << endl
-      << "\t\t" << R"(load_size = Tic * ((Toh-1)*S + min(Tkh, Kh-kh)) * ((Tow-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl
+      << "\t\t" << R"(load_size = Tn * Tic * ((Toh-1)*S + min(Tkh, Kh-kh)) * ((Tow-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl
       << "\t" << R"(} else {)" << endl
-      << "\t\t" << R"(load_size = Tic * ((Toh-1)*S + min(Tkh, Kh-kh)) * min(Tkw, Kw-kw) * sizeof(DataType);)" << endl
+      << "\t\t" << R"(load_size = Tn * Tic * ((Toh-1)*S + min(Tkh, Kh-kh)) * min(Tkw, Kw-kw) * sizeof(DataType);)" << endl
       << "\t" << R"(})" << endl;
   } else if (off_strt.IsFullyTiled(Type::INPUT_CHANNEL) && 
       off_strt.IsFullyTiled(Type::KERNEL_MAP)) {
@@ -1210,13 +1550,13 @@ void SimulationCodeGenerator::GenInputLoadFunctionDefine(ofstream& code,
     LOG(INFO) << "Input load needs output map arguments." << endl;
     /* #endregion */
     code
-      << R"(long int input_load(int oh, int ow, long int memory_ts, long int prev_compute_ts, ofstream* ts_stream))" << endl
+      << R"(long int input_load(int n, int oh, int ow, long int memory_ts, long int prev_compute_ts, ofstream* ts_stream))" << endl
       << R"({)" << endl
       << "\t" << R"(int load_size = 0;)" << endl
       << "\t" << R"(if (ow == 0) {)" << endl
-      << "\t\t" << R"(load_size = Tic * ((min(Toh, Oh-oh)-1)*S + Tkh) * ((min(Tow, Ow-ow)-1)*S + Tkw) * sizeof(DataType);)" << endl
+      << "\t\t" << R"(load_size = min(Tn, N-n) * Tic * ((min(Toh, Oh-oh)-1)*S + Tkh) * ((min(Tow, Ow-ow)-1)*S + Tkw) * sizeof(DataType);)" << endl
       << "\t" << R"(} else {)" << endl
-      << "\t\t" << R"(load_size = Tic * (min(Toh, Oh-oh)*S) * ((min(Tow, Ow-ow)-1)*S + Tkw) * sizeof(DataType);)" << endl
+      << "\t\t" << R"(load_size = min(Tn, N-n) * Tic * (min(Toh, Oh-oh)*S) * ((min(Tow, Ow-ow)-1)*S + Tkw) * sizeof(DataType);)" << endl
       << "\t" << R"(})" << endl;
   } else if (off_strt.IsFullyTiled(Type::OUTPUT_MAP) && 
       off_strt.IsFullyTiled(Type::KERNEL_MAP)) {
@@ -1226,29 +1566,29 @@ void SimulationCodeGenerator::GenInputLoadFunctionDefine(ofstream& code,
     code
       << R"(long int input_load(int ic, long int memory_ts, long int prev_compute_ts, ofstream* ts_stream))" << endl
       << R"({)" << endl
-      << "\t" << R"(int load_size = min(Tic, Ic-ic) * ((Toh-1)*S + Tkh) * ((Tow-1)*S + Tkw) * sizeof(DataType);)" << endl;
+      << "\t" << R"(int load_size = Tn * min(Tic, Ic-ic) * ((Toh-1)*S + Tkh) * ((Tow-1)*S + Tkw) * sizeof(DataType);)" << endl;
   } else if (off_strt.IsFullyTiled(Type::INPUT_CHANNEL)) {
     /* #region Logging */
     LOG(INFO) << "Input load needs output map arguments." << endl;
     /* #endregion */
     code
-      << R"(long int input_load(int oh, int ow, int kh, int kw, long int memory_ts, long int prev_compute_ts, ofstream* ts_stream))" << endl
+      << R"(long int input_load(int n, int oh, int ow, int kh, int kw, long int memory_ts, long int prev_compute_ts, ofstream* ts_stream))" << endl
       << R"({)" << endl
       << "\t" << R"(int load_size = 0;)" << endl
       << "\t" << R"(if (ow == 0 && kw == 0) {)" << endl
-      << "\t\t" << R"(load_size = Tic * ((min(Toh, Oh-oh)-1)*S + min(Tkh, Kh-kh)) * ((min(Tow, Ow-ow)-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl
+      << "\t\t" << R"(load_size = min(Tn, N-n) * Tic * ((min(Toh, Oh-oh)-1)*S + min(Tkh, Kh-kh)) * ((min(Tow, Ow-ow)-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl
       << "\t" << R"(} else if (ow == 0) {)" << endl
-      << "\t\t" << R"(load_size = Tic * ((min(Toh, Oh-oh)-1)*S + min(Tkh, Kh-kh)) * min(Tkw, Kw-kw) * sizeof(DataType);)" << endl
+      << "\t\t" << R"(load_size = min(Tn, N-n) * Tic * ((min(Toh, Oh-oh)-1)*S + min(Tkh, Kh-kh)) * min(Tkw, Kw-kw) * sizeof(DataType);)" << endl
       << "\t" << R"(} else if (kw == 0) {)" << endl
-      << "\t\t" << R"(load_size = Tic * (min(Toh, Oh-oh)*S) * ((min(Tow, Ow-ow)-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl
+      << "\t\t" << R"(load_size = min(Tn, N-n) * Tic * (min(Toh, Oh-oh)*S) * ((min(Tow, Ow-ow)-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl
       << "\t" << R"(} else {)" << endl;
     if (off_strt.GetKernelMap() < 
         off_strt.GetOutputMap()) {
       code
-        << "\t\t" << R"(load_size = Tic * min(Tkh, Kh-kh) * ((min(Tow, Ow-ow)-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl;
+        << "\t\t" << R"(load_size = min(Tn, N-n) * Tic * min(Tkh, Kh-kh) * ((min(Tow, Ow-ow)-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl;
     } else {
       code
-        << "\t\t" << R"(load_size = Tic * (min(Toh, Oh-oh)*S) * ((min(Tow, Ow-ow)-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl;
+        << "\t\t" << R"(load_size = min(Tn, N-n) * Tic * (min(Toh, Oh-oh)*S) * ((min(Tow, Ow-ow)-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl;
     }
     code
       << "\t" << R"(})" << endl;
@@ -1262,9 +1602,9 @@ void SimulationCodeGenerator::GenInputLoadFunctionDefine(ofstream& code,
       << R"({)" << endl
       << "\t" << R"(int load_size = 0;)" << endl
       << "\t" << R"(if (kw == 0) {)" << endl
-      << "\t\t" << R"(load_size = min(Tic, Ic-ic) * ((Toh-1)*S + min(Tkh, Kh-kh)) * ((Tow-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl
+      << "\t\t" << R"(load_size = Tn * min(Tic, Ic-ic) * ((Toh-1)*S + min(Tkh, Kh-kh)) * ((Tow-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl
       << "\t" << R"(} else {)" << endl
-      << "\t\t" << R"(load_size = min(Tic, Ic-ic) * ((Toh-1)*S + min(Tkh, Kh-kh)) * min(Tkw, Kw-kw) * sizeof(DataType);)" << endl
+      << "\t\t" << R"(load_size = Tn * min(Tic, Ic-ic) * ((Toh-1)*S + min(Tkh, Kh-kh)) * min(Tkw, Kw-kw) * sizeof(DataType);)" << endl
       << "\t" << R"(})" << endl;
   } else if (off_strt.IsFullyTiled(Type::KERNEL_MAP)) {
     /* #region Logging */
@@ -1272,42 +1612,43 @@ void SimulationCodeGenerator::GenInputLoadFunctionDefine(ofstream& code,
       << "Input load needs input channel and output map arguments." << endl;
     /* #endregion */
     code
-      << R"(long int input_load(int ic, int oh, int ow, long int memory_ts, long int prev_compute_ts, ofstream* ts_stream))" << endl
+      << R"(long int input_load(int ic, int n, int oh, int ow, long int memory_ts, long int prev_compute_ts, ofstream* ts_stream))" << endl
       << R"({)" << endl
       << "\t" << R"(int load_size = 0;)" << endl
       << "\t" << R"(if (ow == 0) {)" << endl
-      << "\t\t" << R"(load_size = min(Tic, Ic-ic) * ((min(Toh, Oh-oh)-1)*S + Tkh) * ((min(Tow, Ow-ow)-1)*S + Tkw) * sizeof(DataType);)" << endl
+      << "\t\t" << R"(load_size = min(Tn, N-n) * min(Tic, Ic-ic) * ((min(Toh, Oh-oh)-1)*S + Tkh) * ((min(Tow, Ow-ow)-1)*S + Tkw) * sizeof(DataType);)" << endl
       << "\t" << R"(} else {)" << endl
-      << "\t\t" << R"(load_size = min(Tic, Ic-ic) * (min(Toh, Oh-oh)*S) * ((min(Tow, Ow-ow)-1)*S + Tkw) * sizeof(DataType);)" << endl
+      << "\t\t" << R"(load_size = min(Tn, N-n) * min(Tic, Ic-ic) * (min(Toh, Oh-oh)*S) * ((min(Tow, Ow-ow)-1)*S + Tkw) * sizeof(DataType);)" << endl
       << "\t" << R"(})" << endl;
   } else {
     /* #region Logging */
     LOG(INFO) << "Input load needs all arguments." << endl;
     /* #endregion */
     code
-      << R"(long int input_load(int ic, int oh, int ow, int kh, int kw, long int memory_ts, long int prev_compute_ts, ofstream* ts_stream))" << endl
+      << R"(long int input_load(int ic, int n, int oh, int ow, int kh, int kw, long int memory_ts, long int prev_compute_ts, ofstream* ts_stream))" << endl
       << R"({)" << endl
       << "\t" << R"(int load_size = 0;)" << endl
       << "\t" << R"(if (ow == 0 && kw == 0) {)" << endl
-      << "\t\t" << R"(load_size = min(Tic, Ic-ic) * ((min(Toh, Oh-oh)-1)*S + min(Tkh, Kh-kh)) * ((min(Tow, Ow-ow)-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl
+      << "\t\t" << R"(load_size = min(Tn, N-n) * min(Tic, Ic-ic) * ((min(Toh, Oh-oh)-1)*S + min(Tkh, Kh-kh)) * ((min(Tow, Ow-ow)-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl
       << "\t" << R"(} else if (ow == 0) {)" << endl
-      << "\t\t" << R"(load_size = min(Tic, Ic-ic) * ((min(Toh, Oh-oh)-1)*S + min(Tkh, Kh-kh)) * min(Tkw, Kw-kw) * sizeof(DataType);)" << endl
+      << "\t\t" << R"(load_size = min(Tn, N-n) * min(Tic, Ic-ic) * ((min(Toh, Oh-oh)-1)*S + min(Tkh, Kh-kh)) * min(Tkw, Kw-kw) * sizeof(DataType);)" << endl
       << "\t" << R"(} else if (kw == 0) {)" << endl
-      << "\t\t" << R"(load_size = min(Tic, Ic-ic) * (min(Toh, Oh-oh)*S) * ((min(Tow, Ow-ow)-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl
+      << "\t\t" << R"(load_size = min(Tn, N-n) * min(Tic, Ic-ic) * (min(Toh, Oh-oh)*S) * ((min(Tow, Ow-ow)-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl
       << "\t" << R"(} else {)" << endl;
     if (off_strt.GetKernelMap() < 
         off_strt.GetOutputMap()) {
       code
-        << "\t\t" << R"(load_size = Tic * min(Tkh, Kh-kh) * ((min(Tow, Ow-ow)-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl;
+        << "\t\t" << R"(load_size = min(Tn, N-n) * Tic * min(Tkh, Kh-kh) * ((min(Tow, Ow-ow)-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl;
     } else {
       code
-        << "\t\t" << R"(load_size = Tic * (min(Toh, Oh-oh)*S) * ((min(Tow, Ow-ow)-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl;
+        << "\t\t" << R"(load_size = min(Tn, N-n) * Tic * (min(Toh, Oh-oh)*S) * ((min(Tow, Ow-ow)-1)*S + min(Tkw, Kw-kw)) * sizeof(DataType);)" << endl;
     }
     code
       << "\t" << R"(})" << endl; 
   }
 
   code
+    << "\t" << R"(load_size *= Tg;)" << endl
     << "\t" << R"(long int next_ts = max(memory_ts, prev_compute_ts) + ceil((double)load_size / (double)BANDWIDTH);)" << endl
     << "\t" << R"(*ts_stream << "{\"type\":\"MEMORY\", \"datatype\":\"INPUT\", ")" << endl
     << "\t\t" << R"(<< "\"start\":" << max(memory_ts, prev_compute_ts) << ", ")" << endl
@@ -1425,9 +1766,9 @@ void SimulationCodeGenerator::GenOutputStoreFunctionDefine(ofstream& code,
     LOG(INFO) << "Output store needs all arguments." << endl;
     /* #endregion */
     code
-      << R"(long int output_store(int oc, int oh, int ow, long int memory_ts, long int prev_compute_ts, ofstream* ts_stream))" << endl
+      << R"(long int output_store(int oc, int n, int oh, int ow, long int memory_ts, long int prev_compute_ts, ofstream* ts_stream))" << endl
       << R"({)" <<  endl
-      << "\t" << R"(int store_size = min(Toc, Oc-oc) * min(Toh, Oh-oh) * min(Tow, Ow-ow) * sizeof(DataType);)" << endl;
+      << "\t" << R"(int store_size = min(Tn, N-n) * min(Toc, Oc-oc) * min(Toh, Oh-oh) * min(Tow, Ow-ow) * sizeof(DataType);)" << endl;
   } else if (IsOutputStoreSlotUnderOc(loop_seq)) {
     /* #region Logging */
     LOG(INFO) << "Output store needs output channel argument." << endl;
@@ -1435,15 +1776,15 @@ void SimulationCodeGenerator::GenOutputStoreFunctionDefine(ofstream& code,
     code
       << R"(long int output_store(int oc, long int memory_ts, long int prev_compute_ts, ofstream* ts_stream))" << endl
       << R"({)" << endl
-      << "\t" << R"(int store_size = min(Toc, Oc-oc) * Oh * Ow * sizeof(DataType);)" << endl;
+      << "\t" << R"(int store_size = N * min(Toc, Oc-oc) * Oh * Ow * sizeof(DataType);)" << endl;
   } else if (IsOutputStoreSlotUnderOm(loop_seq)) {
     /* #region Logging */
     LOG(INFO) << "Output store needs output map arguments." << endl;
     /* #endregion */
     code
-      << R"(long int output_store(int oh, int ow, long int memory_ts, long int prev_compute_ts, ofstream* ts_stream))" << endl
+      << R"(long int output_store(int n, int oh, int ow, long int memory_ts, long int prev_compute_ts, ofstream* ts_stream))" << endl
       << R"({)" << endl
-      << "\t" << R"(int store_size = Oc * min(Toh, Oh-oh) * min(Tow, Ow-ow) * sizeof(DataType);)" << endl;
+      << "\t" << R"(int store_size = min(Tn, N-n) * Oc * min(Toh, Oh-oh) * min(Tow, Ow-ow) * sizeof(DataType);)" << endl;
   } else if (IsOutputStoreSlotOverOcAndOm(loop_seq)) {
     /* #region Logging */
     LOG(INFO) << "Output store needs no argument." << endl;
@@ -1451,7 +1792,7 @@ void SimulationCodeGenerator::GenOutputStoreFunctionDefine(ofstream& code,
     code
       << R"(long int output_store(long int memory_ts, long int prev_compute_ts, ofstream* ts_stream))" << endl
       << R"({)" << endl
-      << "\t" << R"(int store_size = Oc * Oh * Ow * sizeof(DataType);)" << endl;
+      << "\t" << R"(int store_size = N * Oc * Oh * Ow * sizeof(DataType);)" << endl;
   } else {
     /* #region Logging */
     LOG(FATAL) << "Invalid output store slot location." << endl;
@@ -1478,7 +1819,7 @@ void SimulationCodeGenerator::GenExecuteFunctionDefine(ofstream& code)
   code
     << R"(long int execute(int exe_cycles, long int compute_ts, long int memory_ts, ofstream* ts_stream))" << endl
     << R"({)" << endl
-    << "\t" << R"(int num_ops = Tow * Toh * Tic * Tkw * Tkh * Toc;)" << endl
+    << "\t" << R"(int num_ops = Tn * Tow * Toh * Tic * Tkw * Tkh * Toc;)" << endl
     << "\t" << R"(long int next_ts = max(compute_ts, memory_ts) + ceil((double)exe_cycles / (double)FREQUENCY);)" << endl
     << "\t" << R"(*ts_stream << "{\"type\":\"EXECUTION\", ")" << endl
     << "\t\t" << R"(<< "\"start\":" << max(compute_ts, memory_ts) << ", ")" << endl
@@ -1490,39 +1831,68 @@ void SimulationCodeGenerator::GenExecuteFunctionDefine(ofstream& code)
     << endl;
 }
 
+void SimulationCodeGenerator::GenTileCyclesFunctionDefine(ofstream& code)
+{
+  /* #region Logging */
+  LOG(INFO) << "Generate tile cycles function definition." << endl;
+  /* #endregion */
+  // Each array takes the next Share output channels (rows) of the tile,
+  // so arrays at the end of a boundary tile get less or nothing. The tile
+  // takes as long as the slowest array.
+  const char* split = split_oc_ ? "len_oc" : "len_oh";
+  code
+    << R"(int tile_cycles(int n, int oc, int ic, int oh, int ow, int kh, int kw))" << endl
+    << R"({)" << endl
+    << "\t" << R"(int len_n  = min(n+Tn, N) - n;)" << endl
+    << "\t" << R"(int len_oc = min(oc+Toc, Oc) - oc;)" << endl
+    << "\t" << R"(int len_ic = min(ic+Tic, Ic) - ic;)" << endl
+    << "\t" << R"(int len_oh = min(oh+Toh, Oh) - oh;)" << endl
+    << "\t" << R"(int len_ow = min(ow+Tow, Ow) - ow;)" << endl
+    << "\t" << R"(int len_kh = min(kh+Tkh, Kh) - kh;)" << endl
+    << "\t" << R"(int len_kw = min(kw+Tkw, Kw) - kw;)" << endl
+    << "\t" << R"(int split_len = )" << split << ";" << endl
+    << "\t" << R"(int exe_cycles = 0;)" << endl;
+  for (size_t a = 0 ; a < pe_array_cnt_ ; a++) {
+    string id = std::to_string(a);
+    string share = "share" + id;
+    string oc_len = split_oc_ ? share : "len_oc";
+    string oh_len = split_oc_ ? "len_oh" : share;
+    code
+      << "\t" << "int " << share << " = min(Share" << id << ", split_len);" << endl
+      << "\t" << "split_len -= " << share << ";" << endl
+      << "\t" << "if (" << share << " > 0) {" << endl
+      << "\t\t" << "exe_cycles = max(exe_cycles, MacCycles" << endl
+      << "\t\t\t" << "* ((len_n + Pn" << id << "-1) / Pn" << id << ")" << endl
+      << "\t\t\t" << "* ((" << oc_len << " + Poc" << id << "-1) / Poc" << id << ")" << endl
+      << "\t\t\t" << "* ((len_ic + Pic" << id << "-1) / Pic" << id << ")" << endl
+      << "\t\t\t" << "* ((" << oh_len << " + Poh" << id << "-1) / Poh" << id << ")" << endl
+      << "\t\t\t" << "* ((len_ow + Pow" << id << "-1) / Pow" << id << ")" << endl
+      << "\t\t\t" << "* ((len_kh + Pkh" << id << "-1) / Pkh" << id << ")" << endl
+      << "\t\t\t" << "* ((len_kw + Pkw" << id << "-1) / Pkw" << id << "));" << endl
+      << "\t" << "}" << endl;
+  }
+  code
+    << "\t" << R"(return exe_cycles;)" << endl
+    << R"(})" << endl
+    << endl;
+}
+
+bool SimulationCodeGenerator::IsArraySplitOc(const VariableSet& varset)
+{
+  // Shares along output rows keep every output channel of the tile.
+  for (const Variables& share : varset.GetArrayLoopVariables())
+    if (share.GetOc() != varset.GetToc()) return true;
+  return varset.GetArrayLoopVariables().empty();
+}
+
 void SimulationCodeGenerator::GenDelete(ofstream& code)
 {
   /* #region Logging */
   LOG(INFO) << "Generate release allocation of dataset." << endl;
   /* #endregion */
   code
-    << "\t" << R"(for (int ic = 0 ; ic < Ic ; ic++) {)" << endl
-    << "\t\t" << R"(for (int ih = 0 ; ih < Ih ; ih++) {)" << endl
-    << "\t\t\t" << R"(delete [] input[ic][ih];)" << endl
-    << "\t\t" << R"(})" << endl
-    << "\t\t" << R"(delete [] input[ic];)" << endl
-    << "\t" << R"(})" << endl
-    << "\t" << R"(delete [] input;)" << endl
-    << endl
-    << "\t" << R"(for (int oc = 0 ; oc < Oc ; oc++) {)" << endl
-    << "\t\t" << R"(for (int ic = 0 ; ic < Ic ; ic++) {)" << endl
-    << "\t\t\t" << R"(for (int kh = 0 ; kh < Kh ; kh++) {)" << endl
-    << "\t\t\t\t" << R"(delete [] weight[oc][ic][kh];)" << endl
-    << "\t\t\t" << R"(})" << endl
-    << "\t\t\t" << R"(delete [] weight[oc][ic];)" << endl
-    << "\t\t" << R"(})" << endl
-    << "\t\t" << R"(delete [] weight[oc];)" << endl
-    << "\t" << R"(})" << endl
-    << "\t" << R"(delete [] weight;)" << endl
-    << endl
-    << "\t" << R"(for (int oc = 0 ; oc < Oc ; oc++) {)" << endl
-    << "\t\t" << R"(for (int oh = 0 ; oh < Oh ; oh++) {)" << endl
-    << "\t\t\t" << R"(delete [] output[oc][oh];)" << endl
-    << "\t\t\t" << R"(delete [] baseline[oc][oh];)" << endl
-    << "\t\t" << R"(})" << endl
-    << "\t\t" << R"(delete [] output[oc];)" << endl
-    << "\t\t" << R"(delete [] baseline[oc];)" << endl
-    << "\t" << R"(})" << endl
-    << "\t" << R"(delete [] output;)" << endl
-    << "\t" << R"(delete [] baseline;)" << endl;
-}
\ No newline at end of file
+    << "\t" << R"(free(input);)" << endl
+    << "\t" << R"(free(weight);)" << endl
+    << "\t" << R"(free(output);)" << endl
+    << "\t" << R"(free(baseline);)" << endl;
+}
@@ -0,0 +1,306 @@
+#include "codegen/timing_simulator.h"
+
+#include <glog/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "general/data_type.h"
+#include "general/utils.h"
+
+using codegen::simulation::TimingSimulator;
+using codegen::simulation::InstructionSlot;
+using loop::Location;
+
+using std::endl;
+using std::min;
+using std::max;
+using std::ceil;
+using std::ostringstream;
+using std::istringstream;
+
+TimingSimulator::TimingSimulator(const CnnLoop& loop, const Architecture& arch)
+  : off_strt_(loop.GetOffStructure())
+{
+  const VariableSet& varset = loop.GetVariableSet();
+  for (int d = 0 ; d < kDimensionCnt ; d++) {
+    dim_[d] = tile_[d] = parl_[d] = 1;
+    idx_[d] = last_idx_[d] = 0;
+  }
+  dim_[DataDimension::KW] = varset.GetKw();   tile_[DataDimension::KW] = varset.GetTkw();
+  dim_[DataDimension::KH] = varset.GetKh();   tile_[DataDimension::KH] = varset.GetTkh();
+  dim_[DataDimension::IC] = varset.GetIc();   tile_[DataDimension::IC] = varset.GetTic();
+  dim_[DataDimension::OW] = varset.GetOw();   tile_[DataDimension::OW] = varset.GetTow();
+  dim_[DataDimension::OH] = varset.GetOh();   tile_[DataDimension::OH] = varset.GetToh();
+  dim_[DataDimension::OC] = varset.GetOc();   tile_[DataDimension::OC] = varset.GetToc();
+  dim_[DataDimension::N]  = varset.GetN();    tile_[DataDimension::N]  = varset.GetTn();
+  dim_[DataDimension::IW] = varset.GetIw() + 2*varset.GetPw();
+  dim_[DataDimension::IH] = varset.GetIh() + 2*varset.GetPh();
+  tile_[DataDimension::IW] = varset.GetTiw() + 2*varset.GetPw();
+  tile_[DataDimension::IH] = varset.GetTih() + 2*varset.GetPh();
+  parl_[DataDimension::KW] = varset.GetPkw();
+  parl_[DataDimension::KH] = varset.GetPkh();
+  parl_[DataDimension::IC] = varset.GetPic();
+  parl_[DataDimension::OW] = varset.GetPow();
+  parl_[DataDimension::OH] = varset.GetPoh();
+  parl_[DataDimension::OC] = varset.GetPoc();
+  parl_[DataDimension::N]  = varset.GetPn();
+  split_dim_ = SimulationCodeGenerator::IsArraySplitOc(varset) ?
+               DataDimension::OC : DataDimension::OH;
+  const vector<Variables>& array_vars = varset.GetArrayLoopVariables();
+  const vector<Variables>& array_parl_vars = varset.GetArrayParlLoopVariables();
+  for (size_t a = 0 ; a < array_vars.size() ; a++) {
+    const Variables& parl = array_parl_vars[a];
+    vector<int> array_parl(kDimensionCnt, 1);
+    array_parl[DataDimension::KW] = parl.GetKw();
+    array_parl[DataDimension::KH] = parl.GetKh();
+    array_parl[DataDimension::IC] = parl.GetIc();
+    array_parl[DataDimension::OW] = parl.GetOw();
+    array_parl[DataDimension::OH] = parl.GetOh();
+    array_parl[DataDimension::OC] = parl.GetOc();
+    array_parl[DataDimension::N]  = parl.GetN();
+    array_share_.push_back((split_dim_ == DataDimension::OC) ?
+                           array_vars[a].GetOc() : array_vars[a].GetOh());
+    array_parl_.push_back(array_parl);
+  }
+  stride_ = varset.GetStride();
+  load_groups_ = SimulationCodeGenerator::GetInputLoadGroups(varset, off_strt_);
+  mac_cycles_ = arch.GetMacCycles();
+  // Generated code takes the rates as they are printed in its #define.
+  ostringstream rates;
+  rates << arch.GetBandwidth() << " " << arch.GetFrequency();
+  istringstream(rates.str()) >> bandwidth_ >> frequency_;
+
+  input_slot_  = SimulationCodeGenerator::GetInputLoadSlot(off_strt_);
+  weight_slot_ = SimulationCodeGenerator::GetWeightLoadSlot(off_strt_);
+  store_slot_  = SimulationCodeGenerator::GetOutputStoreSlot(off_strt_);
+
+  vector<Type> loop_seq = SimulationCodeGenerator::GetLoopSequence(off_strt_);
+  if (SimulationCodeGenerator::IsOutputStoreSlotUnderOcAndOm(loop_seq)) {
+    is_store_oc_ = true;
+    is_store_om_ = true;
+  } else if (SimulationCodeGenerator::IsOutputStoreSlotUnderOc(loop_seq)) {
+    is_store_oc_ = true;
+    is_store_om_ = false;
+  } else if (SimulationCodeGenerator::IsOutputStoreSlotUnderOm(loop_seq)) {
+    is_store_oc_ = false;
+    is_store_om_ = true;
+  } else {
+    is_store_oc_ = false;
+    is_store_om_ = false;
+  }
+
+  // The innermost loop of each type holds the instruction slot of it.
+  for (int i = (int)Location::OUTER_MOST ; i >= Location::INNER_MOST ; i--) {
+    switch (loop_seq[i]) {
+      case Type::KERNEL_MAP:
+        levels_.push_back({DataDimension::KH, -1});
+        levels_.push_back({DataDimension::KW, i});
+        break;
+      case Type::OUTPUT_MAP:
+        levels_.push_back({DataDimension::N, -1});
+        levels_.push_back({DataDimension::OH, -1});
+        levels_.push_back({DataDimension::OW, i});
+        break;
+      case Type::INPUT_CHANNEL:
+        levels_.push_back({DataDimension::IC, i});
+        break;
+      case Type::OUTPUT_CHANNEL:
+        levels_.push_back({DataDimension::OC, i});
+        break;
+      default:
+        LOG(FATAL) << "Invalid loop type." << endl;
+    }
+  }
+  /* #region Logging */
+  LOG(INFO) << "Build timing simulator.";
+  LOG(INFO) << "  Input load slot: " << input_slot_;
+  LOG(INFO) << "  Weight load slot: " << weight_slot_;
+  LOG(INFO) << "  Output store slot: " << store_slot_;
+  LOG(INFO) << "  Input load groups: " << load_groups_;
+  /* #endregion */
+}
+
+long int TimingSimulator::Run(ostream* ts_stream)
+{
+  ts_stream_ = ts_stream;
+  memory_ts_ = 0;
+  prev_compute_ts_ = 0;
+  compute_ts_ = 0;
+  store_flag_ = false;
+  is_not_first_iter_ = false;
+  for (int d = 0 ; d < kDimensionCnt ; d++) idx_[d] = last_idx_[d] = 0;
+
+  if (ts_stream_) *ts_stream_ << "[" << endl;
+  RunInstructionSlot(InstructionSlot::OVER_OUTER_MOST);
+  RunLevel(0);
+  // The last output tile is stored after the last execution.
+  OutputStore(compute_ts_);
+  if (ts_stream_) *ts_stream_ << "{\"type\":\"END\"}" << endl << "]";
+  /* #region Logging */
+  LOG(INFO) << "Timing simulation latency: " << memory_ts_ << " ns";
+  /* #endregion */
+  return memory_ts_;
+}
+
+void TimingSimulator::RunLevel(size_t l)
+{
+  if (l == levels_.size()) {
+    is_not_first_iter_ = true;
+    Execute();
+    return;
+  }
+  const Level& level = levels_[l];
+  const DataDimension d = level.dim;
+  for (idx_[d] = 0 ; idx_[d] < dim_[d] ; idx_[d] += tile_[d]) {
+    if (level.slot >= 0) RunInstructionSlot(level.slot);
+    RunLevel(l+1);
+    if (level.slot >= 0 && level.slot == store_slot_) RunOutputStoreSlot();
+  }
+  idx_[d] = 0;
+}
+
+void TimingSimulator::RunInstructionSlot(int slot)
+{
+  if (slot == input_slot_)  InputLoad();
+  if (slot == weight_slot_) WeightLoad();
+  if (slot == store_slot_ && is_not_first_iter_) store_flag_ = true;
+}
+
+void TimingSimulator::RunOutputStoreSlot(void)
+{
+  if (store_flag_) {
+    OutputStore(prev_compute_ts_);
+    store_flag_ = false;
+  }
+  last_idx_[DataDimension::OC] = idx_[DataDimension::OC];
+  last_idx_[DataDimension::N]  = idx_[DataDimension::N];
+  last_idx_[DataDimension::OH] = idx_[DataDimension::OH];
+  last_idx_[DataDimension::OW] = idx_[DataDimension::OW];
+}
+
+void TimingSimulator::InputLoad(void)
+{
+  const bool is_ic_full = off_strt_.IsFullyTiled(Type::INPUT_CHANNEL);
+  const bool is_om_full = off_strt_.IsFullyTiled(Type::OUTPUT_MAP);
+  const bool is_km_full = off_strt_.IsFullyTiled(Type::KERNEL_MAP);
+  // Fully tiled loops take whole tiles like the generated input_load.
+  const long int n  = is_om_full ? tile_[DataDimension::N]  : GetTileLen(DataDimension::N, idx_);
+  const long int oh = is_om_full ? tile_[DataDimension::OH] : GetTileLen(DataDimension::OH, idx_);
+  const long int ow = is_om_full ? tile_[DataDimension::OW] : GetTileLen(DataDimension::OW, idx_);
+  const long int ic = is_ic_full ? tile_[DataDimension::IC] : GetTileLen(DataDimension::IC, idx_);
+  const long int kh = is_km_full ? tile_[DataDimension::KH] : GetTileLen(DataDimension::KH, idx_);
+  const long int kw = is_km_full ? tile_[DataDimension::KW] : GetTileLen(DataDimension::KW, idx_);
+  const int s = stride_;
+
+  long int load_size = 0;
+  if (is_ic_full && is_om_full && is_km_full) {
+    load_size = tile_[DataDimension::N] * tile_[DataDimension::IC] * tile_[DataDimension::IH] * tile_[DataDimension::IW];
+  } else if (idx_[DataDimension::OW] == 0 && idx_[DataDimension::KW] == 0) {
+    load_size = n * ic * ((oh-1)*s + kh) * ((ow-1)*s + kw);
+  } else if (idx_[DataDimension::OW] == 0) {
+    load_size = n * ic * ((oh-1)*s + kh) * kw;
+  } else if (idx_[DataDimension::KW] == 0) {
+    load_size = n * ic * (oh*s) * ((ow-1)*s + kw);
+  } else if (off_strt_.GetKernelMap() < off_strt_.GetOutputMap()) {
+    load_size = n * tile_[DataDimension::IC] * kh * ((ow-1)*s + kw);
+  } else {
+    load_size = n * tile_[DataDimension::IC] * (oh*s) * ((ow-1)*s + kw);
+  }
+  load_size *= sizeof(DataType) * load_groups_;
+
+  long int start_ts = max(memory_ts_, prev_compute_ts_);
+  long int next_ts = start_ts + ceil((double)load_size / bandwidth_);
+  WriteMemoryEvent("INPUT", start_ts, next_ts, load_size);
+  memory_ts_ = next_ts;
+}
+
+void TimingSimulator::WeightLoad(void)
+{
+  long int load_size = sizeof(DataType);
+  const DataDimension dims[] = {DataDimension::OC, DataDimension::IC, DataDimension::KH, DataDimension::KW};
+  const Type types[] = {Type::OUTPUT_CHANNEL, Type::INPUT_CHANNEL,
+                        Type::KERNEL_MAP, Type::KERNEL_MAP};
+  for (int i = 0 ; i < 4 ; i++) {
+    load_size *= off_strt_.IsFullyTiled(types[i]) ?
+      tile_[dims[i]] : GetTileLen(dims[i], idx_);
+  }
+  long int start_ts = max(memory_ts_, prev_compute_ts_);
+  long int next_ts = start_ts + ceil((double)load_size / bandwidth_);
+  WriteMemoryEvent("WEIGHT", start_ts, next_ts, load_size);
+  memory_ts_ = next_ts;
+}
+
+void TimingSimulator::OutputStore(long int prev_compute_ts)
+{
+  long int store_size = sizeof(DataType);
+  store_size *= is_store_oc_ ? GetTileLen(DataDimension::OC, last_idx_) : dim_[DataDimension::OC];
+  store_size *= is_store_om_ ? GetTileLen(DataDimension::N, last_idx_) : dim_[DataDimension::N];
+  store_size *= is_store_om_ ? GetTileLen(DataDimension::OH, last_idx_) : dim_[DataDimension::OH];
+  store_size *= is_store_om_ ? GetTileLen(DataDimension::OW, last_idx_) : dim_[DataDimension::OW];
+
+  long int start_ts = max(memory_ts_, prev_compute_ts);
+  long int next_ts = start_ts + ceil((double)store_size / bandwidth_);
+  WriteMemoryEvent("OUTPUT", start_ts, next_ts, store_size);
+  memory_ts_ = next_ts;
+}
+
+void TimingSimulator::Execute(void)
+{
+  // A tile takes MAC cycles for every step of the intra loops.
+  long int exe_cycles = mac_cycles_;
+  long int num_ops = 1;
+  for (DataDimension d : {DataDimension::N, DataDimension::OC, DataDimension::IC, DataDimension::OH, DataDimension::OW, DataDimension::KH, DataDimension::KW}) {
+    exe_cycles *= CeilDiv(GetTileLen(d, idx_), parl_[d]);
+    num_ops *= tile_[d];
+  }
+  if (!array_share_.empty()) exe_cycles = GetArraysExeCycles();
+  long int start_ts = max(compute_ts_, memory_ts_);
+  long int next_ts = start_ts + ceil((double)exe_cycles / frequency_);
+  if (ts_stream_) {
+    *ts_stream_ << "{\"type\":\"EXECUTION\", "
+                << "\"start\":" << start_ts << ", "
+                << "\"end\":" << next_ts << ", "
+                << "\"amount\":" << num_ops
+                << "}," << '\n';
+  }
+  prev_compute_ts_ = compute_ts_;
+  compute_ts_ = next_ts;
+}
+
+long int TimingSimulator::GetArraysExeCycles(void) const
+{
+  // Same split as tile_cycles() of the generated code. Each array takes the
+  // next share of the tile, and the slowest array decides.
+  int split_len = GetTileLen(split_dim_, idx_);
+  long int exe_cycles = 0;
+  for (size_t a = 0 ; a < array_share_.size() ; a++) {
+    int share = min(array_share_[a], split_len);
+    split_len -= share;
+    if (share == 0) continue;
+    long int array_cycles = mac_cycles_;
+    for (DataDimension d : {DataDimension::N, DataDimension::OC, DataDimension::IC, DataDimension::OH, DataDimension::OW, DataDimension::KH, DataDimension::KW}) {
+      int len = (d == split_dim_) ? share : GetTileLen(d, idx_);
+      array_cycles *= CeilDiv(len, array_parl_[a][d]);
+    }
+    exe_cycles = max(exe_cycles, array_cycles);
+  }
+  return exe_cycles;
+}
+
+int TimingSimulator::GetTileLen(DataDimension d, const int* idx) const
+{
+  return min(tile_[d], dim_[d] - idx[d]);
+}
+
+void TimingSimulator::WriteMemoryEvent( const char* data_type,
+                                        long int start, long int end,
+                                        long int amount)
+{
+  if (!ts_stream_) return;
+  *ts_stream_ << "{\"type\":\"MEMORY\", \"datatype\":\"" << data_type << "\", "
+              << "\"start\":" << start << ", "
+              << "\"end\":" << end << ", "
+              << "\"amount\":" << amount
+              << "}," << '\n';
+}
@@ -22,6 +22,7 @@ CsvObject::CsvObject( const char* layer_name,
   tow_ = varset.GetTow();
   toh_ = varset.GetToh();
   toc_ = varset.GetToc();
+  tn_  = varset.GetTn();
 
   s_input_reuse_ = report.GetSpatialInputReuse();
   s_weight_reuse_= report.GetSpatialWeightReuse();
@@ -53,6 +54,7 @@ CsvObject::CsvObject( const char* layer_name,
   performance_            = report.GetPerformance();
   active_macs_            = report.GetActiveMacs();
   pe_util_                = report.GetPeUtilization();
+  array_pe_util_          = report.GetArrayPeUtilization();
 
   off_chip_acs_energy_= report.GetOffChipAccessEnergy();
   on_chip_acs_energy_ = report.GetOnChipAccessEnergy();
@@ -77,6 +79,7 @@ CsvObject::CsvObject( const char* layer_name,
   LOG(INFO) << "  tile output width: "  << tow_;
   LOG(INFO) << "  tile output height: " << toh_;
   LOG(INFO) << "  tile output channel: "<< toc_;
+  LOG(INFO) << "  tile batch: "<< tn_;
 
   LOG(INFO) << "  spatial input reuse: "   << s_input_reuse_;
   LOG(INFO) << "  spatial weight reuse: "  << s_weight_reuse_;
@@ -139,6 +142,7 @@ ostream& statistic::operator<<(ostream& out, const CsvObject& csv_obj)
       << csv_obj.tow_ << ","
       << csv_obj.toh_ << ","
       << csv_obj.toc_ << ","
+      << csv_obj.tn_ << ","
       << csv_obj.s_input_reuse_ << ","
       << csv_obj.s_weight_reuse_<< ","
       << csv_obj.t_input_reuse_ << ","
@@ -164,7 +168,13 @@ ostream& statistic::operator<<(ostream& out, const CsvObject& csv_obj)
       << csv_obj.estimated_performance_ << ","
       << csv_obj.performance_ << ","
       << csv_obj.active_macs_ << ","
-      << csv_obj.pe_util_     << ","
+      << csv_obj.pe_util_     << ",";
+  // PE utilization of each array is one cell like "a/b/c".
+  for (size_t a = 0 ; a < csv_obj.array_pe_util_.size() ; a++) {
+    if (a > 0) out << "/";
+    out << csv_obj.array_pe_util_[a];
+  }
+  out << ","
       << csv_obj.off_chip_acs_energy_<< ","
       << csv_obj.on_chip_acs_energy_ << ","
       << csv_obj.exe_energy_  << ","
@@ -81,7 +81,7 @@ int CsvWriter::WriteCsv(const char* csv_file, const CsvObject& csv_obj)
 void CsvWriter::WriteCsvFrame(ofstream* csv_file_stream)
 {
   *csv_file_stream << "layer_name,"
-    << "TIW,TIH,TIC,TKW,TKH,TOW,TOH,TOC,"
+    << "TIW,TIH,TIC,TKW,TKH,TOW,TOH,TOC,TN,"
     << "spatial_input_reuse,"
     << "spatial_weight_reuse,"
     << "temporal_input_reuse,"
@@ -108,6 +108,7 @@ void CsvWriter::WriteCsvFrame(ofstream* csv_file_stream)
     << "performance,"
     << "active_macs,"
     << "PE_util,"
+    << "array_PE_util,"
     << "off_chip_access_energy,"
     << "on_chip_access_energy,"
     << "exe_energy,"
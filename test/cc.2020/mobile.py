@@ -19,80 +19,80 @@ hw_spec = hw.HardwareSpec(simd_cfg_path)
 data_1 = torch.randn(1, 3, 224, 224)
 conv_1 = nn.Conv2d(3, 32, 3, padding=1)
 
-data_2 = torch.randn(1, 1, 112, 112)
-conv_2 = nn.Conv2d(1, 1, 3, padding=1)
+data_2 = torch.randn(1, 32, 112, 112)
+conv_2 = nn.Conv2d(32, 32, 3, padding=1, groups=32)
 
 data_3 = torch.randn(1, 32, 112, 112)
 conv_3 = nn.Conv2d(32, 64, 1, padding=0)
 
-data_4 = torch.randn(1, 1, 112, 112)
-conv_4 = nn.Conv2d(1, 1, 3, padding=1)
+data_4 = torch.randn(1, 64, 112, 112)
+conv_4 = nn.Conv2d(64, 64, 3, padding=1, groups=64)
 
 data_5 = torch.randn(1, 64, 56, 56)
 conv_5 = nn.Conv2d(64, 128, 1, padding=0)
 
-data_6 = torch.randn(1, 1, 56, 56)
-conv_6 = nn.Conv2d(1, 1, 3, padding=1)
+data_6 = torch.randn(1, 128, 56, 56)
+conv_6 = nn.Conv2d(128, 128, 3, padding=1, groups=128)
 
 data_7 = torch.randn(1, 128, 56, 56)
 conv_7 = nn.Conv2d(128, 128, 1, padding=0)
 
-data_8 = torch.randn(1, 1, 56, 56)
-conv_8 = nn.Conv2d(1, 1, 3, padding=1)
+data_8 = torch.randn(1, 128, 56, 56)
+conv_8 = nn.Conv2d(128, 128, 3, padding=1, groups=128)
 
 data_9 = torch.randn(1, 128, 28, 28)
 conv_9 = nn.Conv2d(128, 256, 1, padding=0)
 
-data_10 = torch.randn(1, 1, 28, 28)
-conv_10 = nn.Conv2d(1, 1, 3, padding=1)
+data_10 = torch.randn(1, 256, 28, 28)
+conv_10 = nn.Conv2d(256, 256, 3, padding=1, groups=256)
 
 data_11 = torch.randn(1, 256, 28, 28)
 conv_11 = nn.Conv2d(256, 256, 1, padding=0)
 
-data_12 = torch.randn(1, 1, 28, 28)
-conv_12 = nn.Conv2d(1, 1, 3, padding=1)
+data_12 = torch.randn(1, 256, 28, 28)
+conv_12 = nn.Conv2d(256, 256, 3, padding=1, groups=256)
 
 data_13 = torch.randn(1, 256, 14, 14)
 conv_13 = nn.Conv2d(256, 512, 1, padding=0)
 
-data_14 = torch.randn(1, 1, 14, 14)
-conv_14 = nn.Conv2d(1, 1, 3, padding=1)
+data_14 = torch.randn(1, 512, 14, 14)
+conv_14 = nn.Conv2d(512, 512, 3, padding=1, groups=512)
 
 data_15 = torch.randn(1, 512, 14, 14)
 conv_15 = nn.Conv2d(512, 512, 1, padding=0)
 
-data_16 = torch.randn(1, 1, 14, 14)
-conv_16 = nn.Conv2d(1, 1, 3, padding=1)
+data_16 = torch.randn(1, 512, 14, 14)
+conv_16 = nn.Conv2d(512, 512, 3, padding=1, groups=512)
 
 data_17 = torch.randn(1, 512, 14, 14)
 conv_17 = nn.Conv2d(512, 512, 1, padding=0)
 
-data_18 = torch.randn(1, 1, 14, 14)
-conv_18 = nn.Conv2d(1, 1, 3, padding=1)
+data_18 = torch.randn(1, 512, 14, 14)
+conv_18 = nn.Conv2d(512, 512, 3, padding=1, groups=512)
 
 data_19 = torch.randn(1, 512, 14, 14)
 conv_19 = nn.Conv2d(512, 512, 1, padding=0)
 
-data_20 = torch.randn(1, 1, 14, 14)
-conv_20 = nn.Conv2d(1, 1, 3, padding=1)
+data_20 = torch.randn(1, 512, 14, 14)
+conv_20 = nn.Conv2d(512, 512, 3, padding=1, groups=512)
 
 data_21 = torch.randn(1, 512, 14, 14)
 conv_21 = nn.Conv2d(512, 512, 1, padding=0)
 
-data_22 = torch.randn(1, 1, 14, 14)
-conv_22 = nn.Conv2d(1, 1, 3, padding=1)
+data_22 = torch.randn(1, 512, 14, 14)
+conv_22 = nn.Conv2d(512, 512, 3, padding=1, groups=512)
 
 data_23 = torch.randn(1, 512, 14, 14)
 conv_23 = nn.Conv2d(512, 512, 1, padding=0)
 
-data_24 = torch.randn(1, 1, 14, 14)
-conv_24 = nn.Conv2d(1, 1, 3, padding=1)
+data_24 = torch.randn(1, 512, 14, 14)
+conv_24 = nn.Conv2d(512, 512, 3, padding=1, groups=512)
 
 data_25 = torch.randn(1, 512, 7, 7)
 conv_25 = nn.Conv2d(512, 1024, 1, padding=0)
 
-data_26 = torch.randn(1, 1, 7, 7)
-conv_26 = nn.Conv2d(1, 1, 3, padding=1)
+data_26 = torch.randn(1, 1024, 7, 7)
+conv_26 = nn.Conv2d(1024, 1024, 3, padding=1, groups=1024)
 
 data_27 = torch.randn(1, 1024, 7, 7)
 conv_27 = nn.Conv2d(1024, 1024, 1, padding=0)
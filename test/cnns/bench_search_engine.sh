@@ -0,0 +1,30 @@
+#!/bin/bash
+# Quality and compile time of the search engines against exhaustive search.
+# usage: bench_search_engine.sh [build dir] [extra compiler options...]
+# EVALS (default 16384) evaluations are given to anneal and genetic, so they
+# run on every layer whose tiling space is larger. EDP is read from the
+# compiler log and shown relative to the exhaustive one (1.000 is optimal).
+
+source $(dirname $0)/layers.sh $1
+shift
+evals=${EVALS:-16384}
+
+run() # layer search_mode : prints "seconds edp"
+{
+  local start=$(date +%s.%N)
+  local edp=$(compile $1 --search-mode=$2 --search-evals=$evals $extra)
+  local end=$(date +%s.%N)
+  awk -v s=$start -v e=$end -v edp=$edp 'BEGIN { print e-s, edp }'
+}
+
+extra="$@"
+printf "%-16s %10s %10s %7s %10s %7s\n" layer "exh (s)" "anneal (s)" edp \
+       "genetic(s)" edp
+for layer in "${layers[@]}"; do
+  read exh_t exh_edp <<< $(run "$layer" exhaustive)
+  read sa_t sa_edp <<< $(run "$layer" anneal)
+  read ga_t ga_edp <<< $(run "$layer" genetic)
+  printf "%-16s %10.3f %10.3f %7.3f %10.3f %7.3f\n" ${layer%% *} \
+    $exh_t $sa_t $(awk "BEGIN { print $sa_edp / $exh_edp }") \
+    $ga_t $(awk "BEGIN { print $ga_edp / $exh_edp }")
+done
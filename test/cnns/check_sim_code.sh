@@ -0,0 +1,44 @@
+#!/bin/bash
+# Build and run the generated simulation code of each simulation mode.
+# usage: check_sim_code.sh [build dir] [extra compiler options...]
+# The code is built with the flags of python/planner.py. Every mode must
+# build without warnings and simulate the same latency, so any failure or
+# mismatch is reported.
+
+source $(dirname $0)/layers.sh $1
+shift
+
+# Small layers on one PE array and on two, so the output channels of a
+# tile are split across the arrays.
+layers=("resnet18.l4     7  512  512  3 1 1  512,256,512  [[32,32]]"
+        "squeeze.fire9  13   64  256  3 1 1  512,256,512  [[32,32]]"
+        "resnet18.l4     7  512  512  3 1 1  512,256,512  [[16,16],[16,16]]"
+        "squeeze.fire9  13   64  256  3 1 1  512,256,512  [[16,16],[8,8]]")
+modes=("serial" "openmp --sim-openmp" "timing --timing-only")
+
+extra="$@"
+printf "%-16s %-18s %-8s %12s\n" layer pe_dim mode latency
+for layer in "${layers[@]}"; do
+  set -- $layer
+  first=""
+  for mode in "${modes[@]}"; do
+    set -- $mode
+    name=$1; shift
+    compile $layer "$@" $extra > /dev/null
+    flags="-std=c++11 -Ofast -Wall -Werror"
+    [ "$name" == "openmp" ] && flags="$flags -fopenmp"
+    rm -f $work/sim $work/lat.txt
+    if ! g++ $flags -o $work/sim $work/sim.cc 2> $work/cxx.txt ||
+       ! (cd $work && ./sim > /dev/null 2>&1); then
+      latency="failed"
+      head -5 $work/cxx.txt
+    else
+      latency=$(cat $work/lat.txt)
+    fi
+    set -- $layer
+    printf "%-16s %-18s %-8s %12s\n" $1 $9 $name $latency
+    [ -z "$first" ] && first=$latency
+    [ "$latency" != "failed" ] && [ "$latency" == "$first" ] ||
+      echo "Simulation differs: $1 $9 $name"
+  done
+done
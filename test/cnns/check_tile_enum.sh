@@ -0,0 +1,21 @@
+#!/bin/bash
+# EDP of class tile enumeration against full tile enumeration.
+# usage: check_tile_enum.sh [build dir] [extra compiler options...]
+# EDP is read from the compiler log. Class enumeration must find the same
+# EDP as the full one on every layer, so any mismatch is reported.
+
+source $(dirname $0)/layers.sh $1
+shift
+
+# PE-unrolled tiles differ in PE utilization inside a ceil quotient class.
+layers+=("vgg16.conv5_2  14  512  512  3 1 1  64,64,64     [[12,14]]")
+
+extra="$@"
+printf "%-16s %-10s %12s %12s\n" layer pe_dim full class
+for layer in "${layers[@]}"; do
+  full=$(compile $layer --tile-enum=full $extra)
+  class=$(compile $layer --tile-enum=class $extra)
+  set -- $layer
+  printf "%-16s %-10s %12s %12s\n" $1 $9 $full $class
+  [ "$full" == "$class" ] || echo "EDP differs: $1 $9"
+done
@@ -0,0 +1,37 @@
+#!/bin/bash
+# Layer table and compiler invocation shared by the scripts in this directory.
+# usage: source layers.sh [build dir]
+# Convolution layers of vgg16, resnet18, darknet19 and squeezenet1_1 in this
+# directory on the SIMD hardware of ../../hwcfg/simd.json.
+
+build=${1:-../../build}
+compiler=$(cd $build && pwd)/compiler
+work=$(mktemp -d)
+trap "rm -rf $work" EXIT
+
+#        name          iw   ic   oc   k s p  i/w/o buffer  pe_dim
+layers=("vgg16.conv1_2 224   64   64  3 1 1  512,256,512  [[32,32]]"
+        "vgg16.conv2_2 112  128  128  3 1 1  512,256,512  [[32,32]]"
+        "vgg16.conv3_2  56  256  256  3 1 1  512,256,512  [[32,32]]"
+        "vgg16.conv4_2  28  512  512  3 1 1  512,256,512  [[32,32]]"
+        "vgg16.conv5_2  14  512  512  3 1 1  512,256,512  [[32,32]]"
+        "resnet18.conv1 224   3   64  7 2 3  512,256,512  [[32,32]]"
+        "resnet18.l2    28  128  128  3 1 1  512,256,512  [[32,32]]"
+        "resnet18.l4     7  512  512  3 1 1  512,256,512  [[32,32]]"
+        "darknet19.c18  13  512 1024  3 1 1  512,256,512  [[32,32]]"
+        "squeeze.fire9  13   64  256  3 1 1  512,256,512  [[32,32]]")
+
+compile() # name iw ic oc k s p buffers pe_dim [options...] : prints edp
+{
+  rm -rf $work/log && mkdir $work/log
+  IFS=, read mem_i mem_w mem_o <<< $8
+  (cd $work && $compiler --iw=$2 --ih=$2 --ic=$3 --oc=$4 --kw=$5 --kh=$5 \
+    --stride=$6 --pw=$7 --ph=$7 --mac-cycles=1 --frequency=0.2 \
+    --bandwidth=1.6 --input-mem-size=$mem_i --weight-mem-size=$mem_w \
+    --output-mem-size=$mem_o --pe-dim=$9 --pe-structure=[[3,2,1],[6]] \
+    --code-path=sim.cc --gaia-path=l.gaia --latency-path=lat.txt \
+    --timestamp-path=ts.json --tiling-dump=tiling.txt \
+    --loop-seq-dump=seq.txt --layer=$1 "${@:10}" > out.txt 2>&1)
+  cat $work/log/* $work/out.txt 2>/dev/null |
+    grep "  EDP: " | tail -1 | awk '{ print $NF }'
+}